@@ -0,0 +1,44 @@
+BUILD_DIR := bin
+OBJ_DIR := obj
+
+ASSEMBLY := engine
+EXTENSION := .so
+COMPILER_FLAGS := -g -MD -Werror=vla -fdeclspec -fPIC
+INCLUDE_FLAGS := -Iengine/src -I$(VULKAN_SDK)/include
+LINKER_FLAGS := -g -shared -lvulkan -lm -L$(VULKAN_SDK)/lib -L$(OBJ_DIR)/engine
+DEFINES := -D_DEBUG -DKEXPORT
+
+rwildcard=$(wildcard $1$2) $(foreach d,$(wildcard $1*),$(call rwildcard,$d/,$2))
+
+SRC_FILES := $(call rwildcard,$(ASSEMBLY)/,*.c)
+DIRECTORIES := $(shell find $(ASSEMBLY) -type d)
+OBJ_FILES := $(SRC_FILES:%=$(OBJ_DIR)/%.o)
+
+all: scaffold compile link
+
+.PHONY: scaffold
+scaffold:
+	@echo Scaffolding folder structure...
+	@mkdir -p $(addprefix $(OBJ_DIR)/,$(DIRECTORIES))
+	@mkdir -p $(BUILD_DIR)
+	@echo Done.
+
+.PHONY: link
+link: scaffold $(OBJ_FILES)
+	@echo Linking $(ASSEMBLY)...
+	@clang $(OBJ_FILES) -o $(BUILD_DIR)/lib$(ASSEMBLY)$(EXTENSION) $(LINKER_FLAGS)
+
+.PHONY: compile
+compile:
+	@echo Compiling...
+
+.PHONY: clean
+clean:
+	rm -f $(BUILD_DIR)/lib$(ASSEMBLY)$(EXTENSION)
+	rm -rf $(OBJ_DIR)/$(ASSEMBLY)
+
+$(OBJ_DIR)/%.c.o: %.c # compile .c to .c.o object
+	@echo   $<...
+	@clang $< $(COMPILER_FLAGS) -c -o $@ $(DEFINES) $(INCLUDE_FLAGS)
+
+-include $(OBJ_FILES:.o=.d)
\ No newline at end of file
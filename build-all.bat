@@ -25,5 +25,9 @@ REM Tests
 make -f "Makefile.tests.windows.mak" all
 if %ERRORLEVEL% NEQ 0 (echo Error:%ERRORLEVEL% && exit)
 
+REM Log decoder
+make -f "Makefile.logdecoder.windows.mak" all
+if %ERRORLEVEL% NEQ 0 (echo Error:%ERRORLEVEL% && exit)
+
 ECHO "All assemblies built successfully!"
 @REM PAUSE
\ No newline at end of file
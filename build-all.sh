@@ -0,0 +1,40 @@
+#!/bin/bash
+# Build everything
+
+set echo on
+
+echo "Building everything..."
+
+# Engine
+make -f Makefile.engine.linux.mak all
+ERRORLEVEL=$?
+if [ $ERRORLEVEL -ne 0 ]
+then
+echo "Error:"$ERRORLEVEL && exit
+fi
+
+# Testbed
+make -f Makefile.testbed.linux.mak all
+ERRORLEVEL=$?
+if [ $ERRORLEVEL -ne 0 ]
+then
+echo "Error:"$ERRORLEVEL && exit
+fi
+
+# Tests
+make -f Makefile.tests.linux.mak all
+ERRORLEVEL=$?
+if [ $ERRORLEVEL -ne 0 ]
+then
+echo "Error:"$ERRORLEVEL && exit
+fi
+
+# Log decoder
+make -f Makefile.logdecoder.linux.mak all
+ERRORLEVEL=$?
+if [ $ERRORLEVEL -ne 0 ]
+then
+echo "Error:"$ERRORLEVEL && exit
+fi
+
+echo "All assemblies built successfully."
\ No newline at end of file
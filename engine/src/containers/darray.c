@@ -3,22 +3,36 @@
 #include "core/kmemory.h"
 #include "core/logger.h"
 
-void* _darray_create(UInt64 length, UInt64 stride) {
+// The header always sits immediately before the data. When the data needs a stricter
+// alignment than the header provides, the block is padded in front of the header.
+static UInt64 darray_header_offset(UInt64 alignment) {
     UInt64 header_size = DARRAY_FIELD_LENGTH * sizeof(UInt64);
+    return (header_size + alignment - 1) & ~(alignment - 1);
+}
+
+void* _darray_create(UInt64 length, UInt64 stride) {
+    return _darray_create_aligned(length, stride, 1);
+}
+
+void* _darray_create_aligned(UInt64 length, UInt64 stride, UInt16 alignment) {
+    UInt64 header_offset = darray_header_offset(alignment);
     UInt64 array_size = length * stride;
-    UInt64* new_array = kallocate(header_size + array_size, MEMORY_TAG_DARRAY);
-    kset_memory(new_array, 0, header_size + array_size);
+    UInt8* block = kallocate_aligned(header_offset + array_size, alignment, MEMORY_TAG_DARRAY);
+    kset_memory(block, 0, header_offset + array_size);
+    UInt64* new_array = (UInt64*)(block + header_offset) - DARRAY_FIELD_LENGTH;
     new_array[DARRAY_CAPACITY] = length;
     new_array[DARRAY_LENGTH] = 0;
     new_array[DARRAY_STRIDE] = stride;
+    new_array[DARRAY_ALIGNMENT] = alignment;
     return (void*)(new_array + DARRAY_FIELD_LENGTH);
 }
 
 void _darray_destroy(void* array) {
     UInt64* header = (UInt64*)array - DARRAY_FIELD_LENGTH;
-    UInt64 header_size = DARRAY_FIELD_LENGTH * sizeof(UInt64);
-    UInt64 total_size = header_size + header[DARRAY_CAPACITY] * header[DARRAY_STRIDE];
-    kfree(header, total_size, MEMORY_TAG_DARRAY);
+    UInt64 alignment = header[DARRAY_ALIGNMENT];
+    UInt64 header_offset = darray_header_offset(alignment);
+    UInt64 total_size = header_offset + header[DARRAY_CAPACITY] * header[DARRAY_STRIDE];
+    kfree_aligned((UInt8*)array - header_offset, total_size, alignment, MEMORY_TAG_DARRAY);
 }
 
 UInt64 _darray_field_get(void* array, UInt64 field) {
@@ -34,9 +48,10 @@ void _darray_field_set(void* array, UInt64 field, UInt64 value) {
 void* _darray_resize(void* array) {
     UInt64 length = darray_length(array);
     UInt64 stride = darray_stride(array);
-    void* temp = _darray_create(
+    void* temp = _darray_create_aligned(
         (DARRAY_RESIZE_FACTOR * darray_capacity(array)),
-        stride);
+        stride,
+        darray_alignment(array));
     kcopy_memory(temp, array, length * stride);
 
     _darray_field_set(temp, DARRAY_LENGTH, length);
@@ -78,11 +93,9 @@ void* _darray_pop_at(void* array, UInt64 index, void* dest) {
     UInt64 addr = (UInt64)array;
     kcopy_memory(dest, (void*)(addr + (index * stride)), stride);
 
-    if (index != length - 1) {
-        kcopy_memory(
-            (void*)(addr + (index * stride)),
-            (void*)(addr + ((index + 1) * stride)),
-            stride * (length - index));
+    // One element at a time, so no single copy has overlapping source and destination.
+    for (UInt64 i = index; i + 1 < length; ++i) {
+        kcopy_memory((void*)(addr + (i * stride)), (void*)(addr + ((i + 1) * stride)), stride);
     }
 
     _darray_field_set(array, DARRAY_LENGTH, length - 1);
@@ -102,11 +115,8 @@ void* _darray_insert_at(void* array, UInt64 index, void* value_ptr) {
 
     UInt64 addr = (UInt64)array;
 
-    if (index != length - 1) {
-        kcopy_memory(
-            (void*)(addr + ((index + 1) * stride)),
-            (void*)(addr + (index * stride)),
-            stride * (length - index));
+    for (UInt64 i = length; i > index; --i) {
+        kcopy_memory((void*)(addr + (i * stride)), (void*)(addr + ((i - 1) * stride)), stride);
     }
 
     kcopy_memory((void*)(addr + (index * stride)), value_ptr, stride);
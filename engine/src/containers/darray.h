@@ -6,10 +6,12 @@ enum {
     DARRAY_CAPACITY,
     DARRAY_LENGTH,
     DARRAY_STRIDE,
+    DARRAY_ALIGNMENT,
     DARRAY_FIELD_LENGTH
 };
 
 KAPI void* _darray_create(UInt64 length, UInt64 stride);
+KAPI void* _darray_create_aligned(UInt64 length, UInt64 stride, UInt16 alignment);
 KAPI void _darray_destroy(void* array);
 
 KAPI UInt64 _darray_field_get(void* array, UInt64 field);
@@ -32,6 +34,13 @@ KAPI void* _darray_insert_at(void* array, UInt64 index, void* value_ptr);
 #define darray_reserve(type, capacity) \
     _darray_create(capacity, sizeof(type))
 
+// The first element is aligned to alignment (a power of two). Growth keeps it.
+#define darray_create_aligned(type, alignment) \
+    _darray_create_aligned(DARRAY_DEFAULT_CAPACITY, sizeof(type), alignment)
+
+#define darray_reserve_aligned(type, capacity, alignment) \
+    _darray_create_aligned(capacity, sizeof(type), alignment)
+
 #define darray_destroy(array) _darray_destroy(array);
 
 #define darray_push(array, value)           \
@@ -64,5 +73,8 @@ KAPI void* _darray_insert_at(void* array, UInt64 index, void* value_ptr);
 #define darray_stride(array) \
     _darray_field_get(array, DARRAY_STRIDE)
 
+#define darray_alignment(array) \
+    _darray_field_get(array, DARRAY_ALIGNMENT)
+
 #define darray_length_set(array, value) \
     _darray_field_set(array, DARRAY_LENGTH, value)
\ No newline at end of file
@@ -0,0 +1,281 @@
+#include "hashtable.h"
+
+#include "core/kmemory.h"
+#include "core/kstring.h"
+#include "core/logger.h"
+
+// Growable tables double before more than 3/4 of their slots are in use; fixed tables
+// refuse inserts beyond that point, since long probe chains cost more than the memory.
+#define HASHTABLE_MAX_LOAD_NUMERATOR 3
+#define HASHTABLE_MAX_LOAD_DENOMINATOR 4
+#define HASHTABLE_MIN_CAPACITY 8
+
+// 64-bit FNV-1a.
+static UInt64 hash_key(const char* key, UInt64* out_length) {
+    UInt64 hash = 0xcbf29ce484222325ULL;
+    const UInt8* c = (const UInt8*)key;
+    for (; *c; ++c) {
+        hash ^= *c;
+        hash *= 0x100000001b3ULL;
+    }
+    *out_length = (UInt64)(c - (const UInt8*)key);
+    // 0 is reserved for empty slots.
+    return hash ? hash : 1;
+}
+
+static UInt32 capacity_for_count(UInt32 element_count) {
+    UInt64 needed = ((UInt64)element_count * HASHTABLE_MAX_LOAD_DENOMINATOR + HASHTABLE_MAX_LOAD_NUMERATOR - 1) / HASHTABLE_MAX_LOAD_NUMERATOR;
+    UInt64 capacity = HASHTABLE_MIN_CAPACITY;
+    while (capacity < needed) {
+        capacity <<= 1;
+    }
+    return (UInt32)capacity;
+}
+
+static UInt32 max_count_for_capacity(UInt32 capacity) {
+    return (UInt32)(((UInt64)capacity * HASHTABLE_MAX_LOAD_NUMERATOR) / HASHTABLE_MAX_LOAD_DENOMINATOR);
+}
+
+static UInt64 stored_size(UInt64 element_size, Boolean is_pointer_type) {
+    return is_pointer_type ? sizeof(void*) : element_size;
+}
+
+static UInt32 resolve_key_capacity(UInt32 key_capacity) {
+    return key_capacity ? key_capacity : HASHTABLE_DEFAULT_KEY_CAPACITY;
+}
+
+static UInt64 memory_requirement_for_capacity(UInt64 element_size, UInt32 key_capacity, UInt32 capacity) {
+    UInt64 value_stride = (element_size + 7) & ~7ULL;
+    return (UInt64)capacity * (sizeof(UInt64) + value_stride + key_capacity);
+}
+
+static void hashtable_bind_memory(hashtable* table, void* memory) {
+    UInt64 value_stride = (table->element_size + 7) & ~7ULL;
+    table->hashes = memory;
+    table->values = (UInt8*)memory + sizeof(UInt64) * table->capacity;
+    table->keys = (char*)table->values + value_stride * table->capacity;
+    kzero_memory(table->hashes, sizeof(UInt64) * table->capacity);
+}
+
+static void* value_at(const hashtable* table, UInt32 slot) {
+    return (UInt8*)table->values + ((table->element_size + 7) & ~7ULL) * slot;
+}
+
+static char* key_at(const hashtable* table, UInt32 slot) {
+    return table->keys + (UInt64)table->key_capacity * slot;
+}
+
+// Returns the slot holding key, or the empty slot where it would be inserted.
+static UInt32 find_slot(const hashtable* table, const char* key, UInt64 hash, Boolean* out_found) {
+    UInt32 mask = table->capacity - 1;
+    UInt32 slot = (UInt32)hash & mask;
+    for (;;) {
+        UInt64 slot_hash = table->hashes[slot];
+        if (slot_hash == 0) {
+            *out_found = FALSE;
+            return slot;
+        }
+        if (slot_hash == hash && strings_equal(key_at(table, slot), key)) {
+            *out_found = TRUE;
+            return slot;
+        }
+        slot = (slot + 1) & mask;
+    }
+}
+
+static Boolean hashtable_grow(hashtable* table) {
+    hashtable old = *table;
+    UInt32 new_capacity = table->capacity * 2;
+    void* memory = kallocate(memory_requirement_for_capacity(table->element_size, table->key_capacity, new_capacity), MEMORY_TAG_DICT);
+    if (!memory) {
+        return FALSE;
+    }
+
+    table->capacity = new_capacity;
+    hashtable_bind_memory(table, memory);
+
+    for (UInt32 i = 0; i < old.capacity; ++i) {
+        if (old.hashes[i] == 0) {
+            continue;
+        }
+
+        UInt32 slot = (UInt32)old.hashes[i] & (new_capacity - 1);
+        while (table->hashes[slot] != 0) {
+            slot = (slot + 1) & (new_capacity - 1);
+        }
+        table->hashes[slot] = old.hashes[i];
+        kcopy_memory(value_at(table, slot), value_at(&old, i), table->element_size);
+        kcopy_memory(key_at(table, slot), key_at(&old, i), table->key_capacity);
+    }
+
+    kfree(old.hashes, memory_requirement_for_capacity(old.element_size, old.key_capacity, old.capacity), MEMORY_TAG_DICT);
+    return TRUE;
+}
+
+static Boolean hashtable_insert(hashtable* table, const char* key, const void* value) {
+    if (!table || !table->hashes || !key) {
+        KERROR("hashtable_set - requires a valid table and key.");
+        return FALSE;
+    }
+
+    UInt64 length;
+    UInt64 hash = hash_key(key, &length);
+    if (length >= table->key_capacity) {
+        KERROR("hashtable_set - key '%s' is longer than %u characters.", key, table->key_capacity - 1);
+        return FALSE;
+    }
+
+    Boolean found;
+    UInt32 slot = find_slot(table, key, hash, &found);
+    if (!found) {
+        if (table->count + 1 > max_count_for_capacity(table->capacity)) {
+            if (!table->owns_memory) {
+                KERROR("hashtable_set - fixed table of %u slots is full.", table->capacity);
+                return FALSE;
+            }
+            if (!hashtable_grow(table)) {
+                return FALSE;
+            }
+            slot = find_slot(table, key, hash, &found);
+        }
+
+        table->hashes[slot] = hash;
+        kcopy_memory(key_at(table, slot), key, length + 1);
+        table->count++;
+    }
+
+    kcopy_memory(value_at(table, slot), value, table->element_size);
+    return TRUE;
+}
+
+static Boolean hashtable_lookup(const hashtable* table, const char* key, void* out_value) {
+    if (!table || !table->hashes || !key || table->count == 0) {
+        return FALSE;
+    }
+
+    UInt64 length;
+    UInt64 hash = hash_key(key, &length);
+    Boolean found;
+    UInt32 slot = find_slot(table, key, hash, &found);
+    if (found && out_value) {
+        kcopy_memory(out_value, value_at(table, slot), table->element_size);
+    }
+    return found;
+}
+
+UInt64 hashtable_memory_requirement(UInt64 element_size, UInt32 element_count, UInt32 key_capacity, Boolean is_pointer_type) {
+    return memory_requirement_for_capacity(stored_size(element_size, is_pointer_type), resolve_key_capacity(key_capacity), capacity_for_count(element_count));
+}
+
+Boolean hashtable_create(UInt64 element_size, UInt32 element_count, UInt32 key_capacity, void* memory, Boolean is_pointer_type, hashtable* out_table) {
+    if (!out_table) {
+        return FALSE;
+    }
+
+    element_size = stored_size(element_size, is_pointer_type);
+    if (element_size == 0 || element_count == 0) {
+        KERROR("hashtable_create - element size and element count must be non-zero.");
+        return FALSE;
+    }
+
+    out_table->element_size = element_size;
+    out_table->capacity = capacity_for_count(element_count);
+    out_table->count = 0;
+    out_table->key_capacity = resolve_key_capacity(key_capacity);
+    out_table->is_pointer_type = is_pointer_type;
+    out_table->owns_memory = memory == 0;
+
+    if (!memory) {
+        memory = kallocate(memory_requirement_for_capacity(element_size, out_table->key_capacity, out_table->capacity), MEMORY_TAG_DICT);
+        if (!memory) {
+            kzero_memory(out_table, sizeof(hashtable));
+            return FALSE;
+        }
+    }
+    hashtable_bind_memory(out_table, memory);
+    return TRUE;
+}
+
+void hashtable_destroy(hashtable* table) {
+    if (table) {
+        if (table->owns_memory && table->hashes) {
+            kfree(table->hashes, memory_requirement_for_capacity(table->element_size, table->key_capacity, table->capacity), MEMORY_TAG_DICT);
+        }
+        kzero_memory(table, sizeof(hashtable));
+    }
+}
+
+Boolean hashtable_set(hashtable* table, const char* key, const void* value) {
+    if (table && table->is_pointer_type) {
+        KERROR("hashtable_set - use hashtable_set_ptr for pointer tables.");
+        return FALSE;
+    }
+    return hashtable_insert(table, key, value);
+}
+
+Boolean hashtable_get(const hashtable* table, const char* key, void* out_value) {
+    if (table && table->is_pointer_type) {
+        KERROR("hashtable_get - use hashtable_get_ptr for pointer tables.");
+        return FALSE;
+    }
+    return hashtable_lookup(table, key, out_value);
+}
+
+Boolean hashtable_set_ptr(hashtable* table, const char* key, void* value) {
+    if (table && !table->is_pointer_type) {
+        KERROR("hashtable_set_ptr - use hashtable_set for value tables.");
+        return FALSE;
+    }
+    return hashtable_insert(table, key, &value);
+}
+
+Boolean hashtable_get_ptr(const hashtable* table, const char* key, void** out_value) {
+    if (table && !table->is_pointer_type) {
+        KERROR("hashtable_get_ptr - use hashtable_get for value tables.");
+        return FALSE;
+    }
+    return hashtable_lookup(table, key, out_value);
+}
+
+Boolean hashtable_remove(hashtable* table, const char* key) {
+    if (!table || !table->hashes || !key || table->count == 0) {
+        return FALSE;
+    }
+
+    UInt64 length;
+    UInt64 hash = hash_key(key, &length);
+    Boolean found;
+    UInt32 slot = find_slot(table, key, hash, &found);
+    if (!found) {
+        return FALSE;
+    }
+
+    // Backward-shift deletion: pull later entries of the probe chain into the hole so
+    // lookups never need tombstones.
+    UInt32 mask = table->capacity - 1;
+    UInt32 hole = slot;
+    UInt32 next = (hole + 1) & mask;
+    while (table->hashes[next] != 0) {
+        UInt32 home = (UInt32)table->hashes[next] & mask;
+        // Move the entry unless its home lies cyclically within (hole, next].
+        Boolean home_after_hole = hole <= next ? (home > hole && home <= next) : (home > hole || home <= next);
+        if (!home_after_hole) {
+            table->hashes[hole] = table->hashes[next];
+            kcopy_memory(value_at(table, hole), value_at(table, next), table->element_size);
+            kcopy_memory(key_at(table, hole), key_at(table, next), table->key_capacity);
+            hole = next;
+        }
+        next = (next + 1) & mask;
+    }
+
+    table->hashes[hole] = 0;
+    table->count--;
+    return TRUE;
+}
+
+void hashtable_clear(hashtable* table) {
+    if (table && table->hashes) {
+        kzero_memory(table->hashes, sizeof(UInt64) * table->capacity);
+        table->count = 0;
+    }
+}
\ No newline at end of file
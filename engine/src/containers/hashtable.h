@@ -0,0 +1,48 @@
+#pragma once
+
+#include "defines.h"
+
+// Keys are copied into fixed-size slots. This is the slot size, including the terminator,
+// used when a table is created with a key capacity of 0.
+#define HASHTABLE_DEFAULT_KEY_CAPACITY 64
+
+// Open-addressing table keyed by string, using linear probing over a compact array of
+// key hashes. Full key comparisons only happen when two hashes match.
+typedef struct hashtable {
+    UInt64 element_size;
+    // Number of slots; always a power of two.
+    UInt32 capacity;
+    UInt32 count;
+    // Bytes per key slot, including the terminator.
+    UInt32 key_capacity;
+    // Values are stored and returned as pointers rather than copied by value.
+    Boolean is_pointer_type;
+    // Set when the table allocated its own memory, which also lets it grow.
+    Boolean owns_memory;
+    // 0 marks an empty slot.
+    UInt64* hashes;
+    void* values;
+    char* keys;
+} hashtable;
+
+// Bytes of caller memory needed for a table that can hold element_count elements. Pass the
+// same arguments as to hashtable_create.
+KAPI UInt64 hashtable_memory_requirement(UInt64 element_size, UInt32 element_count, UInt32 key_capacity, Boolean is_pointer_type);
+
+// If memory is provided it must hold hashtable_memory_requirement() bytes and the table
+// never grows. Otherwise the table allocates its own memory and grows as needed.
+// element_size is ignored for pointer tables. Keys may be up to key_capacity - 1 characters;
+// 0 uses HASHTABLE_DEFAULT_KEY_CAPACITY. Asset paths want more, such as 256.
+KAPI Boolean hashtable_create(UInt64 element_size, UInt32 element_count, UInt32 key_capacity, void* memory, Boolean is_pointer_type, hashtable* out_table);
+KAPI void hashtable_destroy(hashtable* table);
+
+// Copies element_size bytes from value, replacing any existing value for key.
+KAPI Boolean hashtable_set(hashtable* table, const char* key, const void* value);
+// Copies the value for key into out_value, if out_value is provided.
+KAPI Boolean hashtable_get(const hashtable* table, const char* key, void* out_value);
+
+KAPI Boolean hashtable_set_ptr(hashtable* table, const char* key, void* value);
+KAPI Boolean hashtable_get_ptr(const hashtable* table, const char* key, void** out_value);
+
+KAPI Boolean hashtable_remove(hashtable* table, const char* key);
+KAPI void hashtable_clear(hashtable* table);
\ No newline at end of file
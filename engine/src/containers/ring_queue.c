@@ -0,0 +1,158 @@
+#include "ring_queue.h"
+
+#include "core/kmemory.h"
+#include "core/logger.h"
+
+STATIC_ASSERT(sizeof(ring_queue) == 192, "Expected ring_queue to span three cache lines.");
+
+// MPMC slots carry a sequence number that tells producers and consumers whose turn it is
+// (after Dmitry Vyukov's bounded MPMC queue).
+typedef struct ring_queue_cell {
+    _Atomic UInt64 sequence;
+} ring_queue_cell;
+
+static UInt64 ring_queue_stride(ring_queue_mode mode, UInt64 element_size) {
+    UInt64 size = element_size + (mode == RING_QUEUE_MODE_MPMC ? sizeof(ring_queue_cell) : 0);
+    return (size + 7) & ~7ULL;
+}
+
+static UInt8* slot_at(ring_queue* queue, UInt64 position) {
+    return queue->slots + queue->stride * (position & (queue->capacity - 1));
+}
+
+UInt64 ring_queue_memory_requirement(ring_queue_mode mode, UInt64 element_size, UInt32 capacity) {
+    return ring_queue_stride(mode, element_size) * capacity;
+}
+
+Boolean ring_queue_create(ring_queue_mode mode, UInt64 element_size, UInt32 capacity, void* memory, ring_queue* out_queue) {
+    if (!out_queue) {
+        return FALSE;
+    }
+
+    if (capacity == 0 || (capacity & (capacity - 1)) != 0) {
+        KERROR("ring_queue_create - capacity must be a power of two, got %u.", capacity);
+        return FALSE;
+    }
+
+    if (element_size == 0) {
+        KERROR("ring_queue_create - element size must be non-zero.");
+        return FALSE;
+    }
+
+    kzero_memory(out_queue, sizeof(ring_queue));
+    out_queue->mode = mode;
+    out_queue->capacity = capacity;
+    out_queue->element_size = element_size;
+    out_queue->stride = ring_queue_stride(mode, element_size);
+    out_queue->owns_memory = memory == 0;
+    out_queue->slots = memory ? memory : kallocate(out_queue->stride * capacity, MEMORY_TAG_RING_QUEUE);
+    atomic_init(&out_queue->head, 0);
+    atomic_init(&out_queue->tail, 0);
+
+    if (mode == RING_QUEUE_MODE_MPMC) {
+        for (UInt32 i = 0; i < capacity; ++i) {
+            atomic_init(&((ring_queue_cell*)slot_at(out_queue, i))->sequence, i);
+        }
+    }
+
+    return TRUE;
+}
+
+void ring_queue_destroy(ring_queue* queue) {
+    if (queue) {
+        if (queue->owns_memory && queue->slots) {
+            kfree(queue->slots, queue->stride * queue->capacity, MEMORY_TAG_RING_QUEUE);
+        }
+        kzero_memory(queue, sizeof(ring_queue));
+    }
+}
+
+static Boolean spsc_enqueue(ring_queue* queue, const void* value) {
+    UInt64 tail = atomic_load_explicit(&queue->tail, memory_order_relaxed);
+    if (tail - queue->cached_head == queue->capacity) {
+        queue->cached_head = atomic_load_explicit(&queue->head, memory_order_acquire);
+        if (tail - queue->cached_head == queue->capacity) {
+            return FALSE;
+        }
+    }
+
+    kcopy_memory(slot_at(queue, tail), value, queue->element_size);
+    atomic_store_explicit(&queue->tail, tail + 1, memory_order_release);
+    return TRUE;
+}
+
+static Boolean spsc_dequeue(ring_queue* queue, void* out_value) {
+    UInt64 head = atomic_load_explicit(&queue->head, memory_order_relaxed);
+    if (head == queue->cached_tail) {
+        queue->cached_tail = atomic_load_explicit(&queue->tail, memory_order_acquire);
+        if (head == queue->cached_tail) {
+            return FALSE;
+        }
+    }
+
+    kcopy_memory(out_value, slot_at(queue, head), queue->element_size);
+    atomic_store_explicit(&queue->head, head + 1, memory_order_release);
+    return TRUE;
+}
+
+static Boolean mpmc_enqueue(ring_queue* queue, const void* value) {
+    ring_queue_cell* cell;
+    UInt64 position = atomic_load_explicit(&queue->tail, memory_order_relaxed);
+    for (;;) {
+        cell = (ring_queue_cell*)slot_at(queue, position);
+        UInt64 sequence = atomic_load_explicit(&cell->sequence, memory_order_acquire);
+        Int64 difference = (Int64)(sequence - position);
+        if (difference == 0) {
+            if (atomic_compare_exchange_weak_explicit(&queue->tail, &position, position + 1, memory_order_relaxed, memory_order_relaxed)) {
+                break;
+            }
+        } else if (difference < 0) {
+            // The slot still holds an element from the previous lap.
+            return FALSE;
+        } else {
+            position = atomic_load_explicit(&queue->tail, memory_order_relaxed);
+        }
+    }
+
+    kcopy_memory(cell + 1, value, queue->element_size);
+    atomic_store_explicit(&cell->sequence, position + 1, memory_order_release);
+    return TRUE;
+}
+
+static Boolean mpmc_dequeue(ring_queue* queue, void* out_value) {
+    ring_queue_cell* cell;
+    UInt64 position = atomic_load_explicit(&queue->head, memory_order_relaxed);
+    for (;;) {
+        cell = (ring_queue_cell*)slot_at(queue, position);
+        UInt64 sequence = atomic_load_explicit(&cell->sequence, memory_order_acquire);
+        Int64 difference = (Int64)(sequence - (position + 1));
+        if (difference == 0) {
+            if (atomic_compare_exchange_weak_explicit(&queue->head, &position, position + 1, memory_order_relaxed, memory_order_relaxed)) {
+                break;
+            }
+        } else if (difference < 0) {
+            // Nothing has been written to this slot yet.
+            return FALSE;
+        } else {
+            position = atomic_load_explicit(&queue->head, memory_order_relaxed);
+        }
+    }
+
+    kcopy_memory(out_value, cell + 1, queue->element_size);
+    atomic_store_explicit(&cell->sequence, position + queue->capacity, memory_order_release);
+    return TRUE;
+}
+
+Boolean ring_queue_enqueue(ring_queue* queue, const void* value) {
+    return queue->mode == RING_QUEUE_MODE_SPSC ? spsc_enqueue(queue, value) : mpmc_enqueue(queue, value);
+}
+
+Boolean ring_queue_dequeue(ring_queue* queue, void* out_value) {
+    return queue->mode == RING_QUEUE_MODE_SPSC ? spsc_dequeue(queue, out_value) : mpmc_dequeue(queue, out_value);
+}
+
+UInt32 ring_queue_count(ring_queue* queue) {
+    UInt64 head = atomic_load_explicit(&queue->head, memory_order_acquire);
+    UInt64 tail = atomic_load_explicit(&queue->tail, memory_order_acquire);
+    return tail > head ? (UInt32)(tail - head) : 0;
+}
\ No newline at end of file
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "defines.h"
+
+#include <stdatomic.h>
+
+typedef enum ring_queue_mode {
+    // Exactly one producer thread and one consumer thread.
+    RING_QUEUE_MODE_SPSC,
+    // Any number of producer and consumer threads.
+    RING_QUEUE_MODE_MPMC
+} ring_queue_mode;
+
+// Bounded lock-free FIFO of fixed-size elements. Producer-owned and consumer-owned
+// indices live on separate cache lines so the two sides do not contend on writes.
+typedef struct ring_queue {
+    ring_queue_mode mode;
+    UInt32 capacity;
+    UInt64 element_size;
+    // Bytes per slot; includes the sequence number in MPMC mode.
+    UInt64 stride;
+    UInt8* slots;
+    Boolean owns_memory;
+    UInt8 config_padding[24];
+
+    // Producer side.
+    _Atomic UInt64 tail;
+    // SPSC only: last head the producer saw, so it only rereads head when it looks full.
+    UInt64 cached_head;
+    UInt8 tail_padding[48];
+
+    // Consumer side.
+    _Atomic UInt64 head;
+    // SPSC only: last tail the consumer saw, so it only rereads tail when it looks empty.
+    UInt64 cached_tail;
+    UInt8 head_padding[48];
+} ring_queue;
+
+// Bytes of caller memory needed for a queue of capacity elements.
+KAPI UInt64 ring_queue_memory_requirement(ring_queue_mode mode, UInt64 element_size, UInt32 capacity);
+
+// capacity must be a power of two. If memory is provided it must hold
+// ring_queue_memory_requirement() bytes; otherwise it is allocated with MEMORY_TAG_RING_QUEUE.
+KAPI Boolean ring_queue_create(ring_queue_mode mode, UInt64 element_size, UInt32 capacity, void* memory, ring_queue* out_queue);
+KAPI void ring_queue_destroy(ring_queue* queue);
+
+// Returns FALSE without blocking when the queue is full.
+KAPI Boolean ring_queue_enqueue(ring_queue* queue, const void* value);
+// Returns FALSE without blocking when the queue is empty.
+KAPI Boolean ring_queue_dequeue(ring_queue* queue, void* out_value);
+
+// Only a snapshot while other threads are using the queue.
+KAPI UInt32 ring_queue_count(ring_queue* queue);
\ No newline at end of file
@@ -1,27 +1,47 @@
 #include "application.h"
 #include "logger.h"
 #include "platform/platform.h"
+#include "platform/filesystem.h"
 #include "game_types.h"
 #include "core/kmemory.h"
+#include "core/memory_profiler.h"
 #include "core/event.h"
 #include "core/input.h"
 #include "core/clock.h"
+#include "core/job_system.h"
+#include "core/profiler.h"
+#include "core/frame_stats.h"
+#include "core/fixed_timestep.h"
+#include "core/benchmark.h"
 #include "renderer/renderer_frontend.h"
 #include "memory/linear_allocator.h"
+#include "memory/dynamic_linear_allocator.h"
+#include "memory/stack_allocator.h"
 
 typedef struct application_state
 {
     game* game_inst;
     Boolean is_running;
     Boolean is_suspended;
+    Boolean is_focused;
     Int16 width;
     Int16 height;
     clock clock;
     Double last_time;
+    frame_pacer pacer;
+    // Used instead of pacer while the window is in the background, if the game asks for it.
+    frame_pacer background_pacer;
+    // Only used when the game asks for a fixed update rate.
+    fixed_timestep timestep;
+    // Only used for a benchmark run.
+    benchmark bench;
     linear_allocator systems_allocator;
+    dynamic_linear_allocator frame_allocator;
+    stack_allocator scratch_stack;
 
     UInt64 event_system_memory_requirement;
     void* event_system_state;
+    event_listener_handle event_listeners[5];
 
     UInt64 memory_system_memory_requirement;
     void* memory_system_state;
@@ -35,15 +55,67 @@ typedef struct application_state
     UInt64 platform_system_memory_requirement;
     void* platform_system_state;
 
+    UInt64 frame_stats_system_memory_requirement;
+    void* frame_stats_system_state;
+
+    UInt64 profiler_system_memory_requirement;
+    void* profiler_system_state;
+
+    UInt64 job_system_memory_requirement;
+    void* job_system_state;
+
     UInt64 renderer_system_memory_requirement;
     void* renderer_system_state;
 } application_state;
 
+// Longest a suspended application sleeps before checking on itself again.
+#define APPLICATION_SUSPENDED_WAIT_MS 100
+
 static application_state* app_state;
 
 Boolean application_on_event(UInt16 code, void* sender, void* listener_inst, event_context context);
 Boolean application_on_key(UInt16 code, void* sender, void* listener_inst, event_context context);
 Boolean applicataion_on_resized(UInt16 code, void* sender, void* listener_inst, event_context context);
+Boolean application_on_focus_changed(UInt16 code, void* sender, void* listener_inst, event_context context);
+
+static Boolean application_update_game(Single delta_time) {
+    KPROFILE_SCOPE("game update");
+    Double start_time = platform_get_absolute_time();
+    Boolean updated = app_state->game_inst->update(app_state->game_inst, delta_time);
+    frame_stats_record(FRAME_STAT_UPDATE, platform_get_absolute_time() - start_time);
+    return updated;
+}
+
+static void application_report_benchmark(const char* output_path) {
+    frame_stats_report report;
+    frame_stats_get_report(&report);
+
+    char json[4096];
+    UInt64 length = benchmark_write_json(&app_state->bench, &report, json, sizeof(json));
+    if (length == 0) {
+        KERROR("The benchmark summary did not fit its buffer.");
+        return;
+    }
+
+    if (!output_path) {
+        KINFO("Benchmark summary:\n%s", json);
+        return;
+    }
+
+    file_handle file;
+    if (!filesystem_open(output_path, FILE_MODE_WRITE, FALSE, &file)) {
+        KERROR("Unable to open '%s' for the benchmark summary.", output_path);
+        return;
+    }
+    UInt64 written = 0;
+    Boolean result = filesystem_write(&file, length, json, &written);
+    filesystem_close(&file);
+    if (!result || written != length) {
+        KERROR("Failed to write the benchmark summary to '%s'.", output_path);
+        return;
+    }
+    KINFO("Benchmark summary written to '%s'.", output_path);
+}
 
 Boolean application_create(game* game_inst) {
     if (game_inst->application_state) {
@@ -56,18 +128,46 @@ Boolean application_create(game* game_inst) {
     app_state->game_inst = game_inst;
     app_state->is_running = FALSE;
     app_state->is_suspended = FALSE;
+    app_state->is_focused = TRUE;
 
-    UInt64 systems_allocator_total_size = 64 * 1024 * 1024;
-    linear_allocator_create(systems_allocator_total_size, 0, &app_state->systems_allocator);
+    // Only the pages the systems actually use are committed, so this can be generous.
+    UInt64 systems_allocator_total_size = GIBIBYTES(1);
+    if (!linear_allocator_create_reserved(systems_allocator_total_size, &app_state->systems_allocator)) {
+        KFATAL("Could not reserve address space for the engine systems.");
+        return FALSE;
+    }
 
     event_system_initialize(&app_state->event_system_memory_requirement, 0);
     app_state->event_system_state = linear_allocator_allocate(&app_state->systems_allocator, app_state->event_system_memory_requirement);
     event_system_initialize(&app_state->event_system_memory_requirement, app_state->event_system_state);
 
-    memory_system_initialize(&app_state->memory_system_memory_requirement, 0);
+    UInt64 heap_size = game_inst->app_config.heap_size ? game_inst->app_config.heap_size : MEBIBYTES(256);
+    memory_system_initialize(&app_state->memory_system_memory_requirement, 0, heap_size);
     app_state->memory_system_state = linear_allocator_allocate(&app_state->systems_allocator, app_state->memory_system_memory_requirement);
-    memory_system_initialize(&app_state->memory_system_memory_requirement, app_state->memory_system_state);
+    memory_system_initialize(&app_state->memory_system_memory_requirement, app_state->memory_system_state, heap_size);
+    if (game_inst->app_config.memory_profiling) {
+        memory_profiler_enable(TRUE);
+    }
+    for (UInt32 i = 0; i < game_inst->app_config.memory_budget_count; ++i) {
+        const memory_tag_budget* budget = &game_inst->app_config.memory_budgets[i];
+        if (!memory_set_tag_budget(budget->tag, budget->soft_limit, budget->hard_limit)) {
+            KFATAL("Invalid memory budget for %s.", memory_tag_name(budget->tag));
+            return FALSE;
+        }
+    }
     
+    UInt64 frame_allocator_size = game_inst->app_config.frame_allocator_size ? game_inst->app_config.frame_allocator_size : MEBIBYTES(1);
+    if (!dynamic_linear_allocator_create(frame_allocator_size, &app_state->frame_allocator)) {
+        KFATAL("Failed to create the frame allocator.");
+        return FALSE;
+    }
+
+    UInt64 scratch_stack_size = game_inst->app_config.scratch_stack_size ? game_inst->app_config.scratch_stack_size : MEBIBYTES(4);
+    if (!stack_allocator_create(scratch_stack_size, 0, &app_state->scratch_stack)) {
+        KFATAL("Failed to create the scratch stack.");
+        return FALSE;
+    }
+
     initialize_logging(&app_state->logging_system_memory_requirement, 0);
     app_state->logging_system_state = linear_allocator_allocate(&app_state->systems_allocator, app_state->logging_system_memory_requirement);
     if (!initialize_logging(&app_state->logging_system_memory_requirement, app_state->logging_system_state)) {
@@ -79,12 +179,13 @@ Boolean application_create(game* game_inst) {
     app_state->input_system_state = linear_allocator_allocate(&app_state->systems_allocator, app_state->input_system_memory_requirement);
     input_system_initialize(&app_state->input_system_memory_requirement, app_state->input_system_state);
 
-    event_register(EVENT_CODE_APPLICATION_QUIT, 0, application_on_event);
-    event_register(EVENT_CODE_KEY_PRESSED, 0, application_on_key);
-    event_register(EVENT_CODE_KEY_RELEASED, 0, application_on_key);
-    event_register(EVENT_CODE_RESIZED, 0, applicataion_on_resized);
+    app_state->event_listeners[0] = event_register_listener(EVENT_CODE_APPLICATION_QUIT, 0, application_on_event, EVENT_PRIORITY_DEFAULT);
+    app_state->event_listeners[1] = event_register_listener(EVENT_CODE_KEY_PRESSED, 0, application_on_key, EVENT_PRIORITY_DEFAULT);
+    app_state->event_listeners[2] = event_register_listener(EVENT_CODE_KEY_RELEASED, 0, application_on_key, EVENT_PRIORITY_DEFAULT);
+    app_state->event_listeners[3] = event_register_listener(EVENT_CODE_RESIZED, 0, applicataion_on_resized, EVENT_PRIORITY_DEFAULT);
+    app_state->event_listeners[4] = event_register_listener(EVENT_CODE_FOCUS_CHANGED, 0, application_on_focus_changed, EVENT_PRIORITY_DEFAULT);
     
-    platform_system_startup(&app_state->platform_system_memory_requirement, 0, 0, 0, 0, 0, 0);
+    platform_system_startup(&app_state->platform_system_memory_requirement, 0, 0, 0, 0, 0, 0, FALSE);
     app_state->platform_system_state = linear_allocator_allocate(&app_state->systems_allocator, app_state->platform_system_memory_requirement);
     if (!platform_system_startup(
             &app_state->platform_system_memory_requirement,
@@ -93,13 +194,35 @@ Boolean application_create(game* game_inst) {
             game_inst->app_config.start_pos_x,
             game_inst->app_config.start_pos_y,
             game_inst->app_config.start_width, 
-            game_inst->app_config.start_height)) {
+            game_inst->app_config.start_height,
+            game_inst->app_config.headless)) {
         return FALSE;
     }
 
-    renderer_system_initialize(&app_state->renderer_system_memory_requirement, 0, 0);
+    frame_stats_system_initialize(&app_state->frame_stats_system_memory_requirement, 0);
+    app_state->frame_stats_system_state = linear_allocator_allocate(&app_state->systems_allocator, app_state->frame_stats_system_memory_requirement);
+    frame_stats_system_initialize(&app_state->frame_stats_system_memory_requirement, app_state->frame_stats_system_state);
+    frame_stats_set_log_interval(game_inst->app_config.frame_stats_log_interval);
+
+    profiler_system_initialize(&app_state->profiler_system_memory_requirement, 0);
+    app_state->profiler_system_state = linear_allocator_allocate(&app_state->systems_allocator, app_state->profiler_system_memory_requirement);
+    profiler_system_initialize(&app_state->profiler_system_memory_requirement, app_state->profiler_system_state);
+    profiler_set_thread_name("Main thread");
+
+    UInt32 job_worker_count = game_inst->app_config.job_worker_count;
+    job_system_initialize(&app_state->job_system_memory_requirement, 0, job_worker_count);
+    app_state->job_system_state = linear_allocator_allocate(&app_state->systems_allocator, app_state->job_system_memory_requirement);
+    if (!job_system_initialize(&app_state->job_system_memory_requirement, app_state->job_system_state, job_worker_count)) {
+        KFATAL("Failed to initialize job system. Aborting application.");
+        return FALSE;
+    }
+
+    renderer_system_initialize(&app_state->renderer_system_memory_requirement, 0, 0, RENDERER_BACKEND_TYPE_NULL, FALSE);
     app_state->renderer_system_state = linear_allocator_allocate(&app_state->systems_allocator, app_state->renderer_system_memory_requirement);
-    if (!renderer_system_initialize(&app_state->renderer_system_memory_requirement, app_state->renderer_system_state, game_inst->app_config.name)) {
+    Boolean headless = game_inst->app_config.headless;
+    renderer_backend_type backend_type = headless ? RENDERER_BACKEND_TYPE_NULL : RENDERER_BACKEND_TYPE_VULKAN;
+    Boolean vsync = !headless && game_inst->app_config.frame_pacing == FRAME_PACING_VSYNC;
+    if (!renderer_system_initialize(&app_state->renderer_system_memory_requirement, app_state->renderer_system_state, game_inst->app_config.name, backend_type, vsync)) {
         KFATAL("Failed to initialize renderer. Aborting application.");
         return FALSE;
     }
@@ -121,30 +244,98 @@ Boolean application_run() {
     clock_start(&app_state->clock);
     clock_update(&app_state->clock);
     app_state->last_time = app_state->clock.elapsed;
-    Double running_time = 0;
-    UInt8 frame_count = 0;
-    Double target_frame_seconds = 1.f / 60;
+    const application_config* config = &app_state->game_inst->app_config;
+    Boolean fixed_update = config->fixed_update_rate > 0;
+    if (fixed_update) {
+        fixed_timestep_create(config->fixed_update_rate, config->max_updates_per_frame, &app_state->timestep);
+    }
+    Boolean benchmarking = config->benchmark_frame_count > 0;
+    frame_pacing_mode pacing = config->frame_pacing;
+    if (benchmarking) {
+        // A benchmark measures throughput, so frames go out as fast as they are made.
+        pacing = FRAME_PACING_UNCAPPED;
+    } else if (config->headless && pacing == FRAME_PACING_VSYNC) {
+        // Nothing is presented, so there is no display to wait on.
+        pacing = FRAME_PACING_FIXED;
+    }
+    frame_pacer_create(pacing, config->target_frame_rate, &app_state->pacer);
+    if (config->background_frame_rate > 0) {
+        frame_pacer_create(FRAME_PACING_FIXED, config->background_frame_rate, &app_state->background_pacer);
+    }
+
+    char usage[8000];
+    memory_usage_report(usage, sizeof(usage));
+    KINFO("%s", usage);
 
-    KINFO(get_memory_usage_str());
+    if (benchmarking) {
+        KINFO("Running a benchmark of %u frames.", config->benchmark_frame_count);
+        benchmark_begin(&app_state->bench, config->benchmark_frame_count, app_state->pacer.target_frame_seconds,
+                        get_memory_alloc_count(), platform_get_absolute_time());
+    }
 
     while (app_state->is_running) {
+        // Collects the zones recorded during the previous iteration.
+        profiler_frame_end();
+        KPROFILE_SCOPE("frame");
+        Double frame_start_time = platform_get_absolute_time();
+
+        if (app_state->is_suspended) {
+            // Minimized, so there is nothing to update or draw until the OS says otherwise.
+            KPROFILE_BEGIN("suspended wait");
+            platform_wait_messages(APPLICATION_SUSPENDED_WAIT_MS);
+            KPROFILE_END();
+
+            // Time spent minimized shouldn't reach the game as one huge frame.
+            clock_update(&app_state->clock);
+            app_state->last_time = app_state->clock.elapsed;
+        }
+
+        KPROFILE_BEGIN("platform_pump_messages");
         if (!platform_pump_messages()) {
             app_state->is_running = FALSE;
         }
+        KPROFILE_END();
+
+        // Input and window events posted while pumping are delivered here, once per frame.
+        event_dispatch_posted();
 
         if (!app_state->is_suspended) {
             clock_update(&app_state->clock);
             Double current_time = app_state->clock.elapsed;
             Double delta = current_time - app_state->last_time;
-            Double frame_start_time = platform_get_absolute_time();
+            if (benchmarking) {
+                // Every run simulates exactly the same thing, however fast the machine is.
+                delta = app_state->bench.frame_delta;
+            }
 
-            if (!app_state->game_inst->update(app_state->game_inst, (Single)delta)) {
+            job_system_update();
+
+            Boolean updated = TRUE;
+            Single alpha = 1.0f;
+            if (fixed_update) {
+                // Input advances with each step, so a key press is seen by exactly one step,
+                // and waits for the next frame if this one runs none.
+                UInt32 steps = fixed_timestep_advance(&app_state->timestep, delta);
+                for (UInt32 i = 0; i < steps && updated; ++i) {
+                    updated = application_update_game((Single)app_state->timestep.step_seconds);
+                    input_update(app_state->timestep.step_seconds);
+                }
+                alpha = fixed_timestep_alpha(&app_state->timestep);
+            } else {
+                updated = application_update_game((Single)delta);
+            }
+            if (!updated) {
                 KFATAL("Game update failed, shutting down.");
                 app_state->is_running = FALSE;
                 break;
             }
 
-            if (!app_state->game_inst->render(app_state->game_inst, (Single)delta)) {
+            KPROFILE_BEGIN("game render");
+            Double render_start_time = platform_get_absolute_time();
+            Boolean rendered = app_state->game_inst->render(app_state->game_inst, (Single)delta, alpha);
+            frame_stats_record(FRAME_STAT_RENDER, platform_get_absolute_time() - render_start_time);
+            KPROFILE_END();
+            if (!rendered) {
                 KFATAL("Game render failed, shutting down.");
                 app_state->is_running = FALSE;
                 break;
@@ -154,23 +345,24 @@ Boolean application_run() {
             packet.delta_time = delta;
             renderer_draw_frame(&packet);
 
-            Double frame_end_time = platform_get_absolute_time();
-            Double frame_elapsed_time = frame_end_time - frame_start_time;
-            running_time += frame_elapsed_time;
-            Double remaining_seconds = target_frame_seconds - frame_elapsed_time;
+            if (!fixed_update) {
+                input_update(delta);
+            }
 
-            if (remaining_seconds > 0) {
-                UInt64 remaining_ms = remaining_seconds * 1000;
+            dynamic_linear_allocator_reset(&app_state->frame_allocator);
 
-                Boolean limit_frames = FALSE;
-                if (remaining_ms > 0 && limit_frames) {
-                    platform_sleep(remaining_ms - 1);
-                }
+            KPROFILE_BEGIN("frame_pacer_wait");
+            Boolean background = !benchmarking && !app_state->is_focused && config->background_frame_rate > 0;
+            Double pacing_error = frame_pacer_wait(background ? &app_state->background_pacer : &app_state->pacer);
+            KPROFILE_END();
+            frame_stats_record(FRAME_STAT_PACING_ERROR, pacing_error < 0 ? -pacing_error : pacing_error);
 
-                frame_count++;
-            }
+            frame_stats_end_frame(platform_get_absolute_time() - frame_start_time);
+            memory_profiler_frame_end();
 
-            input_update(delta);
+            if (benchmarking && benchmark_end_frame(&app_state->bench, get_memory_alloc_count(), platform_get_absolute_time())) {
+                app_state->is_running = FALSE;
+            }
 
             app_state->last_time = current_time;
         }
@@ -178,17 +370,52 @@ Boolean application_run() {
 
     app_state->is_running = FALSE;
 
-    event_unregister(EVENT_CODE_APPLICATION_QUIT, 0, application_on_event);
-    event_unregister(EVENT_CODE_KEY_PRESSED, 0, application_on_key);
-    event_unregister(EVENT_CODE_KEY_RELEASED, 0, application_on_key);
-    event_unregister(EVENT_CODE_RESIZED, 0, applicataion_on_resized);
+    if (app_state->pacer.frame_count > 0) {
+        KINFO("Frame pacing: %.3f ms mean error, %.3f ms worst, %llu of %llu frames late by over %.1f ms.",
+              app_state->pacer.total_error / app_state->pacer.frame_count * 1000.0, app_state->pacer.max_error * 1000.0,
+              app_state->pacer.late_count, app_state->pacer.frame_count, FRAME_PACER_LATE_SECONDS * 1000.0);
+    }
+
+    if (fixed_update && app_state->timestep.dropped_seconds > 0) {
+        KDEBUG("Fixed update dropped %.3f s of simulation time to keep up.", app_state->timestep.dropped_seconds);
+    }
+
+    if (benchmarking) {
+        application_report_benchmark(config->benchmark_output_path);
+    }
+
+    for (UInt32 i = 0; i < 5; ++i) {
+        event_unregister_listener(app_state->event_listeners[i]);
+    }
 
     input_system_shutdown(app_state->input_system_state);
+    job_system_shutdown(app_state->job_system_state);
     renderer_system_shutdown(app_state->renderer_system_state);
+    frame_stats_system_shutdown(app_state->frame_stats_system_state);
+    profiler_system_shutdown(app_state->profiler_system_state);
     platform_system_shutdown(app_state->platform_system_state);
-    memory_system_shutdown(app_state->memory_system_state);
     event_system_shutdown(app_state->event_system_state);
 
+    KDEBUG("Frame allocator high-water mark: %llu bytes over %u page(s).",
+           app_state->frame_allocator.high_water_mark, app_state->frame_allocator.page_count);
+    dynamic_linear_allocator_destroy(&app_state->frame_allocator);
+
+    KDEBUG("Scratch stack peak: %llu of %llu bytes.", app_state->scratch_stack.peak_allocated, app_state->scratch_stack.total_size);
+    stack_allocator_destroy(&app_state->scratch_stack);
+
+    // Reported while the log file is still open, so the report ends up in it.
+    if (memory_profiler_is_enabled()) {
+        char report[4096];
+        memory_profiler_leak_report(report, sizeof(report), 20);
+        KINFO("%s", report);
+    }
+
+    // Flushes and stops the log writer; anything logged after this goes straight to the console.
+    shutdown_logging(app_state->logging_system_state);
+
+    // The memory system goes last, since the systems above return their heap blocks on shutdown.
+    memory_system_shutdown(app_state->memory_system_state);
+
     return TRUE;
 }
 
@@ -197,6 +424,14 @@ void application_get_framebuffer_size(UInt32* width, UInt32* height) {
     *height = app_state->height;
 }
 
+dynamic_linear_allocator* application_get_frame_allocator() {
+    return &app_state->frame_allocator;
+}
+
+stack_allocator* application_get_scratch_stack() {
+    return &app_state->scratch_stack;
+}
+
 Boolean application_on_event(UInt16 code, void* sender, void* listener_inst, event_context context) {
     switch (code) {
         case EVENT_CODE_APPLICATION_QUIT: {
@@ -258,3 +493,12 @@ Boolean applicataion_on_resized(UInt16 code, void* sender, void* listener_inst,
     
     return FALSE;
 }
+
+Boolean application_on_focus_changed(UInt16 code, void* sender, void* listener_inst, event_context context) {
+    Boolean focused = context.data.u8[0];
+    if (focused != app_state->is_focused) {
+        app_state->is_focused = focused;
+        KDEBUG("Window %s focus.", focused ? "gained" : "lost");
+    }
+    return FALSE;
+}
\ No newline at end of file
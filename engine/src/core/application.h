@@ -2,7 +2,12 @@
 
 #include "defines.h"
 
+#include "core/frame_pacer.h"
+
 struct game;
+struct dynamic_linear_allocator;
+struct stack_allocator;
+struct memory_tag_budget;
 
 typedef struct application_config
 {
@@ -11,9 +16,45 @@ typedef struct application_config
     Int16 start_width;
     Int16 start_height;
     char* name;
+    // Size of the engine heap that kallocate/kfree are served from. 0 uses the default.
+    UInt64 heap_size;
+    // Size of the first page of the per-frame scratch allocator. 0 uses the default.
+    UInt64 frame_allocator_size;
+    // Size of the scratch stack that loaders take nested temporaries from. 0 uses the default.
+    UInt64 scratch_stack_size;
+    // Number of job worker threads. 0 uses one per processor, less one for the main thread.
+    UInt32 job_worker_count;
+    // Seconds between frame time summaries in the log. 0 turns them off.
+    Double frame_stats_log_interval;
+    frame_pacing_mode frame_pacing;
+    // Frames per second for fixed pacing, and the refresh rate expected with vsync. 0 uses 60.
+    UInt32 target_frame_rate;
+    // Simulation steps per second. 0 calls update once per frame with the frame time instead.
+    UInt32 fixed_update_rate;
+    // Most steps a single frame may run to catch up. 0 uses 5.
+    UInt32 max_updates_per_frame;
+    // Frames per second while the window is not focused. 0 keeps the normal pacing.
+    UInt32 background_frame_rate;
+    // Runs without a window, drawing nothing, so the loop can run where there is no display or GPU.
+    Boolean headless;
+    // Frames to run before exiting, each advanced by one target frame's time. 0 runs until quit.
+    UInt32 benchmark_frame_count;
+    // Where the benchmark summary is written as JSON. 0 logs it instead.
+    const char* benchmark_output_path;
+    // Records where every allocation comes from, and reports what is still allocated at exit.
+    Boolean memory_profiling;
+    // Soft and hard budgets for individual memory tags, applied once the memory system starts.
+    const struct memory_tag_budget* memory_budgets;
+    UInt32 memory_budget_count;
 } application_config;
 
 KAPI Boolean application_create(struct game* game_inst);
 KAPI Boolean application_run();
 
-void application_get_framebuffer_size(UInt32* width, UInt32* height);
\ No newline at end of file
+void application_get_framebuffer_size(UInt32* width, UInt32* height);
+
+// Scratch memory that is released wholesale at the end of every frame.
+KAPI struct dynamic_linear_allocator* application_get_frame_allocator();
+
+// Main thread scratch memory for loaders. Take a marker first and free back to it when done.
+KAPI struct stack_allocator* application_get_scratch_stack();
\ No newline at end of file
@@ -0,0 +1,104 @@
+#include "benchmark.h"
+
+#include "core/application.h"
+#include "core/kmemory.h"
+#include "core/kstring.h"
+#include "core/logger.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+void benchmark_begin(benchmark* bench, UInt32 frame_count, Double frame_delta, UInt64 alloc_count, Double now) {
+    kzero_memory(bench, sizeof(benchmark));
+    bench->frame_target = frame_count;
+    bench->frame_delta = frame_delta;
+    bench->start_time = now;
+    bench->start_alloc_count = alloc_count;
+    bench->frame_start_alloc_count = alloc_count;
+}
+
+Boolean benchmark_end_frame(benchmark* bench, UInt64 alloc_count, Double now) {
+    UInt64 frame_allocs = alloc_count - bench->frame_start_alloc_count;
+    if (frame_allocs > bench->max_frame_allocs) {
+        bench->max_frame_allocs = frame_allocs;
+    }
+    if (frame_allocs > 0) {
+        bench->allocating_frames++;
+    }
+    bench->frame_start_alloc_count = alloc_count;
+
+    bench->frames_run++;
+    bench->elapsed_seconds = now - bench->start_time;
+    return bench->frames_run >= bench->frame_target;
+}
+
+UInt64 benchmark_write_json(const benchmark* bench, const frame_stats_report* report, char* buffer, UInt64 buffer_size) {
+    static const char* channel_names[FRAME_STAT_CHANNEL_COUNT] = {"frame", "update", "render", "present", "pacing_error"};
+
+    UInt64 frames = bench->frames_run ? bench->frames_run : 1;
+    UInt64 total_allocs = bench->frame_start_alloc_count - bench->start_alloc_count;
+    UInt64 length = 0;
+    Int32 written = snprintf(buffer, buffer_size,
+                             "{\n"
+                             "  \"frames\": %u,\n"
+                             "  \"frame_delta_ms\": %.4f,\n"
+                             "  \"elapsed_seconds\": %.6f,\n"
+                             "  \"frames_per_second\": %.2f,\n"
+                             "  \"allocations\": %llu,\n"
+                             "  \"allocations_per_frame\": %.4f,\n"
+                             "  \"max_allocations_in_a_frame\": %llu,\n"
+                             "  \"allocating_frames\": %u,\n"
+                             "  \"stats_window_frames\": %u,\n"
+                             "  \"stutter_frames\": %u,\n"
+                             "  \"channels_ms\": {",
+                             bench->frames_run, bench->frame_delta * 1000.0, bench->elapsed_seconds,
+                             bench->elapsed_seconds > 0 ? bench->frames_run / bench->elapsed_seconds : 0.0,
+                             total_allocs, (Double)total_allocs / frames, bench->max_frame_allocs,
+                             bench->allocating_frames, report->window_count, report->stutter_count);
+    if (written < 0 || (UInt64)written >= buffer_size) {
+        return 0;
+    }
+    length += written;
+
+    for (UInt32 c = 0; c < FRAME_STAT_CHANNEL_COUNT; ++c) {
+        const frame_stat_summary* s = &report->channels[c];
+        written = snprintf(buffer + length, buffer_size - length,
+                           "%s\n    \"%s\": {\"min\": %.4f, \"avg\": %.4f, \"p50\": %.4f, \"p95\": %.4f, \"p99\": %.4f, \"max\": %.4f}",
+                           c ? "," : "", channel_names[c], s->min * 1000.0, s->average * 1000.0, s->p50 * 1000.0,
+                           s->p95 * 1000.0, s->p99 * 1000.0, s->max * 1000.0);
+        if (written < 0 || (UInt64)written >= buffer_size - length) {
+            return 0;
+        }
+        length += written;
+    }
+
+    written = snprintf(buffer + length, buffer_size - length, "\n  }\n}\n");
+    if (written < 0 || (UInt64)written >= buffer_size - length) {
+        return 0;
+    }
+    return length + written;
+}
+
+Boolean benchmark_parse_arguments(Int32 argc, char** argv, application_config* config) {
+    for (Int32 i = 1; i < argc; ++i) {
+        if (strings_equal(argv[i], "--headless")) {
+            config->headless = TRUE;
+        } else if (strings_equal(argv[i], "--benchmark") && i + 1 < argc) {
+            char* end = 0;
+            long frames = strtol(argv[++i], &end, 10);
+            if (*end != 0 || frames <= 0) {
+                KERROR("--benchmark takes a frame count greater than 0, not '%s'.", argv[i]);
+                return FALSE;
+            }
+            config->benchmark_frame_count = (UInt32)frames;
+        } else if (strings_equal(argv[i], "--benchmark-output") && i + 1 < argc) {
+            config->benchmark_output_path = argv[++i];
+        } else if (strings_equal(argv[i], "--profile-memory")) {
+            config->memory_profiling = TRUE;
+        } else {
+            KERROR("Unrecognised command line argument '%s'.", argv[i]);
+            return FALSE;
+        }
+    }
+    return TRUE;
+}
\ No newline at end of file
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "defines.h"
+
+#include "core/frame_stats.h"
+
+struct application_config;
+
+// A fixed workload for the frame loop: a set number of frames, each advanced by the same
+// delta, so runs can be compared with each other.
+typedef struct benchmark {
+    UInt32 frame_target;
+    Double frame_delta;
+    UInt32 frames_run;
+    Double start_time;
+    Double elapsed_seconds;
+    UInt64 start_alloc_count;
+    UInt64 frame_start_alloc_count;
+    // Most heap allocations made by a single frame.
+    UInt64 max_frame_allocs;
+    // Frames that made at least one heap allocation.
+    UInt32 allocating_frames;
+} benchmark;
+
+KAPI void benchmark_begin(benchmark* bench, UInt32 frame_count, Double frame_delta, UInt64 alloc_count, Double now);
+
+// Closes a frame with the allocation count at its end. Returns TRUE once the last frame has run.
+KAPI Boolean benchmark_end_frame(benchmark* bench, UInt64 alloc_count, Double now);
+
+// Writes the run and the frame statistics as JSON. Returns the length, or 0 if it didn't fit.
+KAPI UInt64 benchmark_write_json(const benchmark* bench, const frame_stats_report* report, char* buffer, UInt64 buffer_size);
+
+// Applies --headless, --benchmark <frames>, --benchmark-output <path> and --profile-memory
+// to the config.
+// Returns FALSE on an argument it doesn't understand.
+KAPI Boolean benchmark_parse_arguments(Int32 argc, char** argv, struct application_config* config);
\ No newline at end of file
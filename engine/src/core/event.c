@@ -1,32 +1,86 @@
 #include "core/event.h"
 #include "core/kmemory.h"
 #include "containers/darray.h"
+#include "containers/ring_queue.h"
+#include "core/logger.h"
+#include "platform/platform.h"
 
 typedef struct registered_event {
     void* listener;
     PFN_on_event callback;
+    Int16 priority;
+    UInt32 slot;
 } registered_event;
 
 typedef struct event_code_entry {
+    // Sorted by descending priority. Unregistered entries have a null callback until compacted.
     registered_event* events;
+    UInt32 removed_count;
+    // Dispatch generation in which the latest posted event of this code was already seen.
+    UInt32 coalesce_generation;
+    Boolean coalesce;
 } event_code_entry;
 
+// Handles point at a slot; the slot's generation changes whenever it is freed, so stale
+// handles can be detected, and its position tracks where the listener sits in its code's array.
+typedef struct listener_slot {
+    UInt32 generation;
+    UInt32 position;
+    UInt32 next_free;
+    UInt16 code;
+    Boolean live;
+} listener_slot;
+
+#define LISTENER_POSITION_PENDING 0xFFFFFFFF
+#define LISTENER_SLOT_NONE 0xFFFFFFFF
+
+typedef struct posted_event {
+    UInt16 code;
+    Boolean superseded;
+    void* sender;
+    event_context context;
+} posted_event;
+
 #define MAX_MESSAGE_CODES 16384
+#define EVENT_QUEUE_CAPACITY 4096
 
 typedef struct event_system_state {
     event_code_entry registered[MAX_MESSAGE_CODES];
+
+    listener_slot* slots;
+    UInt32 first_free_slot;
+    // Registrations made while a fire was in progress, added once it finishes.
+    registered_event* pending;
+    UInt32 fire_depth;
+
+    ring_queue posted;
+    posted_event dispatching[EVENT_QUEUE_CAPACITY];
+    UInt32 dispatch_generation;
+
+    _Atomic UInt64 posted_count;
+    _Atomic UInt64 dropped_count;
+    UInt64 coalesced_count;
+    UInt64 dispatched_count;
+    UInt32 last_dispatch_count;
+    Double last_dispatch_seconds;
 } event_system_state;
 
 static event_system_state* state_ptr;
 
 void event_system_initialize(UInt64* memory_requirement, void* state) {
-    *memory_requirement = sizeof(event_system_state);
+    UInt64 queue_requirement = ring_queue_memory_requirement(RING_QUEUE_MODE_MPMC, sizeof(posted_event), EVENT_QUEUE_CAPACITY);
+    *memory_requirement = sizeof(event_system_state) + queue_requirement;
     if (state == 0) {
         return;
     }
 
-    kzero_memory(state, sizeof(state));
+    kzero_memory(state, sizeof(event_system_state));
     state_ptr = state;
+    state_ptr->first_free_slot = LISTENER_SLOT_NONE;
+    ring_queue_create(RING_QUEUE_MODE_MPMC, sizeof(posted_event), EVENT_QUEUE_CAPACITY, state_ptr + 1, &state_ptr->posted);
+
+    state_ptr->registered[EVENT_CODE_MOUSE_MOVED].coalesce = TRUE;
+    state_ptr->registered[EVENT_CODE_RESIZED].coalesce = TRUE;
 }
 
 void event_system_shutdown(void* state) {
@@ -37,52 +91,208 @@ void event_system_shutdown(void* state) {
                 state_ptr->registered[i].events = 0;
             }
         }
+        if (state_ptr->slots) {
+            darray_destroy(state_ptr->slots);
+        }
+        if (state_ptr->pending) {
+            darray_destroy(state_ptr->pending);
+        }
+        ring_queue_destroy(&state_ptr->posted);
     }
 
     state_ptr = 0;
 }
 
-Boolean event_register(UInt16 code, void* listener, PFN_on_event on_event) {
-    if (!state_ptr) {
-        return FALSE;
+static event_listener_handle make_handle(UInt32 slot_index) {
+    return ((UInt64)state_ptr->slots[slot_index].generation << 32) | (slot_index + 1);
+}
+
+static listener_slot* slot_from_handle(event_listener_handle handle, UInt32* out_index) {
+    UInt32 index = (UInt32)(handle & 0xFFFFFFFF);
+    if (index == 0 || !state_ptr->slots || index > darray_length(state_ptr->slots)) {
+        return 0;
     }
 
-    if (state_ptr->registered[code].events == 0) {
-        state_ptr->registered[code].events = darray_create(registered_event);
+    listener_slot* slot = &state_ptr->slots[index - 1];
+    if (!slot->live || slot->generation != (UInt32)(handle >> 32)) {
+        return 0;
     }
 
-    UInt64 registered_count = darray_length(state_ptr->registered[code].events);
-    for (UInt64 i = 0; i < registered_count; ++i) {
-        if (state_ptr->registered[code].events[i].listener == listener) {
-            return FALSE;
+    *out_index = index - 1;
+    return slot;
+}
+
+static UInt32 acquire_slot(UInt16 code) {
+    UInt32 index = state_ptr->first_free_slot;
+    if (index != LISTENER_SLOT_NONE) {
+        state_ptr->first_free_slot = state_ptr->slots[index].next_free;
+    } else {
+        if (!state_ptr->slots) {
+            state_ptr->slots = darray_reserve(listener_slot, 64);
+        }
+        listener_slot slot = {0};
+        slot.generation = 1;
+        darray_push(state_ptr->slots, slot);
+        index = (UInt32)darray_length(state_ptr->slots) - 1;
+    }
+
+    listener_slot* slot = &state_ptr->slots[index];
+    slot->code = code;
+    slot->live = TRUE;
+    slot->position = LISTENER_POSITION_PENDING;
+    slot->next_free = LISTENER_SLOT_NONE;
+    return index;
+}
+
+static void release_slot(UInt32 index) {
+    listener_slot* slot = &state_ptr->slots[index];
+    slot->live = FALSE;
+    slot->generation++;
+    slot->next_free = state_ptr->first_free_slot;
+    state_ptr->first_free_slot = index;
+}
+
+// Drops unregistered entries. Only done while no fire is iterating the arrays.
+static void compact_code(event_code_entry* entry) {
+    UInt64 length = darray_length(entry->events);
+    UInt64 kept = 0;
+    for (UInt64 i = 0; i < length; ++i) {
+        if (entry->events[i].callback) {
+            entry->events[kept] = entry->events[i];
+            state_ptr->slots[entry->events[kept].slot].position = (UInt32)kept;
+            kept++;
+        }
+    }
+    darray_length_set(entry->events, kept);
+    entry->removed_count = 0;
+}
+
+static void insert_listener(UInt16 code, registered_event event) {
+    event_code_entry* entry = &state_ptr->registered[code];
+    if (entry->events == 0) {
+        entry->events = darray_reserve(registered_event, 8);
+    }
+    if (entry->removed_count > 0) {
+        compact_code(entry);
+    }
+
+    UInt64 length = darray_length(entry->events);
+    UInt64 position = length;
+    while (position > 0 && entry->events[position - 1].priority < event.priority) {
+        position--;
+    }
+
+    if (position == length) {
+        darray_push(entry->events, event);
+    } else {
+        darray_insert_at(entry->events, position, event);
+    }
+
+    length++;
+    for (UInt64 i = position; i < length; ++i) {
+        state_ptr->slots[entry->events[i].slot].position = (UInt32)i;
+    }
+}
+
+static void flush_pending_listeners() {
+    if (!state_ptr->pending) {
+        return;
+    }
+
+    UInt64 count = darray_length(state_ptr->pending);
+    for (UInt64 i = 0; i < count; ++i) {
+        registered_event event = state_ptr->pending[i];
+        // Skip listeners that were unregistered again before they were ever added.
+        if (event.callback) {
+            insert_listener(state_ptr->slots[event.slot].code, event);
         }
     }
+    darray_clear(state_ptr->pending);
+}
+
+event_listener_handle event_register_listener(UInt16 code, void* listener, PFN_on_event on_event, Int16 priority) {
+    if (!state_ptr || !on_event || code >= MAX_MESSAGE_CODES) {
+        return INVALID_EVENT_LISTENER_HANDLE;
+    }
 
     registered_event event;
     event.listener = listener;
     event.callback = on_event;
+    event.priority = priority;
+    event.slot = acquire_slot(code);
+
+    if (state_ptr->fire_depth > 0) {
+        if (!state_ptr->pending) {
+            state_ptr->pending = darray_create(registered_event);
+        }
+        darray_push(state_ptr->pending, event);
+    } else {
+        insert_listener(code, event);
+    }
+
+    return make_handle(event.slot);
+}
+
+Boolean event_unregister_listener(event_listener_handle handle) {
+    if (!state_ptr) {
+        return FALSE;
+    }
 
-    darray_push(state_ptr->registered[code].events, event);
+    UInt32 index;
+    listener_slot* slot = slot_from_handle(handle, &index);
+    if (!slot) {
+        return FALSE;
+    }
 
+    if (slot->position == LISTENER_POSITION_PENDING) {
+        UInt64 count = darray_length(state_ptr->pending);
+        for (UInt64 i = 0; i < count; ++i) {
+            if (state_ptr->pending[i].slot == index) {
+                state_ptr->pending[i].callback = 0;
+            }
+        }
+    } else {
+        // Leave a hole rather than shifting, so a fire in progress keeps valid indices.
+        event_code_entry* entry = &state_ptr->registered[slot->code];
+        entry->events[slot->position].callback = 0;
+        entry->removed_count++;
+    }
+
+    release_slot(index);
     return TRUE;
 }
 
+Boolean event_register(UInt16 code, void* listener, PFN_on_event on_event) {
+    if (!state_ptr || code >= MAX_MESSAGE_CODES) {
+        return FALSE;
+    }
+
+    registered_event* events = state_ptr->registered[code].events;
+    UInt64 registered_count = events ? darray_length(events) : 0;
+    for (UInt64 i = 0; i < registered_count; ++i) {
+        if (events[i].callback && events[i].listener == listener) {
+            return FALSE;
+        }
+    }
+
+    return event_register_listener(code, listener, on_event, EVENT_PRIORITY_DEFAULT) != INVALID_EVENT_LISTENER_HANDLE;
+}
+
 Boolean event_unregister(UInt16 code, void* listener, PFN_on_event on_event) {
-    if (!state_ptr) {
+    if (!state_ptr || code >= MAX_MESSAGE_CODES) {
         return FALSE;
     }
 
-    if(state_ptr->registered[code].events == 0) {
+    registered_event* events = state_ptr->registered[code].events;
+    if (events == 0) {
         return FALSE;
     }
 
-    UInt64 registered_count = darray_length(state_ptr->registered[code].events);
+    UInt64 registered_count = darray_length(events);
     for (UInt64 i = 0; i < registered_count; ++i) {
-        registered_event e = state_ptr->registered[code].events[i];
-        if (e.listener == listener && e.callback == on_event) {
-            registered_event popped_event;
-            darray_pop_at(state_ptr->registered[code].events, i, &popped_event);
-            return TRUE;
+        registered_event e = events[i];
+        if (e.callback == on_event && e.listener == listener) {
+            return event_unregister_listener(make_handle(e.slot));
         }
     }
 
@@ -90,21 +300,123 @@ Boolean event_unregister(UInt16 code, void* listener, PFN_on_event on_event) {
 }
 
 Boolean event_fire(UInt16 code, void* sender, event_context context) {
-    if (!state_ptr) {
+    if (!state_ptr || code >= MAX_MESSAGE_CODES) {
         return FALSE;
     }
 
-    if(state_ptr->registered[code].events == 0) {
+    event_code_entry* entry = &state_ptr->registered[code];
+    if (entry->events == 0) {
         return FALSE;
     }
 
-    UInt64 registered_count = darray_length(state_ptr->registered[code].events);
+    if (state_ptr->fire_depth == 0 && entry->removed_count > 0) {
+        compact_code(entry);
+    }
+
+    // Registrations are deferred and removals leave holes while fire_depth is non-zero,
+    // so the array neither moves nor changes length during this loop.
+    state_ptr->fire_depth++;
+    Boolean handled = FALSE;
+    UInt64 registered_count = darray_length(entry->events);
     for (UInt64 i = 0; i < registered_count; ++i) {
-        registered_event e = state_ptr->registered[code].events[i];
-        if (e.callback(code, sender, e.listener, context)) {
-            return TRUE;
+        registered_event e = entry->events[i];
+        if (e.callback && e.callback(code, sender, e.listener, context)) {
+            handled = TRUE;
+            break;
         }
     }
+    state_ptr->fire_depth--;
 
-    return FALSE;
+    if (state_ptr->fire_depth == 0) {
+        flush_pending_listeners();
+    }
+
+    return handled;
+}
+
+Boolean event_post(UInt16 code, void* sender, event_context context) {
+    if (!state_ptr || code >= MAX_MESSAGE_CODES) {
+        return FALSE;
+    }
+
+    posted_event event;
+    event.code = code;
+    event.superseded = FALSE;
+    event.sender = sender;
+    event.context = context;
+
+    if (!ring_queue_enqueue(&state_ptr->posted, &event)) {
+        // Only warn on the first drop of a burst; the count is in the queue stats.
+        if (atomic_fetch_add_explicit(&state_ptr->dropped_count, 1, memory_order_relaxed) == 0) {
+            KWARN("event_post - queue of %u events is full; events are being dropped.", EVENT_QUEUE_CAPACITY);
+        }
+        return FALSE;
+    }
+
+    atomic_fetch_add_explicit(&state_ptr->posted_count, 1, memory_order_relaxed);
+    return TRUE;
+}
+
+void event_dispatch_posted() {
+    if (!state_ptr) {
+        return;
+    }
+
+    Double start_time = platform_get_absolute_time();
+
+    // Take a snapshot first, so listeners that post more events cannot keep this loop alive.
+    UInt32 count = 0;
+    while (count < EVENT_QUEUE_CAPACITY && ring_queue_dequeue(&state_ptr->posted, &state_ptr->dispatching[count])) {
+        count++;
+    }
+
+    // Walk backwards so the newest event of each coalesced code is the one that survives.
+    UInt32 generation = ++state_ptr->dispatch_generation;
+    for (UInt32 i = count; i > 0; --i) {
+        posted_event* event = &state_ptr->dispatching[i - 1];
+        event_code_entry* entry = &state_ptr->registered[event->code];
+        if (entry->coalesce) {
+            if (entry->coalesce_generation == generation) {
+                event->superseded = TRUE;
+                state_ptr->coalesced_count++;
+            } else {
+                entry->coalesce_generation = generation;
+            }
+        }
+    }
+
+    UInt32 dispatched = 0;
+    for (UInt32 i = 0; i < count; ++i) {
+        posted_event* event = &state_ptr->dispatching[i];
+        if (!event->superseded) {
+            event_fire(event->code, event->sender, event->context);
+            dispatched++;
+        }
+    }
+
+    state_ptr->dispatched_count += dispatched;
+    state_ptr->last_dispatch_count = dispatched;
+    state_ptr->last_dispatch_seconds = platform_get_absolute_time() - start_time;
+}
+
+void event_set_coalescing(UInt16 code, Boolean coalesce) {
+    if (state_ptr && code < MAX_MESSAGE_CODES) {
+        state_ptr->registered[code].coalesce = coalesce;
+    }
+}
+
+void event_get_queue_stats(event_queue_stats* out_stats) {
+    if (!out_stats) {
+        return;
+    }
+
+    kzero_memory(out_stats, sizeof(event_queue_stats));
+    if (state_ptr) {
+        out_stats->posted_count = atomic_load_explicit(&state_ptr->posted_count, memory_order_relaxed);
+        out_stats->dropped_count = atomic_load_explicit(&state_ptr->dropped_count, memory_order_relaxed);
+        out_stats->coalesced_count = state_ptr->coalesced_count;
+        out_stats->dispatched_count = state_ptr->dispatched_count;
+        out_stats->last_dispatch_count = state_ptr->last_dispatch_count;
+        out_stats->last_dispatch_seconds = state_ptr->last_dispatch_seconds;
+    }
 }
\ No newline at end of file
@@ -25,13 +25,54 @@ typedef struct event_context {
 
 typedef Boolean (*PFN_on_event)(UInt16 code, void* sender, void* listener_inst, event_context data);
 
-void event_system_initialize();
-void event_system_shutdown();
+typedef struct event_queue_stats {
+    // Totals since the event system started.
+    UInt64 posted_count;
+    UInt64 dropped_count;
+    UInt64 coalesced_count;
+    UInt64 dispatched_count;
+    // From the most recent event_dispatch_posted call.
+    UInt32 last_dispatch_count;
+    Double last_dispatch_seconds;
+} event_queue_stats;
 
+KAPI void event_system_initialize(UInt64* memory_requirement, void* state);
+KAPI void event_system_shutdown(void* state);
+
+// Identifies one registration. 0 is never a valid handle.
+typedef UInt64 event_listener_handle;
+
+#define INVALID_EVENT_LISTENER_HANDLE 0
+#define EVENT_PRIORITY_DEFAULT 0
+
+// Listeners with a higher priority are called first; equal priorities keep registration order.
+// Safe to call from inside a listener: the new listener is added once the outermost fire returns.
+KAPI event_listener_handle event_register_listener(UInt16 code, void* listener, PFN_on_event on_event, Int16 priority);
+// O(1). Safe to call from inside a listener; the listener is not called again after this returns.
+// Stale handles are rejected.
+KAPI Boolean event_unregister_listener(event_listener_handle handle);
+
+// Registers at the default priority. Fails if listener is already registered for code.
 KAPI Boolean event_register(UInt16 code, void* listener, PFN_on_event on_event);
 KAPI Boolean event_unregister(UInt16 code, void* listener, PFN_on_event on_event);
+
+// Calls every listener for code immediately, on the caller's thread.
 KAPI Boolean event_fire(UInt16 code, void* sender, event_context context);
 
+// Queues an event for the next event_dispatch_posted call. Safe to call from any thread.
+// Returns FALSE if the queue is full and the event was dropped.
+KAPI Boolean event_post(UInt16 code, void* sender, event_context context);
+
+// Fires the events posted so far, in order. Called once per frame by the application.
+// Events posted by listeners during dispatch wait for the next call.
+KAPI void event_dispatch_posted();
+
+// When enabled, only the latest posted event of this code survives each dispatch.
+// Mouse movement and resize events are coalesced by default.
+KAPI void event_set_coalescing(UInt16 code, Boolean coalesce);
+
+KAPI void event_get_queue_stats(event_queue_stats* out_stats);
+
 typedef enum system_event_code {
     EVENT_CODE_APPLICATION_QUIT = 0x01,
     EVENT_CODE_KEY_PRESSED = 0x02,
@@ -41,6 +82,11 @@ typedef enum system_event_code {
     EVENT_CODE_MOUSE_MOVED = 0x06,
     EVENT_CODE_MOUSE_WHEEL = 0x07,
     EVENT_CODE_RESIZED = 0x08,
+    // context.data.u8[0] is TRUE when the window gained focus, FALSE when it lost it.
+    EVENT_CODE_FOCUS_CHANGED = 0x09,
+    // A memory tag went over its soft budget. Posted, so listeners run on the main thread.
+    // context.data.u32[0] is the memory_tag; context.data.u64[1] is the bytes it had allocated.
+    EVENT_CODE_MEMORY_PRESSURE = 0x0A,
 
     MAX_EVENT_CODE = 0xFF
 } system_event_code;
\ No newline at end of file
@@ -0,0 +1,35 @@
+#include "fixed_timestep.h"
+
+#include "core/kmemory.h"
+
+void fixed_timestep_create(UInt32 steps_per_second, UInt32 max_steps_per_frame, fixed_timestep* out_timestep) {
+    kzero_memory(out_timestep, sizeof(fixed_timestep));
+    out_timestep->step_seconds = 1.0 / (steps_per_second ? steps_per_second : 60);
+    out_timestep->max_steps_per_frame = max_steps_per_frame ? max_steps_per_frame : 5;
+}
+
+UInt32 fixed_timestep_advance(fixed_timestep* timestep, Double frame_seconds) {
+    if (frame_seconds > 0) {
+        timestep->accumulator += frame_seconds;
+    }
+
+    UInt32 steps = (UInt32)(timestep->accumulator / timestep->step_seconds);
+    if (steps > timestep->max_steps_per_frame) {
+        Double kept = timestep->accumulator - (steps - timestep->max_steps_per_frame) * timestep->step_seconds;
+        timestep->dropped_seconds += timestep->accumulator - kept;
+        timestep->accumulator = kept;
+        steps = timestep->max_steps_per_frame;
+    }
+
+    timestep->accumulator -= steps * timestep->step_seconds;
+    if (timestep->accumulator < 0) {
+        timestep->accumulator = 0;
+    }
+    timestep->step_count += steps;
+    return steps;
+}
+
+Single fixed_timestep_alpha(const fixed_timestep* timestep) {
+    Double alpha = timestep->accumulator / timestep->step_seconds;
+    return (Single)(alpha < 1.0 ? alpha : 1.0);
+}
\ No newline at end of file
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "defines.h"
+
+// Turns variable frame times into a whole number of fixed simulation steps.
+typedef struct fixed_timestep {
+    Double step_seconds;
+    UInt32 max_steps_per_frame;
+    // Frame time not yet simulated; always less than one step between frames.
+    Double accumulator;
+    UInt64 step_count;
+    // Time thrown away because a frame needed more than max_steps_per_frame steps.
+    Double dropped_seconds;
+} fixed_timestep;
+
+// A max_steps_per_frame of 0 uses 5.
+KAPI void fixed_timestep_create(UInt32 steps_per_second, UInt32 max_steps_per_frame, fixed_timestep* out_timestep);
+
+// Adds a frame's time and returns how many steps to simulate now. When that would exceed the
+// cap, the backlog is dropped, so slow frames can't snowball into ever slower ones.
+KAPI UInt32 fixed_timestep_advance(fixed_timestep* timestep, Double frame_seconds);
+
+// How far between the last two simulated states the present moment is, from 0 to 1.
+KAPI Single fixed_timestep_alpha(const fixed_timestep* timestep);
\ No newline at end of file
@@ -0,0 +1,76 @@
+#include "frame_pacer.h"
+
+#include "core/kmemory.h"
+#include "platform/platform.h"
+
+#define FRAME_PACER_MIN_SPIN_SECONDS 0.0005
+
+void frame_pacer_create(frame_pacing_mode mode, UInt32 target_frame_rate, frame_pacer* out_pacer) {
+    kzero_memory(out_pacer, sizeof(frame_pacer));
+    out_pacer->mode = mode;
+    out_pacer->target_frame_seconds = 1.0 / (target_frame_rate ? target_frame_rate : 60);
+    out_pacer->spin_threshold = 0.002;
+}
+
+static void sleep_until(frame_pacer* pacer, Double deadline) {
+    for (;;) {
+        Double now = platform_get_absolute_time();
+        Double remaining = deadline - now;
+        if (remaining <= 0) {
+            return;
+        }
+
+        // Millisecond sleeps can overshoot by a lot, so the last stretch is spun instead.
+        UInt64 sleep_ms = remaining > pacer->spin_threshold ? (UInt64)((remaining - pacer->spin_threshold) * 1000.0) : 0;
+        if (sleep_ms == 0) {
+            continue;
+        }
+
+        platform_sleep(sleep_ms);
+        Double overshoot = platform_get_absolute_time() - now - sleep_ms * 0.001;
+        if (overshoot > pacer->spin_threshold) {
+            pacer->spin_threshold = overshoot < pacer->target_frame_seconds ? overshoot : pacer->target_frame_seconds;
+        } else if (pacer->spin_threshold > FRAME_PACER_MIN_SPIN_SECONDS) {
+            // Slowly win back sleep time once the OS behaves again.
+            pacer->spin_threshold *= 0.99;
+        }
+    }
+}
+
+Double frame_pacer_wait(frame_pacer* pacer) {
+    if (pacer->mode == FRAME_PACING_UNCAPPED) {
+        return 0;
+    }
+
+    if (pacer->next_deadline == 0) {
+        pacer->next_deadline = platform_get_absolute_time() + pacer->target_frame_seconds;
+        return 0;
+    }
+
+    if (pacer->mode == FRAME_PACING_FIXED) {
+        sleep_until(pacer, pacer->next_deadline);
+    }
+
+    Double now = platform_get_absolute_time();
+    Double error = now - pacer->next_deadline;
+
+    // Deadlines are a fixed cadence, so small errors don't accumulate. After a long stall the
+    // cadence restarts instead of rushing frames out to catch up.
+    if (error > pacer->target_frame_seconds || error < -pacer->target_frame_seconds) {
+        pacer->next_deadline = now + pacer->target_frame_seconds;
+    } else {
+        pacer->next_deadline += pacer->target_frame_seconds;
+    }
+
+    Double magnitude = error < 0 ? -error : error;
+    pacer->frame_count++;
+    pacer->total_error += magnitude;
+    if (magnitude > pacer->max_error) {
+        pacer->max_error = magnitude;
+    }
+    if (error > FRAME_PACER_LATE_SECONDS) {
+        pacer->late_count++;
+    }
+
+    return error;
+}
\ No newline at end of file
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "defines.h"
+
+typedef enum frame_pacing_mode {
+    // Frames start every 1/target_frame_rate seconds: the pacer sleeps through most of the gap,
+    // then spins on the high resolution clock for the rest. The default.
+    FRAME_PACING_FIXED = 0,
+    // Frames run back to back.
+    FRAME_PACING_UNCAPPED,
+    // Presentation blocks until the display is ready, so the pacer never waits. The target
+    // frame rate should match the display's refresh rate, since errors are measured against it.
+    FRAME_PACING_VSYNC
+} frame_pacing_mode;
+
+typedef struct frame_pacer {
+    frame_pacing_mode mode;
+    Double target_frame_seconds;
+    // When the next frame should start; 0 until the first wait.
+    Double next_deadline;
+    // Sleeps stop this far short of the deadline. It grows whenever the OS oversleeps.
+    Double spin_threshold;
+
+    UInt64 frame_count;
+    // Frames that started more than FRAME_PACER_LATE_SECONDS after their deadline.
+    UInt64 late_count;
+    Double total_error;
+    Double max_error;
+} frame_pacer;
+
+#define FRAME_PACER_LATE_SECONDS 0.001
+
+// A target_frame_rate of 0 uses 60.
+KAPI void frame_pacer_create(frame_pacing_mode mode, UInt32 target_frame_rate, frame_pacer* out_pacer);
+
+// Blocks until the next frame should start. Returns how far that start missed its deadline,
+// in seconds; positive is late. Always 0 when uncapped.
+KAPI Double frame_pacer_wait(frame_pacer* pacer);
\ No newline at end of file
@@ -0,0 +1,177 @@
+#include "frame_stats.h"
+
+#include "core/logger.h"
+#include "core/kmemory.h"
+#include "core/kstring.h"
+#include "platform/filesystem.h"
+
+#include <stdlib.h>
+
+#define FRAME_STUTTER_FACTOR 2.0
+
+typedef struct frame_stats_state {
+    // Ring of the last FRAME_STATS_WINDOW frames, one row per channel.
+    Double samples[FRAME_STAT_CHANNEL_COUNT][FRAME_STATS_WINDOW];
+    Double current[FRAME_STAT_CHANNEL_COUNT];
+    UInt64 frame_count;
+
+    Double log_interval;
+    Double time_since_log;
+
+    file_handle csv_file;
+
+    // Sorted copy of one channel, so reports need no allocation.
+    Double scratch[FRAME_STATS_WINDOW];
+} frame_stats_state;
+
+static frame_stats_state* state_ptr;
+
+static const char* channel_names[FRAME_STAT_CHANNEL_COUNT] = {"frame", "update", "render", "present", "pacing"};
+
+Boolean frame_stats_system_initialize(UInt64* memory_requirement, void* state) {
+    *memory_requirement = sizeof(frame_stats_state);
+    if (state == 0) {
+        return TRUE;
+    }
+
+    kzero_memory(state, sizeof(frame_stats_state));
+    state_ptr = state;
+    return TRUE;
+}
+
+void frame_stats_system_shutdown(void* state) {
+    if (state_ptr) {
+        filesystem_close(&state_ptr->csv_file);
+        state_ptr = 0;
+    }
+}
+
+void frame_stats_record(frame_stat_channel channel, Double seconds) {
+    if (state_ptr && channel < FRAME_STAT_CHANNEL_COUNT) {
+        state_ptr->current[channel] += seconds;
+    }
+}
+
+static int compare_doubles(const void* a, const void* b) {
+    Double left = *(const Double*)a;
+    Double right = *(const Double*)b;
+    return left < right ? -1 : (left > right ? 1 : 0);
+}
+
+// Nearest rank: the smallest sample with at least the given fraction of samples at or below it.
+static Double percentile(const Double* sorted, UInt32 count, UInt32 percent) {
+    UInt32 rank = (count * percent + 99) / 100;
+    return sorted[rank > 0 ? rank - 1 : 0];
+}
+
+void frame_stats_get_report(frame_stats_report* out_report) {
+    kzero_memory(out_report, sizeof(frame_stats_report));
+    if (!state_ptr || state_ptr->frame_count == 0) {
+        return;
+    }
+
+    UInt32 count = state_ptr->frame_count < FRAME_STATS_WINDOW ? (UInt32)state_ptr->frame_count : FRAME_STATS_WINDOW;
+    out_report->frame_count = state_ptr->frame_count;
+    out_report->window_count = count;
+
+    for (UInt32 c = 0; c < FRAME_STAT_CHANNEL_COUNT; ++c) {
+        kcopy_memory(state_ptr->scratch, state_ptr->samples[c], sizeof(Double) * count);
+        qsort(state_ptr->scratch, count, sizeof(Double), compare_doubles);
+
+        Double total = 0;
+        for (UInt32 i = 0; i < count; ++i) {
+            total += state_ptr->scratch[i];
+        }
+
+        frame_stat_summary* summary = &out_report->channels[c];
+        summary->min = state_ptr->scratch[0];
+        summary->max = state_ptr->scratch[count - 1];
+        summary->average = total / count;
+        summary->p50 = percentile(state_ptr->scratch, count, 50);
+        summary->p95 = percentile(state_ptr->scratch, count, 95);
+        summary->p99 = percentile(state_ptr->scratch, count, 99);
+
+        if (c == FRAME_STAT_FRAME) {
+            // Sorted, so the stutters are the tail past the threshold.
+            Double threshold = summary->p50 * FRAME_STUTTER_FACTOR;
+            UInt32 first_stutter = count;
+            while (first_stutter > 0 && state_ptr->scratch[first_stutter - 1] > threshold) {
+                first_stutter--;
+            }
+            out_report->stutter_count = count - first_stutter;
+        }
+    }
+}
+
+static void log_report() {
+    frame_stats_report report;
+    frame_stats_get_report(&report);
+
+    const frame_stat_summary* frame = &report.channels[FRAME_STAT_FRAME];
+    KINFO("Frame stats over %u frames: %.2f ms avg, %.2f/%.2f/%.2f ms p50/p95/p99, %.2f-%.2f ms range, %u stutter(s).",
+          report.window_count, frame->average * 1000.0, frame->p50 * 1000.0, frame->p95 * 1000.0, frame->p99 * 1000.0,
+          frame->min * 1000.0, frame->max * 1000.0, report.stutter_count);
+    for (UInt32 c = FRAME_STAT_UPDATE; c < FRAME_STAT_CHANNEL_COUNT; ++c) {
+        const frame_stat_summary* summary = &report.channels[c];
+        KINFO("  %-8s %.2f ms avg, %.2f/%.2f/%.2f ms p50/p95/p99, %.2f ms max.",
+              channel_names[c], summary->average * 1000.0, summary->p50 * 1000.0, summary->p95 * 1000.0,
+              summary->p99 * 1000.0, summary->max * 1000.0);
+    }
+}
+
+void frame_stats_end_frame(Double frame_seconds) {
+    if (!state_ptr) {
+        return;
+    }
+
+    state_ptr->current[FRAME_STAT_FRAME] = frame_seconds;
+    UInt32 slot = (UInt32)(state_ptr->frame_count % FRAME_STATS_WINDOW);
+    for (UInt32 c = 0; c < FRAME_STAT_CHANNEL_COUNT; ++c) {
+        state_ptr->samples[c][slot] = state_ptr->current[c];
+    }
+    state_ptr->frame_count++;
+
+    if (state_ptr->csv_file.is_valid) {
+        char row[256];
+        Int32 length = string_format(row, "%llu,%.4f,%.4f,%.4f,%.4f,%.4f\n", state_ptr->frame_count,
+                                     state_ptr->current[FRAME_STAT_FRAME] * 1000.0, state_ptr->current[FRAME_STAT_UPDATE] * 1000.0,
+                                     state_ptr->current[FRAME_STAT_RENDER] * 1000.0, state_ptr->current[FRAME_STAT_PRESENT] * 1000.0,
+                                     state_ptr->current[FRAME_STAT_PACING_ERROR] * 1000.0);
+        UInt64 written = 0;
+        filesystem_write(&state_ptr->csv_file, length, row, &written);
+    }
+    kzero_memory(state_ptr->current, sizeof(state_ptr->current));
+
+    if (state_ptr->log_interval > 0) {
+        state_ptr->time_since_log += frame_seconds;
+        if (state_ptr->time_since_log >= state_ptr->log_interval) {
+            state_ptr->time_since_log = 0;
+            log_report();
+        }
+    }
+}
+
+void frame_stats_set_log_interval(Double seconds) {
+    if (state_ptr) {
+        state_ptr->log_interval = seconds;
+        state_ptr->time_since_log = 0;
+    }
+}
+
+Boolean frame_stats_set_csv_output(const char* path) {
+    if (!state_ptr) {
+        return FALSE;
+    }
+
+    filesystem_close(&state_ptr->csv_file);
+    if (!path) {
+        return TRUE;
+    }
+
+    if (!filesystem_open(path, FILE_MODE_WRITE, FALSE, &state_ptr->csv_file)) {
+        KERROR("frame_stats_set_csv_output - unable to open '%s'.", path);
+        return FALSE;
+    }
+    filesystem_write_line(&state_ptr->csv_file, "frame,frame_ms,update_ms,render_ms,present_ms,pacing_error_ms");
+    return TRUE;
+}
\ No newline at end of file
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "defines.h"
+
+// Number of most recent frames the statistics are computed over.
+#define FRAME_STATS_WINDOW 1024
+
+typedef enum frame_stat_channel {
+    // The whole iteration of the frame loop.
+    FRAME_STAT_FRAME,
+    FRAME_STAT_UPDATE,
+    FRAME_STAT_RENDER,
+    // Waiting for a free swapchain frame, then submitting the frame and presenting it.
+    FRAME_STAT_PRESENT,
+    // How far the frame started from its paced deadline, either way.
+    FRAME_STAT_PACING_ERROR,
+    FRAME_STAT_CHANNEL_COUNT
+} frame_stat_channel;
+
+// All times are in seconds.
+typedef struct frame_stat_summary {
+    Double min;
+    Double average;
+    Double p50;
+    Double p95;
+    Double p99;
+    Double max;
+} frame_stat_summary;
+
+typedef struct frame_stats_report {
+    // Frames recorded since initialization.
+    UInt64 frame_count;
+    // Frames the summaries cover, at most FRAME_STATS_WINDOW.
+    UInt32 window_count;
+    // Frames in the window that took more than twice the median frame time.
+    UInt32 stutter_count;
+    frame_stat_summary channels[FRAME_STAT_CHANNEL_COUNT];
+} frame_stats_report;
+
+KAPI Boolean frame_stats_system_initialize(UInt64* memory_requirement, void* state);
+KAPI void frame_stats_system_shutdown(void* state);
+
+// Adds time to a channel of the current frame; a channel can be recorded several times.
+KAPI void frame_stats_record(frame_stat_channel channel, Double seconds);
+
+// Closes the current frame with its total time, then logs or dumps it if asked to.
+KAPI void frame_stats_end_frame(Double frame_seconds);
+
+KAPI void frame_stats_get_report(frame_stats_report* out_report);
+
+// Logs a summary every interval seconds of frame time. 0 turns it off.
+KAPI void frame_stats_set_log_interval(Double seconds);
+
+// Writes one CSV row per frame to path, in milliseconds. Pass 0 to stop.
+KAPI Boolean frame_stats_set_csv_output(const char* path);
\ No newline at end of file
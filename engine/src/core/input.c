@@ -31,7 +31,7 @@ void input_system_initialize(UInt64* memory_requirement, void* state) {
 
     kzero_memory(state, sizeof(input_state));
     state_ptr = state;
-    KINFO("Input subsystem initialized.");
+    KINFO_C(LOG_CATEGORY_INPUT, "Input subsystem initialized.");
 }
 
 void input_system_shutdown(void* state) {
@@ -53,7 +53,7 @@ void input_process_key(keys key, Boolean pressed) {
 
         event_context context;
         context.data.u16[0] = key;
-        event_fire(pressed ? EVENT_CODE_KEY_PRESSED : EVENT_CODE_KEY_RELEASED, 0, context);
+        event_post(pressed ? EVENT_CODE_KEY_PRESSED : EVENT_CODE_KEY_RELEASED, 0, context);
     }
 }
 
@@ -63,7 +63,7 @@ void input_process_mouse_button(buttons button, Boolean pressed) {
 
         event_context context;
         context.data.u16[0] = button;
-        event_fire(pressed ? EVENT_CODE_BUTTON_PRESSED : EVENT_CODE_BUTTON_RELEASED, 0, context);
+        event_post(pressed ? EVENT_CODE_BUTTON_PRESSED : EVENT_CODE_BUTTON_RELEASED, 0, context);
     }
 }
 
@@ -77,14 +77,14 @@ void input_process_mouse_move(Int16 x, Int16 y) {
         event_context context;
         context.data.u16[0] = x;
         context.data.u16[1] = y;
-        event_fire(EVENT_CODE_MOUSE_MOVED, 0, context);
+        event_post(EVENT_CODE_MOUSE_MOVED, 0, context);
     }
 }
 
 void input_process_mouse_wheel(Int8 z_delta) {
     event_context context;
     context.data.u8[0] = z_delta;
-    event_fire(EVENT_CODE_MOUSE_WHEEL, 0, context);
+    event_post(EVENT_CODE_MOUSE_WHEEL, 0, context);
 }
 
 Boolean input_is_key_down(keys key) {
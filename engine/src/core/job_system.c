@@ -0,0 +1,407 @@
+#include "job_system.h"
+
+#include "core/logger.h"
+#include "core/kmemory.h"
+#include "core/kstring.h"
+#include "core/profiler.h"
+#include "containers/darray.h"
+#include "platform/platform.h"
+
+// Must be a power of two.
+#define JOB_DEQUE_CAPACITY 512
+
+// Each queue is a double-ended ring behind a spin lock: its owner pushes and pops at the
+// back, while other threads steal from the front. The lock is only ever held for a copy.
+typedef struct job_deque {
+    atomic_flag lock;
+    _Atomic UInt32 head;
+    _Atomic UInt32 tail;
+    job_info jobs[JOB_DEQUE_CAPACITY];
+} job_deque;
+
+// Queue 0 belongs to the main thread, queue i > 0 to worker thread i.
+typedef struct job_queue_set {
+    job_deque lanes[JOB_PRIORITY_COUNT];
+    kthread thread;
+    UInt32 index;
+} job_queue_set;
+
+typedef struct job_system_state {
+    atomic_bool running;
+    UInt32 worker_count;
+    UInt32 queue_count;
+    job_queue_set* queues;
+    _Atomic UInt32 next_queue;
+    ksemaphore work_available;
+
+    // Jobs whose dependency has not reached zero yet.
+    kmutex pending_mutex;
+    job_info* pending;
+
+    kmutex main_thread_mutex;
+    job_info* main_thread_jobs;
+} job_system_state;
+
+static job_system_state* state_ptr;
+
+// Index of the queue owned by the calling thread, or -1 for threads outside the job system.
+static _Thread_local Int32 current_queue_index = -1;
+
+static UInt32 resolve_worker_count(UInt32 worker_count) {
+    if (worker_count == 0) {
+        Int32 processors = platform_get_processor_count();
+        worker_count = processors > 1 ? processors - 1 : 1;
+    }
+    return worker_count;
+}
+
+static void deque_lock(job_deque* deque) {
+    while (atomic_flag_test_and_set_explicit(&deque->lock, memory_order_acquire)) {
+    }
+}
+
+static void deque_unlock(job_deque* deque) {
+    atomic_flag_clear_explicit(&deque->lock, memory_order_release);
+}
+
+static Boolean deque_is_empty(job_deque* deque) {
+    return atomic_load_explicit(&deque->head, memory_order_relaxed) == atomic_load_explicit(&deque->tail, memory_order_relaxed);
+}
+
+static Boolean deque_push_back(job_deque* deque, const job_info* job) {
+    deque_lock(deque);
+    UInt32 head = atomic_load_explicit(&deque->head, memory_order_relaxed);
+    UInt32 tail = atomic_load_explicit(&deque->tail, memory_order_relaxed);
+    if (tail - head == JOB_DEQUE_CAPACITY) {
+        deque_unlock(deque);
+        return FALSE;
+    }
+
+    deque->jobs[tail & (JOB_DEQUE_CAPACITY - 1)] = *job;
+    atomic_store_explicit(&deque->tail, tail + 1, memory_order_relaxed);
+    deque_unlock(deque);
+    return TRUE;
+}
+
+static Boolean deque_pop_back(job_deque* deque, job_info* out_job) {
+    if (deque_is_empty(deque)) {
+        return FALSE;
+    }
+
+    deque_lock(deque);
+    UInt32 head = atomic_load_explicit(&deque->head, memory_order_relaxed);
+    UInt32 tail = atomic_load_explicit(&deque->tail, memory_order_relaxed);
+    if (head == tail) {
+        deque_unlock(deque);
+        return FALSE;
+    }
+
+    tail--;
+    *out_job = deque->jobs[tail & (JOB_DEQUE_CAPACITY - 1)];
+    atomic_store_explicit(&deque->tail, tail, memory_order_relaxed);
+    deque_unlock(deque);
+    return TRUE;
+}
+
+static Boolean deque_steal_front(job_deque* deque, job_info* out_job) {
+    if (deque_is_empty(deque)) {
+        return FALSE;
+    }
+
+    deque_lock(deque);
+    UInt32 head = atomic_load_explicit(&deque->head, memory_order_relaxed);
+    UInt32 tail = atomic_load_explicit(&deque->tail, memory_order_relaxed);
+    if (head == tail) {
+        deque_unlock(deque);
+        return FALSE;
+    }
+
+    *out_job = deque->jobs[head & (JOB_DEQUE_CAPACITY - 1)];
+    atomic_store_explicit(&deque->head, head + 1, memory_order_relaxed);
+    deque_unlock(deque);
+    return TRUE;
+}
+
+static void job_execute(const job_info* job);
+
+static void job_schedule(const job_info* job) {
+    if (job->main_thread_only) {
+        platform_mutex_lock(&state_ptr->main_thread_mutex);
+        darray_push(state_ptr->main_thread_jobs, *job);
+        platform_mutex_unlock(&state_ptr->main_thread_mutex);
+        return;
+    }
+
+    // Keep work local to the submitting thread; outside threads spread it round robin.
+    UInt32 start = current_queue_index >= 0
+                       ? (UInt32)current_queue_index
+                       : atomic_fetch_add_explicit(&state_ptr->next_queue, 1, memory_order_relaxed) % state_ptr->queue_count;
+    for (UInt32 i = 0; i < state_ptr->queue_count; ++i) {
+        job_queue_set* queues = &state_ptr->queues[(start + i) % state_ptr->queue_count];
+        if (deque_push_back(&queues->lanes[job->priority], job)) {
+            platform_semaphore_signal(&state_ptr->work_available);
+            return;
+        }
+    }
+
+    // Every queue is full; doing the work here is better than dropping it.
+    job_execute(job);
+}
+
+static void job_release_dependents(job_counter* counter) {
+    for (;;) {
+        Boolean found = FALSE;
+        job_info released;
+
+        platform_mutex_lock(&state_ptr->pending_mutex);
+        UInt64 length = darray_length(state_ptr->pending);
+        for (UInt64 i = 0; i < length; ++i) {
+            if (state_ptr->pending[i].dependency == counter) {
+                released = state_ptr->pending[i];
+                state_ptr->pending[i] = state_ptr->pending[length - 1];
+                darray_length_set(state_ptr->pending, length - 1);
+                found = TRUE;
+                break;
+            }
+        }
+        platform_mutex_unlock(&state_ptr->pending_mutex);
+
+        if (!found) {
+            return;
+        }
+
+        job_schedule(&released);
+    }
+}
+
+static void job_execute(const job_info* job) {
+    KPROFILE_BEGIN("job");
+    job->entry_point(job->params);
+    KPROFILE_END();
+
+    if (job->counter && atomic_fetch_sub_explicit(&job->counter->value, 1, memory_order_acq_rel) == 1 && state_ptr) {
+        job_release_dependents(job->counter);
+    }
+}
+
+static Boolean job_run_main_thread_job() {
+    job_info job;
+    Boolean found = FALSE;
+
+    platform_mutex_lock(&state_ptr->main_thread_mutex);
+    UInt64 length = darray_length(state_ptr->main_thread_jobs);
+    if (length > 0) {
+        // Oldest first, so main-thread work runs in submission order.
+        darray_pop_at(state_ptr->main_thread_jobs, 0, &job);
+        found = TRUE;
+    }
+    platform_mutex_unlock(&state_ptr->main_thread_mutex);
+
+    if (found) {
+        job_execute(&job);
+    }
+    return found;
+}
+
+// Runs at most one job: the thread's own newest work first, then the oldest work of others.
+static Boolean job_try_run_one(Int32 queue_index) {
+    job_info job;
+    for (UInt32 priority = 0; priority < JOB_PRIORITY_COUNT; ++priority) {
+        if (queue_index >= 0 && deque_pop_back(&state_ptr->queues[queue_index].lanes[priority], &job)) {
+            job_execute(&job);
+            return TRUE;
+        }
+
+        UInt32 start = queue_index >= 0 ? (UInt32)queue_index + 1 : 0;
+        for (UInt32 i = 0; i < state_ptr->queue_count; ++i) {
+            UInt32 victim = (start + i) % state_ptr->queue_count;
+            if ((Int32)victim != queue_index && deque_steal_front(&state_ptr->queues[victim].lanes[priority], &job)) {
+                job_execute(&job);
+                return TRUE;
+            }
+        }
+    }
+
+    return FALSE;
+}
+
+static UInt32 job_worker_thread_run(void* params) {
+    job_queue_set* queues = params;
+    current_queue_index = (Int32)queues->index;
+
+    char thread_name[PROFILER_THREAD_NAME_LENGTH];
+    string_format(thread_name, "Job worker %u", queues->index);
+    profiler_set_thread_name(thread_name);
+
+    while (atomic_load_explicit(&state_ptr->running, memory_order_acquire)) {
+        if (!job_try_run_one(current_queue_index)) {
+            platform_semaphore_wait(&state_ptr->work_available, 100);
+        }
+    }
+
+    profiler_thread_release();
+    memory_thread_cache_flush();
+    return 0;
+}
+
+// Safe to call with only some workers started.
+static void stop_workers() {
+    atomic_store(&state_ptr->running, FALSE);
+    for (UInt32 i = 0; i < state_ptr->worker_count; ++i) {
+        platform_semaphore_signal(&state_ptr->work_available);
+    }
+
+    for (UInt32 i = 1; i < state_ptr->queue_count; ++i) {
+        platform_thread_destroy(&state_ptr->queues[i].thread);
+    }
+}
+
+// Safe to call with only some primitives created.
+static void destroy_state() {
+    darray_destroy(state_ptr->pending);
+    darray_destroy(state_ptr->main_thread_jobs);
+    platform_semaphore_destroy(&state_ptr->work_available);
+    platform_mutex_destroy(&state_ptr->pending_mutex);
+    platform_mutex_destroy(&state_ptr->main_thread_mutex);
+    current_queue_index = -1;
+    state_ptr = 0;
+}
+
+Boolean job_system_initialize(UInt64* memory_requirement, void* state, UInt32 worker_count) {
+    worker_count = resolve_worker_count(worker_count);
+    *memory_requirement = sizeof(job_system_state) + sizeof(job_queue_set) * (worker_count + 1);
+
+    if (state == 0) {
+        return TRUE;
+    }
+
+    state_ptr = state;
+    kzero_memory(state_ptr, *memory_requirement);
+    state_ptr->worker_count = worker_count;
+    state_ptr->queue_count = worker_count + 1;
+    state_ptr->queues = (job_queue_set*)(state_ptr + 1);
+    state_ptr->pending = darray_create(job_info);
+    state_ptr->main_thread_jobs = darray_create(job_info);
+    atomic_init(&state_ptr->next_queue, 0);
+
+    if (!platform_mutex_create(&state_ptr->pending_mutex) ||
+        !platform_mutex_create(&state_ptr->main_thread_mutex) ||
+        !platform_semaphore_create(&state_ptr->work_available, 0x7FFFFFFF, 0)) {
+        KERROR("Job system failed to create its synchronization primitives.");
+        destroy_state();
+        return FALSE;
+    }
+
+    for (UInt32 i = 0; i < state_ptr->queue_count; ++i) {
+        state_ptr->queues[i].index = i;
+        for (UInt32 p = 0; p < JOB_PRIORITY_COUNT; ++p) {
+            atomic_flag_clear(&state_ptr->queues[i].lanes[p].lock);
+        }
+    }
+
+    current_queue_index = 0;
+    atomic_store(&state_ptr->running, TRUE);
+
+    for (UInt32 i = 1; i < state_ptr->queue_count; ++i) {
+        if (!platform_thread_create(job_worker_thread_run, &state_ptr->queues[i], &state_ptr->queues[i].thread)) {
+            KFATAL("Job system failed to start worker thread %u.", i);
+            stop_workers();
+            destroy_state();
+            return FALSE;
+        }
+    }
+
+    KDEBUG("Job system started %u worker thread(s).", worker_count);
+    return TRUE;
+}
+
+void job_system_shutdown(void* state) {
+    if (state_ptr) {
+        stop_workers();
+
+        // Finish whatever is still queued here, so nothing waiting on a counter is left hanging.
+        // Jobs these submit, or release from pending, land in queue 0 and are run as well.
+        current_queue_index = 0;
+        UInt64 drained_count = 0;
+        while (job_run_main_thread_job() || job_try_run_one(0)) {
+            drained_count++;
+        }
+        if (drained_count > 0) {
+            KDEBUG("Job system ran %llu queued job(s) while shutting down.", drained_count);
+        }
+
+        UInt64 pending_count = darray_length(state_ptr->pending);
+        if (pending_count > 0) {
+            KWARN("Job system shut down with %llu job(s) still waiting on a dependency.", pending_count);
+        }
+
+        destroy_state();
+    }
+}
+
+void job_system_update() {
+    if (!state_ptr) {
+        return;
+    }
+
+    // Only drain what is queued now, so jobs that queue more main-thread work cannot stall the frame.
+    platform_mutex_lock(&state_ptr->main_thread_mutex);
+    UInt64 count = darray_length(state_ptr->main_thread_jobs);
+    platform_mutex_unlock(&state_ptr->main_thread_mutex);
+
+    for (UInt64 i = 0; i < count && job_run_main_thread_job(); ++i) {
+    }
+}
+
+UInt32 job_system_worker_count() {
+    return state_ptr ? state_ptr->worker_count : 0;
+}
+
+void job_submit(const job_info* job) {
+    if (!job || !job->entry_point) {
+        KERROR("job_submit - a job requires an entry point.");
+        return;
+    }
+
+    if (job->counter) {
+        atomic_fetch_add_explicit(&job->counter->value, 1, memory_order_relaxed);
+    }
+
+    if (!state_ptr) {
+        job_execute(job);
+        return;
+    }
+
+    if (job->dependency) {
+        // Checked under the lock so a dependency finishing right now cannot miss this job.
+        platform_mutex_lock(&state_ptr->pending_mutex);
+        Boolean waiting = atomic_load_explicit(&job->dependency->value, memory_order_acquire) > 0;
+        if (waiting) {
+            darray_push(state_ptr->pending, *job);
+        }
+        platform_mutex_unlock(&state_ptr->pending_mutex);
+
+        if (waiting) {
+            return;
+        }
+    }
+
+    job_schedule(job);
+}
+
+void job_counter_wait(job_counter* counter) {
+    if (!counter) {
+        return;
+    }
+
+    while (atomic_load_explicit(&counter->value, memory_order_acquire) > 0) {
+        if (!state_ptr) {
+            return;
+        }
+
+        Boolean ran = current_queue_index == 0 && job_run_main_thread_job();
+        if (!ran && !job_try_run_one(current_queue_index)) {
+            platform_sleep(0);
+        }
+    }
+}
\ No newline at end of file
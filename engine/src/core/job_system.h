@@ -0,0 +1,48 @@
+#pragma once
+
+#include "defines.h"
+
+#include <stdatomic.h>
+
+typedef void (*pfn_job_entry)(void* params);
+
+typedef enum job_priority {
+    // Frame-critical work. Always taken before any low priority job.
+    JOB_PRIORITY_HIGH,
+    // Background work such as streaming.
+    JOB_PRIORITY_LOW,
+    JOB_PRIORITY_COUNT
+} job_priority;
+
+// Counts outstanding jobs. Zero-initialize before first use; each job submitted with a
+// counter increments it, and it is decremented when the job finishes.
+typedef struct job_counter {
+    _Atomic Int64 value;
+} job_counter;
+
+typedef struct job_info {
+    pfn_job_entry entry_point;
+    void* params;
+    job_priority priority;
+    // Only ever run on the main thread, from job_system_update or job_counter_wait.
+    Boolean main_thread_only;
+    // Optional. Decremented when this job has finished.
+    job_counter* counter;
+    // Optional. The job is held back until this counter reaches zero.
+    job_counter* dependency;
+} job_info;
+
+// worker_count of 0 starts one worker per processor, less one for the main thread.
+KAPI Boolean job_system_initialize(UInt64* memory_requirement, void* state, UInt32 worker_count);
+KAPI void job_system_shutdown(void* state);
+
+// Runs the main-thread-only jobs that are queued. Call once per frame from the main thread.
+KAPI void job_system_update();
+
+KAPI UInt32 job_system_worker_count();
+
+// Queues a job. If the job system is not running, the job is run immediately instead.
+KAPI void job_submit(const job_info* job);
+
+// Blocks until counter reaches zero, running queued jobs on this thread in the meantime.
+KAPI void job_counter_wait(job_counter* counter);
\ No newline at end of file
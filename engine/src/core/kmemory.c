@@ -1,14 +1,32 @@
 #include "kmemory.h"
 #include "logger.h"
 #include "platform/platform.h"
+#include "memory/freelist.h"
+#include "core/memory_profiler.h"
+#include "core/event.h"
 
 #include <string.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <stdatomic.h>
+
+// Counters are updated with relaxed atomics so kallocate/kfree can be called from any
+// thread. Each set sits on its own cache line so threads working with different tags
+// do not contend on the same line.
+typedef struct memory_counters {
+    _Atomic UInt64 current;
+    _Atomic UInt64 peak;
+    _Atomic UInt64 allocation_count;
+    _Atomic UInt64 free_count;
+    UInt64 padding[4];
+} memory_counters;
+
+STATIC_ASSERT(sizeof(memory_counters) == 64, "Expected memory_counters to fill one cache line.");
 
 struct memory_stats
 {
-    UInt32 total_allocated;
-    UInt32 tagged_allocations[MEMORY_TAG_MAX_TAGS];
+    memory_counters total;
+    memory_counters tagged[MEMORY_TAG_MAX_TAGS];
 };
 
 static const char* memory_tag_strings[MEMORY_TAG_MAX_TAGS] =
@@ -30,17 +48,351 @@ static const char* memory_tag_strings[MEMORY_TAG_MAX_TAGS] =
     "TRANSFORM   ",
     "ENTITY      ",
     "ENTITY_NODE ",
-    "SCENE       "
+    "SCENE       ",
+    "FREELIST    "
 };
 
+// Small blocks come from per-thread caches of size classes from 16 to 1024 bytes. A cache
+// refills from the heap and drains back to it a batch at a time, so threads allocating
+// small blocks rarely take the heap lock.
+#define MEMORY_CACHE_MIN_BLOCK FREELIST_ALIGNMENT
+#define MEMORY_CACHE_CLASS_COUNT 7
+#define MEMORY_CACHE_MAX_BLOCK (MEMORY_CACHE_MIN_BLOCK << (MEMORY_CACHE_CLASS_COUNT - 1))
+#define MEMORY_CACHE_BATCH 32
+// A class holding more than this many free blocks drains back down to one batch.
+#define MEMORY_CACHE_LIMIT (MEMORY_CACHE_BATCH * 2)
+// Threads past this many share the heap directly.
+#define MEMORY_MAX_THREAD_CACHES 32
+
+// Heaps at least this big ask for huge pages, where a TLB miss on every few pages adds up.
+#define MEMORY_LARGE_PAGE_HEAP_SIZE MEBIBYTES(32)
+
+// Statistics a thread keeps for itself. Only the owning thread writes them, so updates are
+// plain loads and stores; readers add every thread's counters up when asked.
+typedef struct memory_thread_counters {
+    _Atomic UInt64 allocated;
+    _Atomic UInt64 freed;
+    _Atomic UInt64 allocation_count;
+    _Atomic UInt64 free_count;
+} memory_thread_counters;
+
+// Free blocks of one size class, linked through their first bytes.
+typedef struct memory_cache_bin {
+    void* head;
+    UInt32 count;
+} memory_cache_bin;
+
+typedef struct memory_thread_cache {
+    // Set when the owning thread has flushed and given the slot up for another to take.
+    _Atomic Boolean released;
+    memory_cache_bin bins[MEMORY_CACHE_CLASS_COUNT];
+    memory_thread_counters total;
+    memory_thread_counters tagged[MEMORY_TAG_MAX_TAGS];
+} memory_thread_cache;
+
+// Keeps each thread's cache off its neighbours' cache lines.
+typedef union memory_thread_slot {
+    memory_thread_cache cache;
+    UInt8 padding[(sizeof(memory_thread_cache) + 63) & ~63];
+} memory_thread_slot;
+
+typedef struct memory_budget {
+    _Atomic UInt64 soft_limit;
+    _Atomic UInt64 hard_limit;
+    // Set from the soft limit being crossed until the tag drops back under it.
+    _Atomic Boolean under_pressure;
+} memory_budget;
+
 typedef struct memory_system_state {
     struct memory_stats stats;
-    UInt64 alloc_count;
+    UInt64 total_allocation_size;
+    // Guards the heap; held only for the freelist operation itself.
+    atomic_flag allocator_lock;
+    freelist allocator;
+    void* allocator_block;
+    _Atomic Boolean thread_caches_enabled;
+    _Atomic UInt32 thread_cache_count;
+    memory_thread_slot thread_caches[MEMORY_MAX_THREAD_CACHES];
+    memory_budget budgets[MEMORY_TAG_MAX_TAGS];
+    _Atomic PFN_memory_budget_exceeded on_budget_exceeded;
 } memory_system_state;
 
 static memory_system_state* state_ptr;
 
-void memory_system_initialize(UInt64* memory_requirement, void* state) {
+// Each initialization starts a new session, which makes threads take a new cache.
+static _Atomic UInt32 active_session;
+static _Atomic UInt32 last_session;
+static _Thread_local UInt32 current_session;
+static _Thread_local memory_thread_cache* current_cache;
+
+static void allocator_lock() {
+    while (atomic_flag_test_and_set_explicit(&state_ptr->allocator_lock, memory_order_acquire)) {
+    }
+}
+
+static void allocator_unlock() {
+    atomic_flag_clear_explicit(&state_ptr->allocator_lock, memory_order_release);
+}
+
+static void counters_raise_peak(memory_counters* counters, UInt64 current) {
+    UInt64 peak = atomic_load_explicit(&counters->peak, memory_order_relaxed);
+    while (current > peak && !atomic_compare_exchange_weak_explicit(&counters->peak, &peak, current, memory_order_relaxed, memory_order_relaxed)) {
+    }
+}
+
+static UInt64 counters_add(memory_counters* counters, UInt64 size) {
+    atomic_fetch_add_explicit(&counters->allocation_count, 1, memory_order_relaxed);
+    return atomic_fetch_add_explicit(&counters->current, size, memory_order_relaxed) + size;
+}
+
+static void counters_remove(memory_counters* counters, UInt64 size) {
+    atomic_fetch_sub_explicit(&counters->current, size, memory_order_relaxed);
+    atomic_fetch_add_explicit(&counters->free_count, 1, memory_order_relaxed);
+}
+
+static inline void thread_counter_add(_Atomic UInt64* counter, UInt64 value) {
+    atomic_store_explicit(counter, atomic_load_explicit(counter, memory_order_relaxed) + value, memory_order_relaxed);
+}
+
+static void thread_counters_add(memory_thread_counters* counters, UInt64 size) {
+    thread_counter_add(&counters->allocated, size);
+    thread_counter_add(&counters->allocation_count, 1);
+}
+
+static void thread_counters_remove(memory_thread_counters* counters, UInt64 size) {
+    thread_counter_add(&counters->freed, size);
+    thread_counter_add(&counters->free_count, 1);
+}
+
+// Adds the shared counters and every thread's own together. The peak can only be seen at the
+// moments somebody looks, so it is raised here and wherever the heap is touched anyway.
+static void stats_collect(memory_counters* counters, Int32 tag, memory_stats_snapshot* out_stats) {
+    UInt64 current = atomic_load_explicit(&counters->current, memory_order_relaxed);
+    out_stats->allocation_count = atomic_load_explicit(&counters->allocation_count, memory_order_relaxed);
+    out_stats->free_count = atomic_load_explicit(&counters->free_count, memory_order_relaxed);
+
+    UInt32 thread_count = atomic_load_explicit(&state_ptr->thread_cache_count, memory_order_acquire);
+    if (thread_count > MEMORY_MAX_THREAD_CACHES) {
+        thread_count = MEMORY_MAX_THREAD_CACHES;
+    }
+    for (UInt32 i = 0; i < thread_count; ++i) {
+        memory_thread_cache* cache = &state_ptr->thread_caches[i].cache;
+        memory_thread_counters* thread_counters = tag < 0 ? &cache->total : &cache->tagged[tag];
+        // A thread can free what another allocated, so only the sum is meaningful.
+        current += atomic_load_explicit(&thread_counters->allocated, memory_order_relaxed);
+        current -= atomic_load_explicit(&thread_counters->freed, memory_order_relaxed);
+        out_stats->allocation_count += atomic_load_explicit(&thread_counters->allocation_count, memory_order_relaxed);
+        out_stats->free_count += atomic_load_explicit(&thread_counters->free_count, memory_order_relaxed);
+    }
+
+    // The slots are read one at a time, so a free can be seen before the allocation it undoes.
+    // That sample is torn; report nothing allocated and keep it away from the peak.
+    Boolean torn = (Int64)current < 0;
+    out_stats->current = torn ? 0 : current;
+    if (thread_count > 0 && !torn) {
+        counters_raise_peak(counters, current);
+    }
+    out_stats->peak = atomic_load_explicit(&counters->peak, memory_order_relaxed);
+}
+
+static void stats_sample_peaks(memory_tag tag) {
+    memory_stats_snapshot snapshot;
+    stats_collect(&state_ptr->stats.total, -1, &snapshot);
+    stats_collect(&state_ptr->stats.tagged[tag], tag, &snapshot);
+}
+
+static void report_budget_exceeded(memory_tag tag, UInt64 size, UInt64 current, UInt64 hard_limit) {
+    KFATAL("Memory tag %s is out of budget: %llu bytes allocated, %llu more requested, hard limit %llu.",
+           memory_tag_strings[tag], current, size, hard_limit);
+
+    char report[4096];
+    memory_usage_report(report, sizeof(report));
+    KFATAL("%s", report);
+    if (memory_profiler_is_enabled()) {
+        memory_profiler_leak_report(report, sizeof(report), 20);
+        KFATAL("%s", report);
+    }
+
+    abort();
+}
+
+// Returns FALSE if size would take the tag past its hard limit.
+static Boolean budget_admit(memory_tag tag, UInt64 size) {
+    memory_budget* budget = &state_ptr->budgets[tag];
+    UInt64 soft_limit = atomic_load_explicit(&budget->soft_limit, memory_order_relaxed);
+    UInt64 hard_limit = atomic_load_explicit(&budget->hard_limit, memory_order_relaxed);
+    if (soft_limit == 0 && hard_limit == 0) {
+        return TRUE;
+    }
+
+    memory_stats_snapshot stats;
+    stats_collect(&state_ptr->stats.tagged[tag], tag, &stats);
+    if (hard_limit && stats.current + size > hard_limit) {
+        PFN_memory_budget_exceeded handler = atomic_load_explicit(&state_ptr->on_budget_exceeded, memory_order_relaxed);
+        (handler ? handler : report_budget_exceeded)(tag, size, stats.current, hard_limit);
+        return FALSE;
+    }
+
+    if (soft_limit && stats.current + size > soft_limit &&
+        !atomic_exchange_explicit(&budget->under_pressure, TRUE, memory_order_relaxed)) {
+        event_context context = {};
+        context.data.u32[0] = tag;
+        context.data.u64[1] = stats.current + size;
+        event_post(EVENT_CODE_MEMORY_PRESSURE, 0, context);
+    }
+    return TRUE;
+}
+
+// Only called while the tag is under pressure, to notice it dropping back under the soft limit.
+static void budget_release(memory_tag tag) {
+    memory_budget* budget = &state_ptr->budgets[tag];
+    memory_stats_snapshot stats;
+    stats_collect(&state_ptr->stats.tagged[tag], tag, &stats);
+    if (stats.current <= atomic_load_explicit(&budget->soft_limit, memory_order_relaxed)) {
+        atomic_store_explicit(&budget->under_pressure, FALSE, memory_order_relaxed);
+    }
+}
+
+static memory_thread_cache* register_current_thread(UInt32 session) {
+    current_session = session;
+    current_cache = 0;
+    if (session == 0 || !state_ptr) {
+        return 0;
+    }
+
+    // Take over a slot a finished thread gave back before opening a new one. The counters
+    // carry on from where it left off, which is fine since only the sums are reported.
+    UInt32 count = atomic_load_explicit(&state_ptr->thread_cache_count, memory_order_acquire);
+    for (UInt32 i = 0; i < count && i < MEMORY_MAX_THREAD_CACHES; ++i) {
+        memory_thread_cache* cache = &state_ptr->thread_caches[i].cache;
+        Boolean released = TRUE;
+        if (atomic_load_explicit(&cache->released, memory_order_relaxed) &&
+            atomic_compare_exchange_strong_explicit(&cache->released, &released, FALSE, memory_order_acquire, memory_order_relaxed)) {
+            current_cache = cache;
+            return current_cache;
+        }
+    }
+
+    UInt32 index = atomic_fetch_add(&state_ptr->thread_cache_count, 1);
+    if (index >= MEMORY_MAX_THREAD_CACHES) {
+        // Every slot is held by a live thread; this one takes the shared path.
+        atomic_store(&state_ptr->thread_cache_count, MEMORY_MAX_THREAD_CACHES);
+        return 0;
+    }
+
+    current_cache = &state_ptr->thread_caches[index].cache;
+    return current_cache;
+}
+
+// The calling thread's cache, whether or not caching is switched on.
+static inline memory_thread_cache* registered_thread_cache() {
+    UInt32 session = atomic_load_explicit(&active_session, memory_order_acquire);
+    if (session != current_session) {
+        return register_current_thread(session);
+    }
+    return current_cache;
+}
+
+static inline memory_thread_cache* current_thread_cache() {
+    if (!state_ptr || !state_ptr->allocator_block || !atomic_load_explicit(&state_ptr->thread_caches_enabled, memory_order_relaxed)) {
+        return 0;
+    }
+    return registered_thread_cache();
+}
+
+static inline UInt32 size_class(UInt64 size) {
+    if (size <= MEMORY_CACHE_MIN_BLOCK) {
+        return 0;
+    }
+    return (UInt32)(64 - __builtin_clzll(size - 1)) - 4;
+}
+
+// Small blocks always take a whole size class from the heap, cached or not, so they can be
+// freed either way.
+static inline Boolean is_small_block(UInt64 size, UInt16 alignment) {
+    return size <= MEMORY_CACHE_MAX_BLOCK && alignment <= FREELIST_ALIGNMENT;
+}
+
+static void* heap_allocate(UInt64 size, UInt16 alignment) {
+    void* memory_block = 0;
+    allocator_lock();
+    if (alignment <= FREELIST_ALIGNMENT) {
+        memory_block = freelist_allocate(&state_ptr->allocator, size);
+    }
+    else {
+        // Over-allocate and remember how far the aligned block is from the real one in
+        // the bytes just before it. Heap blocks are FREELIST_ALIGNMENT aligned, so there
+        // is always at least that much room.
+        UInt8* raw = freelist_allocate(&state_ptr->allocator, size + alignment);
+        if (raw) {
+            UInt8* aligned = (UInt8*)(((UInt64)raw + alignment) & ~((UInt64)alignment - 1));
+            ((UInt32*)aligned)[-1] = (UInt32)(aligned - raw);
+            memory_block = aligned;
+        }
+    }
+    allocator_unlock();
+    return memory_block;
+}
+
+static void heap_free(void* block, UInt64 size, UInt16 alignment) {
+    allocator_lock();
+    if (alignment <= FREELIST_ALIGNMENT) {
+        freelist_free(&state_ptr->allocator, block, size);
+    }
+    else {
+        UInt8* raw = (UInt8*)block - ((UInt32*)block)[-1];
+        freelist_free(&state_ptr->allocator, raw, size + alignment);
+    }
+    allocator_unlock();
+}
+
+static void* cache_allocate(memory_thread_cache* cache, UInt32 class_index, memory_tag tag) {
+    memory_cache_bin* bin = &cache->bins[class_index];
+    if (bin->head) {
+        void* block = bin->head;
+        bin->head = *(void**)block;
+        bin->count--;
+        return block;
+    }
+
+    // Take a whole batch as one run and split it, halving the batch if the heap is short.
+    UInt64 block_size = (UInt64)MEMORY_CACHE_MIN_BLOCK << class_index;
+    UInt32 count = MEMORY_CACHE_BATCH;
+    UInt8* run = 0;
+    allocator_lock();
+    while (count > 0 && !(run = freelist_allocate(&state_ptr->allocator, block_size * count))) {
+        count /= 2;
+    }
+    allocator_unlock();
+    if (!run) {
+        return 0;
+    }
+
+    for (UInt32 i = count - 1; i > 0; --i) {
+        void** block = (void**)(run + block_size * i);
+        *block = bin->head;
+        bin->head = block;
+    }
+    bin->count += count - 1;
+
+    stats_sample_peaks(tag);
+    return run;
+}
+
+static void cache_drain(memory_thread_cache* cache, UInt32 class_index, UInt32 keep) {
+    memory_cache_bin* bin = &cache->bins[class_index];
+    UInt64 block_size = (UInt64)MEMORY_CACHE_MIN_BLOCK << class_index;
+    allocator_lock();
+    while (bin->count > keep) {
+        void* block = bin->head;
+        bin->head = *(void**)block;
+        bin->count--;
+        freelist_free(&state_ptr->allocator, block, block_size);
+    }
+    allocator_unlock();
+}
+
+void memory_system_initialize(UInt64* memory_requirement, void* state, UInt64 total_allocation_size) {
     *memory_requirement = sizeof(memory_system_state);
     
     if (state == 0) {
@@ -48,40 +400,265 @@ void memory_system_initialize(UInt64* memory_requirement, void* state) {
     }
 
     state_ptr = state;
-    state_ptr->alloc_count = 0;
     platform_zero_memory(&state_ptr->stats, sizeof(state_ptr->stats));
+    platform_zero_memory(state_ptr->thread_caches, sizeof(state_ptr->thread_caches));
+    platform_zero_memory(state_ptr->budgets, sizeof(state_ptr->budgets));
+    atomic_store(&state_ptr->on_budget_exceeded, 0);
+    atomic_flag_clear(&state_ptr->allocator_lock);
+    atomic_store(&state_ptr->thread_caches_enabled, TRUE);
+    atomic_store(&state_ptr->thread_cache_count, 0);
+
+    // Reserve and commit the whole heap up front so that kallocate/kfree never reach the OS
+    // afterwards. Pages are only backed once touched, so an unused heap costs little.
+    UInt64 page_size = platform_get_page_size();
+    total_allocation_size = (total_allocation_size + page_size - 1) / page_size * page_size;
+    state_ptr->total_allocation_size = total_allocation_size;
+    state_ptr->allocator_block = platform_reserve(total_allocation_size);
+    Boolean large_pages = total_allocation_size >= MEMORY_LARGE_PAGE_HEAP_SIZE;
+    if (state_ptr->allocator_block && !platform_commit(state_ptr->allocator_block, total_allocation_size, large_pages)) {
+        platform_release(state_ptr->allocator_block, total_allocation_size);
+        state_ptr->allocator_block = 0;
+    }
+    if (!state_ptr->allocator_block) {
+        KFATAL("Memory system could not reserve %llu bytes. kallocate will fall back to the platform.", total_allocation_size);
+        platform_zero_memory(&state_ptr->allocator, sizeof(freelist));
+        return;
+    }
+
+    freelist_create(total_allocation_size, state_ptr->allocator_block, &state_ptr->allocator);
+    atomic_store(&active_session, atomic_fetch_add(&last_session, 1) + 1);
+
+    KDEBUG_C(LOG_CATEGORY_MEMORY, "Memory system reserved %llu bytes.", total_allocation_size);
 }
 
 void memory_system_shutdown(void* state) {
+    if (state_ptr) {
+        // Blocks still sitting in thread caches go with the heap.
+        atomic_store(&active_session, 0);
+        memory_profiler_enable(FALSE);
+        freelist_destroy(&state_ptr->allocator);
+        if (state_ptr->allocator_block) {
+            platform_release(state_ptr->allocator_block, state_ptr->total_allocation_size);
+            state_ptr->allocator_block = 0;
+        }
+    }
+
     state_ptr = 0;
 }
 
-void* kallocate(UInt64 size, memory_tag tag) {
+// The names are in parentheses so the callsite macros in kmemory.h leave them alone.
+void* (kallocate)(UInt64 size, memory_tag tag) {
+    return kallocate_aligned_at(size, 1, tag, 0, 0);
+}
+
+void* (kallocate_aligned)(UInt64 size, UInt16 alignment, memory_tag tag) {
+    return kallocate_aligned_at(size, alignment, tag, 0, 0);
+}
+
+void* kallocate_aligned_at(UInt64 size, UInt16 alignment, memory_tag tag, const char* file, UInt32 line) {
     if (tag == MEMORY_TAG_UNKNOWN)
-        KWARN("kallocate called using MEMORY_TAG_UNKNOWN. Re-class this allocation.");
+        KWARN_C(LOG_CATEGORY_MEMORY, "kallocate called using MEMORY_TAG_UNKNOWN. Re-class this allocation.");
+
+    if (alignment == 0 || (alignment & (alignment - 1)) != 0) {
+        KERROR("kallocate_aligned - alignment must be a power of two, got %u.", alignment);
+        return 0;
+    }
+
+    if (state_ptr && !budget_admit(tag, size)) {
+        return 0;
+    }
     
-    if (state_ptr) {
-        state_ptr->stats.total_allocated += size;
-        state_ptr->stats.tagged_allocations[tag] += size;
-        state_ptr->alloc_count++;
+    memory_thread_cache* cache = current_thread_cache();
+    if (cache) {
+        thread_counters_add(&cache->total, size);
+        thread_counters_add(&cache->tagged[tag], size);
+    }
+    else if (state_ptr) {
+        UInt64 total = counters_add(&state_ptr->stats.total, size);
+        UInt64 tagged = counters_add(&state_ptr->stats.tagged[tag], size);
+        if (!atomic_load_explicit(&state_ptr->thread_caches_enabled, memory_order_relaxed)) {
+            // Without thread caches the shared counters are the whole story.
+            counters_raise_peak(&state_ptr->stats.total, total);
+            counters_raise_peak(&state_ptr->stats.tagged[tag], tagged);
+        }
     }
     
-    void* memory_block = platform_allocate(size, FALSE);
+    void* memory_block = 0;
+    if (state_ptr && state_ptr->allocator_block) {
+        Boolean small = is_small_block(size, alignment);
+        UInt64 block_size = small ? (UInt64)MEMORY_CACHE_MIN_BLOCK << size_class(size) : size;
+        if (small && cache) {
+            memory_block = cache_allocate(cache, size_class(size), tag);
+        }
+        else {
+            memory_block = heap_allocate(block_size, alignment);
+            if (atomic_load_explicit(&state_ptr->thread_caches_enabled, memory_order_relaxed)) {
+                stats_sample_peaks(tag);
+            }
+        }
+
+        if (!memory_block && cache) {
+            // Free blocks this thread is holding on to may be enough. Drained in place, since a
+            // flush would give up the slot this call is still counting in.
+            for (UInt32 i = 0; i < MEMORY_CACHE_CLASS_COUNT; ++i) {
+                if (cache->bins[i].count > 0) {
+                    cache_drain(cache, i, 0);
+                }
+            }
+            memory_block = heap_allocate(block_size, alignment);
+        }
+
+        if (!memory_block) {
+            allocator_lock();
+            UInt64 free_space = freelist_free_space(&state_ptr->allocator);
+            allocator_unlock();
+            KWARN_C(LOG_CATEGORY_MEMORY,
+                    "kallocate - heap exhausted (%llu of %llu bytes free), falling back to the platform for %llu bytes.",
+                    free_space, state_ptr->total_allocation_size, size);
+        }
+    }
+
+    // Allocations made before the memory system starts (or once its heap is full) go to the platform.
+    if (!memory_block) {
+        memory_block = alignment <= FREELIST_ALIGNMENT ? platform_allocate(size, FALSE) : platform_allocate_aligned(size, alignment);
+    }
+    if (!memory_block) {
+        KERROR("kallocate - the platform could not provide %llu bytes either.", size);
+        // Undo the counts taken above, as if the block had been freed.
+        if (cache) {
+            thread_counters_remove(&cache->total, size);
+            thread_counters_remove(&cache->tagged[tag], size);
+        }
+        else if (state_ptr) {
+            counters_remove(&state_ptr->stats.total, size);
+            counters_remove(&state_ptr->stats.tagged[tag], size);
+        }
+        return 0;
+    }
     platform_zero_memory(memory_block, size);
+
+    if (memory_profiler_is_enabled()) {
+        memory_profiler_record_allocation(memory_block, size, tag, file, line);
+    }
     
     return memory_block;
 }
 
 void kfree(void* block, UInt64 size, memory_tag tag) {
+    kfree_aligned(block, size, 1, tag);
+}
+
+void kfree_aligned(void* block, UInt64 size, UInt16 alignment, memory_tag tag) {
     if (tag == MEMORY_TAG_UNKNOWN)
-        KWARN("kfree called using MEMORY_TAG_UNKNOWN. Re-class this allocation.");
+        KWARN_C(LOG_CATEGORY_MEMORY, "kfree called using MEMORY_TAG_UNKNOWN. Re-class this allocation.");
+
+    // Before the block is released, since another thread may be handed it straight after.
+    if (memory_profiler_is_enabled()) {
+        memory_profiler_record_free(block);
+    }
     
-    if (state_ptr) {
-        state_ptr->stats.total_allocated -= size;
-        state_ptr->stats.tagged_allocations[tag] -= size;
+    memory_thread_cache* cache = current_thread_cache();
+    if (cache) {
+        thread_counters_remove(&cache->total, size);
+        thread_counters_remove(&cache->tagged[tag], size);
+    }
+    else if (state_ptr) {
+        counters_remove(&state_ptr->stats.total, size);
+        counters_remove(&state_ptr->stats.tagged[tag], size);
+    }
+
+    if (state_ptr && atomic_load_explicit(&state_ptr->budgets[tag].under_pressure, memory_order_relaxed)) {
+        budget_release(tag);
     }
     
-    platform_free(block, FALSE);
+    if (state_ptr && freelist_owns_block(&state_ptr->allocator, block)) {
+        if (!is_small_block(size, alignment)) {
+            heap_free(block, size, alignment);
+        }
+        else if (!cache) {
+            heap_free(block, (UInt64)MEMORY_CACHE_MIN_BLOCK << size_class(size), alignment);
+        }
+        else {
+            // Blocks go to this thread's cache, whichever thread allocated them.
+            UInt32 class_index = size_class(size);
+            memory_cache_bin* bin = &cache->bins[class_index];
+            *(void**)block = bin->head;
+            bin->head = block;
+            if (++bin->count > MEMORY_CACHE_LIMIT) {
+                cache_drain(cache, class_index, MEMORY_CACHE_BATCH);
+            }
+        }
+    }
+    else if (alignment <= FREELIST_ALIGNMENT) {
+        platform_free(block, FALSE);
+    }
+    else {
+        platform_free_aligned(block);
+    }
+}
+
+void memory_thread_cache_flush() {
+    if (!state_ptr || !state_ptr->allocator_block) {
+        return;
+    }
+
+    // A thread that never allocated has nothing to give back, and shouldn't take a cache now.
+    memory_thread_cache* cache = current_session == atomic_load(&active_session) ? current_cache : 0;
+    if (cache) {
+        for (UInt32 i = 0; i < MEMORY_CACHE_CLASS_COUNT; ++i) {
+            if (cache->bins[i].count > 0) {
+                cache_drain(cache, i, 0);
+            }
+        }
+
+        // Give the slot up; this thread takes one again the next time it allocates.
+        current_cache = 0;
+        current_session = 0;
+        atomic_store_explicit(&cache->released, TRUE, memory_order_release);
+    }
+}
+
+UInt32 memory_thread_cache_count() {
+    if (!state_ptr) {
+        return 0;
+    }
+
+    UInt32 count = atomic_load_explicit(&state_ptr->thread_cache_count, memory_order_acquire);
+    UInt32 held = 0;
+    for (UInt32 i = 0; i < count && i < MEMORY_MAX_THREAD_CACHES; ++i) {
+        held += !atomic_load_explicit(&state_ptr->thread_caches[i].cache.released, memory_order_relaxed);
+    }
+    return held;
+}
+
+void memory_set_thread_caches_enabled(Boolean enabled) {
+    if (state_ptr) {
+        atomic_store(&state_ptr->thread_caches_enabled, enabled);
+    }
+}
+
+Boolean memory_set_tag_budget(memory_tag tag, UInt64 soft_limit, UInt64 hard_limit) {
+    if (!state_ptr || tag >= MEMORY_TAG_MAX_TAGS) {
+        return FALSE;
+    }
+    if (soft_limit && hard_limit && soft_limit > hard_limit) {
+        KERROR("memory_set_tag_budget - soft limit of %llu bytes for %s is over its hard limit of %llu.",
+               soft_limit, memory_tag_strings[tag], hard_limit);
+        return FALSE;
+    }
+
+    memory_budget* budget = &state_ptr->budgets[tag];
+    atomic_store(&budget->soft_limit, soft_limit);
+    atomic_store(&budget->hard_limit, hard_limit);
+    // A lowered limit may already be crossed; the next allocation will say so.
+    atomic_store(&budget->under_pressure, FALSE);
+    return TRUE;
+}
+
+void memory_set_budget_exceeded_handler(PFN_memory_budget_exceeded handler) {
+    if (state_ptr) {
+        atomic_store(&state_ptr->on_budget_exceeded, handler);
+    }
 }
 
 void* kzero_memory(void* block, UInt64 size) {
@@ -96,47 +673,85 @@ void* kset_memory(void* dest, UInt32 value, UInt64 size) {
     return platform_set_memory(dest, value, size);
 }
 
-char* get_memory_usage_str() {
-    const UInt64 GiB = 1024 * 1024 * 1024;
-    const UInt64 MiB = 1024 * 1024;
-    const UInt64 KiB = 1024;
-    
-    char buffer[8000] = "System memory used (tagged):\n";
-    UInt64 offset = strlen(buffer);
-
-    for (UInt32 i = 0; i < MEMORY_TAG_MAX_TAGS; ++i) {
-        char unit[4] = "XiB";
-        Single amount;
-        
-        if (state_ptr->stats.tagged_allocations[i] >= GiB) {
-            unit[0] = 'G';
-            amount = state_ptr->stats.tagged_allocations[i] / (Single)GiB;
-        }
-        else if (state_ptr->stats.tagged_allocations[i] >= MiB) {
-            unit[0] = 'M';
-            amount = state_ptr->stats.tagged_allocations[i] / (Single)MiB;
-        }
-        else if (state_ptr->stats.tagged_allocations[i] >= KiB) {
-            unit[0] = 'K';
-            amount = state_ptr->stats.tagged_allocations[i] / (Single)KiB;
-        }
-        else {
-            unit[0] = 'B';
-            unit[1] = 0;
-            amount = (Single)state_ptr->stats.tagged_allocations[i];
-        }
+const char* memory_tag_name(memory_tag tag) {
+    if (tag >= MEMORY_TAG_MAX_TAGS) {
+        return "INVALID     ";
+    }
+    return memory_tag_strings[tag];
+}
+
+Boolean memory_get_tag_stats(memory_tag tag, memory_stats_snapshot* out_stats) {
+    if (!state_ptr || tag >= MEMORY_TAG_MAX_TAGS || !out_stats) {
+        return FALSE;
+    }
 
-        Int32 length = snprintf(buffer + offset, 8000, "  %s: %.2f%s\n", memory_tag_strings[i], amount, unit);
+    stats_collect(&state_ptr->stats.tagged[tag], tag, out_stats);
+    return TRUE;
+}
+
+Boolean memory_get_total_stats(memory_stats_snapshot* out_stats) {
+    if (!state_ptr || !out_stats) {
+        return FALSE;
+    }
+
+    stats_collect(&state_ptr->stats.total, -1, out_stats);
+    return TRUE;
+}
+
+static void format_size(UInt64 bytes, Single* out_amount, const char** out_unit) {
+    if (bytes >= GIBIBYTES(1)) {
+        *out_unit = "GiB";
+        *out_amount = bytes / (Single)GIBIBYTES(1);
+    }
+    else if (bytes >= MEBIBYTES(1)) {
+        *out_unit = "MiB";
+        *out_amount = bytes / (Single)MEBIBYTES(1);
+    }
+    else if (bytes >= KIBIBYTES(1)) {
+        *out_unit = "KiB";
+        *out_amount = bytes / (Single)KIBIBYTES(1);
+    }
+    else {
+        *out_unit = "B";
+        *out_amount = (Single)bytes;
+    }
+}
+
+UInt64 memory_usage_report(char* buffer, UInt64 buffer_size) {
+    if (!buffer || buffer_size == 0) {
+        return 0;
+    }
+
+    Int32 length = snprintf(buffer, buffer_size, "System memory used (tagged):\n");
+    UInt64 offset = length > 0 ? (UInt64)length : 0;
+
+    for (UInt32 i = 0; i < MEMORY_TAG_MAX_TAGS && offset < buffer_size; ++i) {
+        memory_stats_snapshot stats = {};
+        memory_get_tag_stats(i, &stats);
+
+        Single current_amount, peak_amount;
+        const char* current_unit;
+        const char* peak_unit;
+        format_size(stats.current, &current_amount, &current_unit);
+        format_size(stats.peak, &peak_amount, &peak_unit);
+
+        length = snprintf(buffer + offset, buffer_size - offset, "  %s: %.2f%s (peak %.2f%s, %llu allocs, %llu frees)\n",
+                          memory_tag_strings[i], current_amount, current_unit, peak_amount, peak_unit,
+                          stats.allocation_count, stats.free_count);
+        if (length < 0) {
+            break;
+        }
         offset += length;
     }
-    
-    char* out_string = _strdup(buffer);
-    return out_string;
+
+    // On truncation snprintf has already terminated the buffer.
+    return offset < buffer_size ? offset : buffer_size - 1;
 }
 
 UInt64 get_memory_alloc_count() {
-    if (state_ptr) {
-        return state_ptr->alloc_count;
+    memory_stats_snapshot stats;
+    if (memory_get_total_stats(&stats)) {
+        return stats.allocation_count;
     }
     return 0;
 }
\ No newline at end of file
@@ -2,6 +2,12 @@
 
 #include "defines.h"
 
+// Define as 0 to stop kallocate call sites passing their file and line to the allocation
+// profiler. Without them, every allocation is reported as coming from an unknown callsite.
+#ifndef KMEMORY_CALLSITES_ENABLED
+    #define KMEMORY_CALLSITES_ENABLED 1
+#endif
+
 typedef enum memory_tag
 {
     // Temporary only. Always assign a proper tag.
@@ -24,23 +30,88 @@ typedef enum memory_tag
     MEMORY_TAG_ENTITY,
     MEMORY_TAG_ENTITY_NODE,
     MEMORY_TAG_SCENE,
+    MEMORY_TAG_FREELIST,
     
     MEMORY_TAG_MAX_TAGS
 } memory_tag;
 
-KAPI void memory_system_initialize(UInt64* memory_requirement, void* state);
+// total_allocation_size is the size of the heap that kallocate/kfree are served from.
+KAPI void memory_system_initialize(UInt64* memory_requirement, void* state, UInt64 total_allocation_size);
 KAPI void memory_system_shutdown(void* state);
 
 KAPI void* kallocate(UInt64 size, memory_tag tag);
 
 KAPI void kfree(void* block, UInt64 size, memory_tag tag);
 
+// alignment must be a power of two. Blocks must be released with kfree_aligned using the
+// same size and alignment.
+KAPI void* kallocate_aligned(UInt64 size, UInt16 alignment, memory_tag tag);
+
+KAPI void kfree_aligned(void* block, UInt64 size, UInt16 alignment, memory_tag tag);
+
+// kallocate_aligned, recording file and line as the callsite when the allocation profiler is on.
+KAPI void* kallocate_aligned_at(UInt64 size, UInt16 alignment, memory_tag tag, const char* file, UInt32 line);
+
+#if KMEMORY_CALLSITES_ENABLED == 1
+    #define kallocate(size, tag) kallocate_aligned_at((size), 1, (tag), __FILE__, __LINE__)
+    #define kallocate_aligned(size, alignment, tag) kallocate_aligned_at((size), (alignment), (tag), __FILE__, __LINE__)
+#endif
+
+// Returns the free blocks the calling thread's cache is holding to the heap and gives up its
+// cache for another thread to take. Threads should call it before they exit, or their cached
+// blocks stay out of reach. Only 32 threads can hold a cache at once; the rest go through the
+// shared heap lock and counters.
+KAPI void memory_thread_cache_flush();
+
+// Number of threads holding a cache right now.
+KAPI UInt32 memory_thread_cache_count();
+
+// Thread caches are on by default. With them off every call goes through the shared heap
+// lock and counters; blocks already cached stay where they are until flushed.
+KAPI void memory_set_thread_caches_enabled(Boolean enabled);
+
+// Called when an allocation would take a tag past its hard budget. The default logs a usage
+// report and aborts; if a replacement returns, the allocation fails and kallocate returns 0.
+typedef void (*PFN_memory_budget_exceeded)(memory_tag tag, UInt64 size, UInt64 current, UInt64 hard_limit);
+
+// Budgets are per tag and off by default; 0 leaves that limit unset. Crossing the soft limit
+// posts EVENT_CODE_MEMORY_PRESSURE once, and again only after the tag has dropped back below it.
+// The limits are checked before each allocation, so threads allocating the same tag at once
+// can overshoot them by what they have in flight.
+KAPI Boolean memory_set_tag_budget(memory_tag tag, UInt64 soft_limit, UInt64 hard_limit);
+
+typedef struct memory_tag_budget {
+    memory_tag tag;
+    UInt64 soft_limit;
+    UInt64 hard_limit;
+} memory_tag_budget;
+
+// 0 restores the default handler.
+KAPI void memory_set_budget_exceeded_handler(PFN_memory_budget_exceeded handler);
+
 KAPI void* kzero_memory(void* block, UInt64 size);
 
 KAPI void* kcopy_memory(void* dest, const void* source, UInt64 size);
 
 KAPI void* kset_memory(void* dest, UInt32 value, UInt64 size);
 
-KAPI char* get_memory_usage_str();
+typedef struct memory_stats_snapshot {
+    // Bytes currently allocated.
+    UInt64 current;
+    // Highest value current has reached.
+    UInt64 peak;
+    UInt64 allocation_count;
+    UInt64 free_count;
+} memory_stats_snapshot;
+
+KAPI const char* memory_tag_name(memory_tag tag);
+
+KAPI Boolean memory_get_tag_stats(memory_tag tag, memory_stats_snapshot* out_stats);
+
+KAPI Boolean memory_get_total_stats(memory_stats_snapshot* out_stats);
+
+// Writes a per-tag usage report into buffer without allocating. Returns the number of
+// characters written, excluding the terminator; the report is truncated to fit.
+KAPI UInt64 memory_usage_report(char* buffer, UInt64 buffer_size);
 
 KAPI UInt64 get_memory_alloc_count();
\ No newline at end of file
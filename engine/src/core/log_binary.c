@@ -0,0 +1,371 @@
+#include "core/log_binary.h"
+
+#include "core/kmemory.h"
+#include "core/kstring.h"
+#include "platform/filesystem.h"
+
+#include <stdio.h>
+
+typedef enum log_arg_kind {
+    LOG_ARG_NONE,
+    LOG_ARG_INT,
+    LOG_ARG_LONG,
+    LOG_ARG_INT64,
+    LOG_ARG_DOUBLE,
+    LOG_ARG_POINTER,
+    LOG_ARG_STRING,
+    LOG_ARG_UNSUPPORTED
+} log_arg_kind;
+
+static const char* level_prefixes[6] = { "[FATAL]: ", "[ERROR]: ", "[WARN]: ", "[INFO]: ", "[DEBUG]: ", "[TRACE]: " };
+
+static Boolean is_digit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+// Scans the conversion starting at spec[0] == '%' and returns its length.
+static UInt32 scan_conversion(const char* spec, log_arg_kind* out_kind) {
+    const char* c = spec + 1;
+    if (*c == '%') {
+        *out_kind = LOG_ARG_NONE;
+        return 2;
+    }
+
+    while (*c == '-' || *c == '+' || *c == ' ' || *c == '#' || *c == '0') {
+        c++;
+    }
+    if (*c == '*') {
+        *out_kind = LOG_ARG_UNSUPPORTED;
+        return (UInt32)(c - spec);
+    }
+    while (is_digit(*c)) {
+        c++;
+    }
+    if (*c == '.') {
+        c++;
+        if (*c == '*') {
+            *out_kind = LOG_ARG_UNSUPPORTED;
+            return (UInt32)(c - spec);
+        }
+        while (is_digit(*c)) {
+            c++;
+        }
+    }
+
+    // hh and h arguments are promoted to int, so they read the same as no modifier.
+    log_arg_kind integer_kind = LOG_ARG_INT;
+    Boolean long_double = FALSE;
+    if (*c == 'h') {
+        c += c[1] == 'h' ? 2 : 1;
+    } else if (*c == 'l') {
+        if (c[1] == 'l') {
+            integer_kind = LOG_ARG_INT64;
+            c += 2;
+        } else {
+            integer_kind = LOG_ARG_LONG;
+            c++;
+        }
+    } else if (*c == 'z' || *c == 'j' || *c == 't') {
+        integer_kind = LOG_ARG_INT64;
+        c++;
+    } else if (*c == 'L') {
+        long_double = TRUE;
+        c++;
+    }
+
+    switch (*c) {
+        case 'd': case 'i': case 'u': case 'o': case 'x': case 'X': case 'c':
+            *out_kind = integer_kind;
+            break;
+        case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+            *out_kind = long_double ? LOG_ARG_UNSUPPORTED : LOG_ARG_DOUBLE;
+            break;
+        case 's':
+            *out_kind = integer_kind == LOG_ARG_INT ? LOG_ARG_STRING : LOG_ARG_UNSUPPORTED;
+            break;
+        case 'p':
+            *out_kind = LOG_ARG_POINTER;
+            break;
+        default:
+            *out_kind = LOG_ARG_UNSUPPORTED;
+            return *c ? (UInt32)(c - spec + 1) : (UInt32)(c - spec);
+    }
+
+    return (UInt32)(c - spec + 1);
+}
+
+Boolean log_binary_parse_format(const char* format, UInt8* out_kinds, UInt8* out_count) {
+    UInt8 count = 0;
+    for (const char* c = format; *c;) {
+        if (*c != '%') {
+            c++;
+            continue;
+        }
+
+        log_arg_kind kind;
+        c += scan_conversion(c, &kind);
+        if (kind == LOG_ARG_UNSUPPORTED || (kind != LOG_ARG_NONE && count == LOG_SITE_MAX_ARGS)) {
+            return FALSE;
+        }
+        if (kind != LOG_ARG_NONE) {
+            out_kinds[count++] = (UInt8)kind;
+        }
+    }
+
+    *out_count = count;
+    return TRUE;
+}
+
+Boolean log_binary_pack(const log_site* site, va_list args, UInt8* buffer, UInt64 buffer_size, UInt64* out_length) {
+    // Every non-string argument takes at most 8 bytes, which the caller's buffer always has room for.
+    UInt64 offset = 0;
+    for (UInt8 i = 0; i < site->arg_count; ++i) {
+        switch (site->arg_kinds[i]) {
+            case LOG_ARG_INT: {
+                Int32 value = va_arg(args, Int32);
+                kcopy_memory(buffer + offset, &value, sizeof(value));
+                offset += sizeof(value);
+            } break;
+            case LOG_ARG_LONG: {
+                Int64 value = va_arg(args, long);
+                kcopy_memory(buffer + offset, &value, sizeof(value));
+                offset += sizeof(value);
+            } break;
+            case LOG_ARG_INT64: {
+                Int64 value = va_arg(args, Int64);
+                kcopy_memory(buffer + offset, &value, sizeof(value));
+                offset += sizeof(value);
+            } break;
+            case LOG_ARG_DOUBLE: {
+                Double value = va_arg(args, Double);
+                kcopy_memory(buffer + offset, &value, sizeof(value));
+                offset += sizeof(value);
+            } break;
+            case LOG_ARG_POINTER: {
+                void* value = va_arg(args, void*);
+                kcopy_memory(buffer + offset, &value, sizeof(value));
+                offset += sizeof(value);
+            } break;
+            case LOG_ARG_STRING: {
+                // Strings are copied, since the caller's buffer may be gone by the time this is formatted.
+                const char* value = va_arg(args, const char*);
+                if (!value) {
+                    value = "(null)";
+                }
+                UInt64 length = string_length(value) + 1;
+                UInt64 fixed_remaining = (site->arg_count - i - 1) * sizeof(Int64);
+                if (offset + sizeof(UInt16) + length + fixed_remaining > buffer_size) {
+                    return FALSE;
+                }
+                UInt16 stored = (UInt16)length;
+                kcopy_memory(buffer + offset, &stored, sizeof(stored));
+                kcopy_memory(buffer + offset + sizeof(stored), value, length);
+                offset += sizeof(stored) + length;
+            } break;
+        }
+    }
+
+    *out_length = offset;
+    return TRUE;
+}
+
+UInt64 log_binary_format(const char* format, log_level level, const UInt8* args, UInt64 arg_length, char* out_text, UInt64 out_size) {
+    UInt64 length = 0;
+    UInt64 limit = out_size - 2;
+    UInt64 offset = 0;
+
+    for (const char* p = level_prefixes[level]; *p && length < limit; ++p) {
+        out_text[length++] = *p;
+    }
+
+    for (const char* c = format; *c && length < limit;) {
+        if (*c != '%') {
+            out_text[length++] = *c++;
+            continue;
+        }
+
+        log_arg_kind kind;
+        UInt32 spec_length = scan_conversion(c, &kind);
+        char spec[32];
+        if (kind == LOG_ARG_NONE || spec_length >= sizeof(spec)) {
+            out_text[length++] = '%';
+            c += spec_length;
+            continue;
+        }
+        kcopy_memory(spec, c, spec_length);
+        spec[spec_length] = 0;
+        c += spec_length;
+
+        Int32 written = 0;
+        UInt64 remaining = limit - length + 1;
+        switch (kind) {
+            case LOG_ARG_INT: {
+                Int32 value = 0;
+                if (offset + sizeof(value) <= arg_length) {
+                    kcopy_memory(&value, args + offset, sizeof(value));
+                }
+                offset += sizeof(value);
+                written = snprintf(out_text + length, remaining, spec, value);
+            } break;
+            case LOG_ARG_LONG: {
+                Int64 value = 0;
+                if (offset + sizeof(value) <= arg_length) {
+                    kcopy_memory(&value, args + offset, sizeof(value));
+                }
+                offset += sizeof(value);
+                written = snprintf(out_text + length, remaining, spec, (long)value);
+            } break;
+            case LOG_ARG_INT64: {
+                Int64 value = 0;
+                if (offset + sizeof(value) <= arg_length) {
+                    kcopy_memory(&value, args + offset, sizeof(value));
+                }
+                offset += sizeof(value);
+                written = snprintf(out_text + length, remaining, spec, value);
+            } break;
+            case LOG_ARG_DOUBLE: {
+                Double value = 0;
+                if (offset + sizeof(value) <= arg_length) {
+                    kcopy_memory(&value, args + offset, sizeof(value));
+                }
+                offset += sizeof(value);
+                written = snprintf(out_text + length, remaining, spec, value);
+            } break;
+            case LOG_ARG_POINTER: {
+                void* value = 0;
+                if (offset + sizeof(value) <= arg_length) {
+                    kcopy_memory(&value, args + offset, sizeof(value));
+                }
+                offset += sizeof(value);
+                written = snprintf(out_text + length, remaining, spec, value);
+            } break;
+            case LOG_ARG_STRING: {
+                UInt16 stored = 0;
+                const char* value = "";
+                if (offset + sizeof(stored) <= arg_length) {
+                    kcopy_memory(&stored, args + offset, sizeof(stored));
+                    if (offset + sizeof(stored) + stored <= arg_length) {
+                        value = (const char*)args + offset + sizeof(stored);
+                    }
+                }
+                offset += sizeof(stored) + stored;
+                written = snprintf(out_text + length, remaining, spec, value);
+            } break;
+            default:
+                break;
+        }
+
+        if (written > 0) {
+            length += (UInt64)written < remaining ? (UInt64)written : remaining - 1;
+        }
+    }
+
+    out_text[length++] = '\n';
+    out_text[length] = 0;
+    return length;
+}
+
+static Boolean read_bytes(const UInt8* data, UInt64 size, UInt64* offset, void* out, UInt64 count) {
+    if (*offset + count > size) {
+        return FALSE;
+    }
+    kcopy_memory(out, data + *offset, count);
+    *offset += count;
+    return TRUE;
+}
+
+Boolean log_decode_binary_file(const char* binary_path, const char* text_path) {
+    file_handle input;
+    if (!filesystem_open(binary_path, FILE_MODE_READ, TRUE, &input)) {
+        return FALSE;
+    }
+
+    UInt8* data = 0;
+    UInt64 size = 0;
+    Boolean read = filesystem_read_all_bytes(&input, &data, &size);
+    filesystem_close(&input);
+    Boolean valid = read && size >= LOG_BINARY_MAGIC_LENGTH;
+    for (UInt32 i = 0; valid && i < LOG_BINARY_MAGIC_LENGTH; ++i) {
+        valid = data[i] == (UInt8)LOG_BINARY_MAGIC[i];
+    }
+    if (!valid) {
+        KERROR("log_decode_binary_file - '%s' is not a binary log.", binary_path);
+        if (data) {
+            kfree(data, size, MEMORY_TAG_STRING);
+        }
+        return FALSE;
+    }
+
+    file_handle output;
+    if (!filesystem_open(text_path, FILE_MODE_WRITE, FALSE, &output)) {
+        kfree(data, size, MEMORY_TAG_STRING);
+        return FALSE;
+    }
+
+    // Site ids are small and dense, so a flat table indexed by id is enough.
+    const char** formats = kallocate(sizeof(const char*) * LOG_MAX_SITES, MEMORY_TAG_ARRAY);
+    UInt8* levels = kallocate(LOG_MAX_SITES, MEMORY_TAG_ARRAY);
+    char line[LOG_BINARY_LINE_MAX_LENGTH];
+    Boolean success = TRUE;
+
+    UInt64 offset = LOG_BINARY_MAGIC_LENGTH;
+    while (offset < size && success) {
+        UInt8 type = data[offset++];
+        UInt32 id;
+        UInt8 level;
+        UInt16 length;
+        UInt64 line_length = 0;
+
+        switch (type) {
+            case LOG_RECORD_SITE:
+                success = read_bytes(data, size, &offset, &id, sizeof(id)) &&
+                          read_bytes(data, size, &offset, &level, sizeof(level)) &&
+                          read_bytes(data, size, &offset, &length, sizeof(length)) &&
+                          offset + length <= size && id < LOG_MAX_SITES && level <= LOG_LEVEL_TRACE &&
+                          length > 0 && data[offset + length - 1] == 0;
+                if (success) {
+                    formats[id] = (const char*)data + offset;
+                    levels[id] = level;
+                    offset += length;
+                }
+                break;
+            case LOG_RECORD_MESSAGE:
+                success = read_bytes(data, size, &offset, &id, sizeof(id)) &&
+                          read_bytes(data, size, &offset, &length, sizeof(length)) &&
+                          offset + length <= size && id < LOG_MAX_SITES && formats[id];
+                if (success) {
+                    line_length = log_binary_format(formats[id], levels[id], data + offset, length, line, sizeof(line));
+                    offset += length;
+                }
+                break;
+            case LOG_RECORD_TEXT:
+                success = read_bytes(data, size, &offset, &level, sizeof(level)) &&
+                          read_bytes(data, size, &offset, &length, sizeof(length)) &&
+                          offset + length <= size && length < sizeof(line);
+                if (success) {
+                    kcopy_memory(line, data + offset, length);
+                    line_length = length;
+                    offset += length;
+                }
+                break;
+            default:
+                success = FALSE;
+                break;
+        }
+
+        UInt64 written = 0;
+        if (success && line_length > 0 && !filesystem_write(&output, line_length, line, &written)) {
+            success = FALSE;
+        }
+    }
+
+    if (!success) {
+        KERROR("log_decode_binary_file - '%s' is corrupt near byte %llu.", binary_path, offset);
+    }
+
+    kfree(levels, LOG_MAX_SITES, MEMORY_TAG_ARRAY);
+    kfree(formats, sizeof(const char*) * LOG_MAX_SITES, MEMORY_TAG_ARRAY);
+    kfree(data, size, MEMORY_TAG_STRING);
+    filesystem_close(&output);
+    return success;
+}
\ No newline at end of file
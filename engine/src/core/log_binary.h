@@ -0,0 +1,33 @@
+#pragma once
+
+#include "defines.h"
+#include "core/logger.h"
+
+#include <stdarg.h>
+
+// Layout of the binary log written by log_set_binary_output. All integers are little-endian
+// and unaligned. After the magic, the file is a sequence of records, each starting with a type byte:
+//   LOG_RECORD_SITE:    u32 site id, u8 level, u16 format length (with terminator), format
+//   LOG_RECORD_MESSAGE: u32 site id, u16 argument bytes, packed arguments
+//   LOG_RECORD_TEXT:    u8 level, u16 text length, already formatted text
+// A site record always precedes the first message that refers to it.
+#define LOG_BINARY_MAGIC "KLOGBIN1"
+#define LOG_BINARY_MAGIC_LENGTH 8
+
+typedef enum log_record_type {
+    LOG_RECORD_SITE = 1,
+    LOG_RECORD_MESSAGE = 2,
+    LOG_RECORD_TEXT = 3
+} log_record_type;
+
+// Reads the argument kinds out of format. Fails if the format uses something that cannot be
+// deferred, such as '*' widths, %n or long double.
+Boolean log_binary_parse_format(const char* format, UInt8* out_kinds, UInt8* out_count);
+
+// Copies the arguments described by site into buffer. Fails if they do not fit, in which case
+// the message should be formatted immediately instead.
+Boolean log_binary_pack(const log_site* site, va_list args, UInt8* buffer, UInt64 buffer_size, UInt64* out_length);
+
+// Formats packed arguments as a complete line, with the level prefix and a trailing newline.
+// Returns the length written, not counting the terminator.
+UInt64 log_binary_format(const char* format, log_level level, const UInt8* args, UInt64 arg_length, char* out_text, UInt64 out_size);
\ No newline at end of file
@@ -2,77 +2,561 @@
 #include "asserts.h"
 #include "platform/platform.h"
 #include "platform/filesystem.h"
+#include "containers/ring_queue.h"
 #include "core/kstring.h"
 #include "core/kmemory.h"
+#include "core/log_binary.h"
 
 #include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+// Longer messages bypass the queue and are written synchronously, after a flush.
+#define LOG_MESSAGE_MAX_LENGTH 500
+#define LOG_FILE_BATCH_SIZE (64 * 1024)
+
+#define LOG_SITE_ID_REGISTERING 0xFFFFFFFE
+
+typedef struct log_message {
+    UInt8 level;
+    UInt16 length;
+    // 0 for preformatted text; otherwise text holds the site's packed arguments.
+    UInt32 site_id;
+    char text[LOG_MESSAGE_MAX_LENGTH];
+} log_message;
 
 typedef struct logger_system_state {
     file_handle log_file_handle;
+    file_handle binary_file_handle;
+    // Held by the writer while it writes a burst, and by anyone else touching the files.
+    kmutex output_mutex;
+    Boolean site_written[LOG_MAX_SITES];
+
+    ring_queue queue;
+    kthread writer_thread;
+    _Atomic UInt64 writer_thread_id;
+    ksemaphore wake_writer;
+    atomic_bool running;
+    atomic_bool writer_sleeping;
+    atomic_bool console_enabled;
+
+    _Atomic UInt64 queued_count;
+    _Atomic UInt64 written_count;
+    _Atomic UInt64 dropped_count;
+
+    UInt64 batch_length;
+    char batch[LOG_FILE_BATCH_SIZE];
 } logger_system_state;
 
 static logger_system_state* state_ptr;
 
-void append_to_log_file(const char* message) {
-    if (state_ptr && state_ptr->log_file_handle.is_valid) {
-        UInt64 length = string_length(message);
+// Call sites are static objects that outlive any one logger session, so their registry does too.
+static log_site* registered_sites[LOG_MAX_SITES];
+static _Atomic UInt32 registered_site_count;
+
+_Atomic UInt8 log_category_levels[LOG_CATEGORY_MAX] = {
+    LOG_LEVEL_TRACE, LOG_LEVEL_TRACE, LOG_LEVEL_TRACE, LOG_LEVEL_TRACE, LOG_LEVEL_TRACE, LOG_LEVEL_TRACE
+};
+
+static const char* category_names[LOG_CATEGORY_MAX] = { "general", "renderer", "vulkan", "memory", "input", "game" };
+static const char* level_names[6] = { "fatal", "error", "warn", "info", "debug", "trace" };
+
+static const char* level_strings[6] = { "[FATAL]: ", "[ERROR]: ", "[WARN]: ", "[INFO]: ", "[DEBUG]: ", "[TRACE]: " };
+
+static void write_console(const char* message, log_level level) {
+    if (state_ptr && !atomic_load_explicit(&state_ptr->console_enabled, memory_order_relaxed)) {
+        return;
+    }
+
+    if (level < LOG_LEVEL_WARN)
+        platform_console_write_error(message, level);
+    else
+        platform_console_write(message, level);
+}
+
+static file_handle* output_file() {
+    return state_ptr->binary_file_handle.is_valid ? &state_ptr->binary_file_handle : &state_ptr->log_file_handle;
+}
+
+// The functions below require output_mutex, or that the writer has stopped.
+static void flush_file_batch() {
+    if (state_ptr->batch_length == 0) {
+        return;
+    }
+
+    file_handle* file = output_file();
+    if (file->is_valid) {
         UInt64 written = 0;
-        if (!filesystem_write(&state_ptr->log_file_handle, length, message, &written)) {
-            platform_console_write_error("ERROR: Could not write to console.log.", LOG_LEVEL_ERROR);
+        if (!filesystem_write(file, state_ptr->batch_length, state_ptr->batch, &written)) {
+            platform_console_write_error("ERROR: Could not write to the log file.", LOG_LEVEL_ERROR);
+        }
+    }
+    state_ptr->batch_length = 0;
+}
+
+static void append_to_batch(const void* data, UInt64 length) {
+    if (state_ptr->batch_length + length > LOG_FILE_BATCH_SIZE) {
+        flush_file_batch();
+    }
+
+    kcopy_memory(state_ptr->batch + state_ptr->batch_length, data, length);
+    state_ptr->batch_length += length;
+}
+
+static void append_text_to_file(const char* text, UInt64 length, log_level level) {
+    if (!state_ptr->binary_file_handle.is_valid) {
+        append_to_batch(text, length);
+        return;
+    }
+
+    UInt8 header[4] = {LOG_RECORD_TEXT, (UInt8)level};
+    UInt16 stored = (UInt16)length;
+    kcopy_memory(header + 2, &stored, sizeof(stored));
+    append_to_batch(header, sizeof(header));
+    append_to_batch(text, stored);
+}
+
+static void append_binary_to_file(const log_site* site, UInt32 site_id, const log_message* message) {
+    if (!state_ptr->site_written[site_id]) {
+        UInt8 header[8] = {LOG_RECORD_SITE};
+        UInt16 format_length = (UInt16)(string_length(site->format) + 1);
+        kcopy_memory(header + 1, &site_id, sizeof(site_id));
+        header[5] = (UInt8)site->level;
+        kcopy_memory(header + 6, &format_length, sizeof(format_length));
+        append_to_batch(header, sizeof(header));
+        append_to_batch(site->format, format_length);
+        state_ptr->site_written[site_id] = TRUE;
+    }
+
+    UInt8 header[7] = {LOG_RECORD_MESSAGE};
+    kcopy_memory(header + 1, &site_id, sizeof(site_id));
+    kcopy_memory(header + 5, &message->length, sizeof(message->length));
+    append_to_batch(header, sizeof(header));
+    append_to_batch(message->text, message->length);
+}
+
+static void write_message(const log_message* message) {
+    if (message->site_id == 0) {
+        write_console(message->text, message->level);
+        append_text_to_file(message->text, message->length, message->level);
+        return;
+    }
+
+    const log_site* site = registered_sites[message->site_id];
+    Boolean binary_file = state_ptr->binary_file_handle.is_valid;
+    Boolean console = atomic_load_explicit(&state_ptr->console_enabled, memory_order_relaxed);
+    if (binary_file) {
+        append_binary_to_file(site, message->site_id, message);
+    }
+
+    // With a binary log and no console, nothing is ever formatted online.
+    if (console || !binary_file) {
+        char line[LOG_BINARY_LINE_MAX_LENGTH];
+        UInt64 length = log_binary_format(site->format, site->level, (const UInt8*)message->text, message->length, line, sizeof(line));
+        write_console(line, site->level);
+        if (!binary_file) {
+            append_to_batch(line, length);
         }
     }
 }
 
+// For messages written outside the writer thread.
+static void write_file_direct(const char* message, log_level level) {
+    if (state_ptr) {
+        platform_mutex_lock(&state_ptr->output_mutex);
+        append_text_to_file(message, string_length(message), level);
+        flush_file_batch();
+        platform_mutex_unlock(&state_ptr->output_mutex);
+    }
+}
+
+static UInt32 log_writer_thread_run(void* params) {
+    atomic_store(&state_ptr->writer_thread_id, platform_current_thread_id());
+
+    log_message message;
+    for (;;) {
+        UInt32 batch_count = 0;
+        platform_mutex_lock(&state_ptr->output_mutex);
+        while (ring_queue_dequeue(&state_ptr->queue, &message)) {
+            write_message(&message);
+            batch_count++;
+            atomic_fetch_add_explicit(&state_ptr->written_count, 1, memory_order_release);
+        }
+        // One write per burst of messages instead of one per message.
+        flush_file_batch();
+        platform_mutex_unlock(&state_ptr->output_mutex);
+
+        if (batch_count > 0) {
+            continue;
+        }
+
+        if (!atomic_load_explicit(&state_ptr->running, memory_order_acquire)) {
+            break;
+        }
+
+        // Producers only pay for a signal when the writer has actually gone to sleep.
+        atomic_store(&state_ptr->writer_sleeping, TRUE);
+        atomic_thread_fence(memory_order_seq_cst);
+        if (ring_queue_count(&state_ptr->queue) == 0 && atomic_load(&state_ptr->running)) {
+            platform_semaphore_wait(&state_ptr->wake_writer, 100);
+        }
+        atomic_store(&state_ptr->writer_sleeping, FALSE);
+    }
+
+    return 0;
+}
+
+static Boolean on_writer_thread() {
+    return platform_current_thread_id() == atomic_load_explicit(&state_ptr->writer_thread_id, memory_order_relaxed);
+}
+
+static void wake_writer() {
+    // Pairs with the fence in the writer, so either it sees the new message or we see it asleep.
+    atomic_thread_fence(memory_order_seq_cst);
+    if (atomic_load_explicit(&state_ptr->writer_sleeping, memory_order_relaxed) &&
+        atomic_exchange(&state_ptr->writer_sleeping, FALSE)) {
+        platform_semaphore_signal(&state_ptr->wake_writer);
+    }
+}
+
 Boolean initialize_logging(UInt64* memory_requirement, void* state) {
-    *memory_requirement = sizeof(logger_system_state);
+    UInt64 queue_requirement = ring_queue_memory_requirement(RING_QUEUE_MODE_MPMC, sizeof(log_message), LOG_QUEUE_CAPACITY);
+    *memory_requirement = sizeof(logger_system_state) + queue_requirement;
 
     if (state == 0) {
         return TRUE;
     }
 
-    state_ptr = state;
+    kzero_memory(state, sizeof(logger_system_state));
+    logger_system_state* new_state = state;
 
-    if (!filesystem_open("console.log", FILE_MODE_WRITE, FALSE, &state_ptr->log_file_handle)) {
+    if (!filesystem_open("console.log", FILE_MODE_WRITE, FALSE, &new_state->log_file_handle)) {
         platform_console_write_error("ERROR: Unable to open console.log for writing.", LOG_LEVEL_ERROR);
         return FALSE;
     }
 
-    // KFATAL("Test fatal message");
-    // KERROR("Test error message");
-    // KWARN("Test warning message");
-    // KINFO("Test info message");
-    // KDEBUG("Test debug message");
-    // KTRACE("Test trace message");
+    ring_queue_create(RING_QUEUE_MODE_MPMC, sizeof(log_message), LOG_QUEUE_CAPACITY, new_state + 1, &new_state->queue);
+    atomic_init(&new_state->console_enabled, TRUE);
+    atomic_init(&new_state->running, TRUE);
+    if (!platform_semaphore_create(&new_state->wake_writer, 1, 0) || !platform_mutex_create(&new_state->output_mutex)) {
+        filesystem_close(&new_state->log_file_handle);
+        return FALSE;
+    }
+
+    state_ptr = new_state;
+
+    const char* levels = getenv("KOHI_LOG_LEVELS");
+    if (levels && !log_set_levels(levels)) {
+        platform_console_write_error("WARNING: KOHI_LOG_LEVELS could not be fully applied.\n", LOG_LEVEL_WARN);
+    }
+
+    if (!platform_thread_create(log_writer_thread_run, 0, &state_ptr->writer_thread)) {
+        state_ptr = 0;
+        platform_mutex_destroy(&new_state->output_mutex);
+        platform_semaphore_destroy(&new_state->wake_writer);
+        filesystem_close(&new_state->log_file_handle);
+        platform_console_write_error("ERROR: Unable to start the log writer thread.", LOG_LEVEL_ERROR);
+        return FALSE;
+    }
 
     return TRUE;
 }
 
 void shutdown_logging(void* state) {
+    if (!state_ptr) {
+        return;
+    }
+
+    // The writer drains the queue before it exits.
+    atomic_store(&state_ptr->running, FALSE);
+    platform_semaphore_signal(&state_ptr->wake_writer);
+    platform_thread_destroy(&state_ptr->writer_thread);
+
+    UInt64 dropped = atomic_load(&state_ptr->dropped_count);
+    if (dropped > 0) {
+        char message[128];
+        string_format(message, "[WARN]: Logger dropped %llu message(s) because its queue was full.\n", dropped);
+        write_console(message, LOG_LEVEL_WARN);
+        append_text_to_file(message, string_length(message), LOG_LEVEL_WARN);
+    }
+
+    flush_file_batch();
+    filesystem_close(&state_ptr->binary_file_handle);
+    filesystem_close(&state_ptr->log_file_handle);
+    platform_mutex_destroy(&state_ptr->output_mutex);
+    platform_semaphore_destroy(&state_ptr->wake_writer);
+    ring_queue_destroy(&state_ptr->queue);
     state_ptr = 0;
 }
 
-void log_output(log_level level, const char* message, ...) {
-    const char* level_strings[6] = { "[FATAL]: ", "[ERROR]: ", "[WARN]: ", "[INFO]: ", "[DEBUG]: ", "[TRACE]: " };
-    Boolean is_error = level < LOG_LEVEL_WARN;
-    
+void log_flush() {
+    if (!state_ptr || on_writer_thread()) {
+        return;
+    }
+
+    // Dropped messages were never queued, so everything queued is eventually written.
+    UInt64 target = atomic_load(&state_ptr->queued_count);
+    while (atomic_load_explicit(&state_ptr->written_count, memory_order_acquire) < target) {
+        platform_semaphore_signal(&state_ptr->wake_writer);
+        platform_sleep(0);
+    }
+}
+
+void log_set_console_enabled(Boolean enabled) {
+    if (state_ptr) {
+        atomic_store(&state_ptr->console_enabled, enabled);
+    }
+}
+
+void log_get_stats(log_stats* out_stats) {
+    if (!out_stats) {
+        return;
+    }
+
+    kzero_memory(out_stats, sizeof(log_stats));
+    if (state_ptr) {
+        out_stats->queued_count = atomic_load(&state_ptr->queued_count);
+        out_stats->written_count = atomic_load(&state_ptr->written_count);
+        out_stats->dropped_count = atomic_load(&state_ptr->dropped_count);
+    }
+}
+
+Boolean log_set_binary_output(const char* path) {
+    if (!state_ptr) {
+        return FALSE;
+    }
+
+    // Opened before taking the lock, since a failed open logs an error itself.
+    file_handle new_file = {0};
+    if (path) {
+        if (!filesystem_open(path, FILE_MODE_WRITE, TRUE, &new_file)) {
+            return FALSE;
+        }
+        UInt64 written = 0;
+        filesystem_write(&new_file, LOG_BINARY_MAGIC_LENGTH, LOG_BINARY_MAGIC, &written);
+    }
+
+    log_flush();
+    platform_mutex_lock(&state_ptr->output_mutex);
+    flush_file_batch();
+    file_handle old_file = state_ptr->binary_file_handle;
+    state_ptr->binary_file_handle = new_file;
+    kzero_memory(state_ptr->site_written, sizeof(state_ptr->site_written));
+    platform_mutex_unlock(&state_ptr->output_mutex);
+
+    filesystem_close(&old_file);
+    return TRUE;
+}
+
+void log_set_level(log_category category, log_level level) {
+    if (category >= LOG_CATEGORY_MAX) {
+        return;
+    }
+
+    if (level < LOG_LEVEL_ERROR) {
+        level = LOG_LEVEL_ERROR;
+    } else if (level > LOG_LEVEL_TRACE) {
+        level = LOG_LEVEL_TRACE;
+    }
+    atomic_store_explicit(&log_category_levels[category], (UInt8)level, memory_order_relaxed);
+}
+
+log_level log_get_level(log_category category) {
+    if (category >= LOG_CATEGORY_MAX) {
+        return LOG_LEVEL_ERROR;
+    }
+    return atomic_load_explicit(&log_category_levels[category], memory_order_relaxed);
+}
+
+static Boolean name_matches(const char* name, const char* text, UInt64 length) {
+    for (UInt64 i = 0; i < length; ++i) {
+        if (name[i] != text[i]) {
+            return FALSE;
+        }
+    }
+    return name[length] == 0;
+}
+
+Boolean log_set_levels(const char* levels) {
+    if (!levels) {
+        return FALSE;
+    }
+
+    // Every entry is applied that can be, even when another one is malformed.
+    Boolean success = TRUE;
+    const char* entry = levels;
+    while (*entry) {
+        const char* end = entry;
+        const char* equals = 0;
+        while (*end && *end != ',') {
+            if (*end == '=' && !equals) {
+                equals = end;
+            }
+            end++;
+        }
+
+        Int32 category = -1;
+        Int32 level = -1;
+        if (equals) {
+            UInt64 name_length = equals - entry;
+            UInt64 level_length = end - equals - 1;
+            if (name_matches("all", entry, name_length)) {
+                category = LOG_CATEGORY_MAX;
+            }
+            for (UInt32 i = 0; i < LOG_CATEGORY_MAX && category < 0; ++i) {
+                if (name_matches(category_names[i], entry, name_length)) {
+                    category = i;
+                }
+            }
+            for (UInt32 i = 0; i < 6 && level < 0; ++i) {
+                if (name_matches(level_names[i], equals + 1, level_length)) {
+                    level = i;
+                }
+            }
+        }
+
+        if (category < 0 || level < 0) {
+            success = FALSE;
+        } else if (category == LOG_CATEGORY_MAX) {
+            for (UInt32 i = 0; i < LOG_CATEGORY_MAX; ++i) {
+                log_set_level(i, level);
+            }
+        } else {
+            log_set_level(category, level);
+        }
+
+        entry = *end ? end + 1 : end;
+    }
+
+    return success;
+}
+
+static void log_output_synchronous(log_level level, const char* message, va_list arg_ptr) {
     char out_message[32000];
-    kzero_memory(out_message, sizeof(out_message));
-    
-    __builtin_va_list arg_ptr;
+    Int32 prefix_length = snprintf(out_message, sizeof(out_message), "%s", level_strings[level]);
+    Int32 written = vsnprintf(out_message + prefix_length, sizeof(out_message) - prefix_length - 1, message, arg_ptr);
+    UInt64 length = prefix_length + (written < 0 ? 0 : written);
+    if (length > sizeof(out_message) - 2) {
+        length = sizeof(out_message) - 2;
+    }
+    out_message[length] = '\n';
+    out_message[length + 1] = 0;
+
+    log_flush();
+    write_console(out_message, level);
+    write_file_direct(out_message, level);
+}
+
+static void enqueue_message(const log_message* record) {
+    if (!ring_queue_enqueue(&state_ptr->queue, record)) {
+        // Errors are never dropped: let the writer catch up, then write this one here, in order.
+        if (record->level <= LOG_LEVEL_ERROR) {
+            log_flush();
+            platform_mutex_lock(&state_ptr->output_mutex);
+            write_message(record);
+            flush_file_batch();
+            platform_mutex_unlock(&state_ptr->output_mutex);
+            return;
+        }
+        atomic_fetch_add_explicit(&state_ptr->dropped_count, 1, memory_order_relaxed);
+        wake_writer();
+        return;
+    }
+
+    atomic_fetch_add_explicit(&state_ptr->queued_count, 1, memory_order_relaxed);
+    wake_writer();
+}
+
+static void log_output_v(log_level level, const char* message, va_list arg_ptr) {
+    // Fatal messages are written before returning, since the process may be about to die.
+    if (!state_ptr || level == LOG_LEVEL_FATAL || on_writer_thread()) {
+        log_output_synchronous(level, message, arg_ptr);
+        return;
+    }
+
+    va_list retry_ptr;
+    va_copy(retry_ptr, arg_ptr);
+
+    log_message record;
+    record.level = (UInt8)level;
+    record.site_id = 0;
+    Int32 prefix_length = snprintf(record.text, LOG_MESSAGE_MAX_LENGTH, "%s", level_strings[level]);
+    Int32 written = vsnprintf(record.text + prefix_length, LOG_MESSAGE_MAX_LENGTH - prefix_length - 1, message, arg_ptr);
+
+    if (written < 0 || prefix_length + written + 2 > LOG_MESSAGE_MAX_LENGTH) {
+        log_output_synchronous(level, message, retry_ptr);
+        va_end(retry_ptr);
+        return;
+    }
+    va_end(retry_ptr);
+
+    record.length = (UInt16)(prefix_length + written);
+    record.text[record.length++] = '\n';
+    record.text[record.length] = 0;
+    enqueue_message(&record);
+}
+
+void log_output(log_level level, const char* message, ...) {
+    va_list arg_ptr;
     va_start(arg_ptr, message);
-    string_format_v(out_message, message, arg_ptr);
+    log_output_v(level, message, arg_ptr);
     va_end(arg_ptr);
+}
 
-    string_format(out_message, "%s%s\n", level_strings[level], out_message);
+// Returns the site's id, registering it on first use. Threads that lose the race to register a
+// site just format that one call immediately.
+static UInt32 log_site_id(log_site* site) {
+    UInt32 id = atomic_load_explicit(&site->id, memory_order_acquire);
+    if (id != 0) {
+        return id;
+    }
 
-    if (is_error)
-        platform_console_write_error(out_message, level);
-    else
-        platform_console_write(out_message, level);
+    if (!atomic_compare_exchange_strong(&site->id, &id, LOG_SITE_ID_REGISTERING)) {
+        return id;
+    }
 
-    append_to_log_file(out_message);
+    id = LOG_SITE_ID_TEXT_ONLY;
+    if (log_binary_parse_format(site->format, site->arg_kinds, &site->arg_count)) {
+        UInt32 index = atomic_fetch_add(&registered_site_count, 1) + 1;
+        if (index < LOG_MAX_SITES) {
+            registered_sites[index] = site;
+            id = index;
+        }
+    }
+
+    atomic_store_explicit(&site->id, id, memory_order_release);
+    return id;
 }
- 
+
+void log_output_binary(log_site* site, ...) {
+    va_list arg_ptr;
+    va_start(arg_ptr, site);
+
+    UInt32 id = state_ptr && !on_writer_thread() ? log_site_id(site) : LOG_SITE_ID_TEXT_ONLY;
+    if (id >= LOG_SITE_ID_REGISTERING) {
+        log_output_v(site->level, site->format, arg_ptr);
+        va_end(arg_ptr);
+        return;
+    }
+
+    va_list retry_ptr;
+    va_copy(retry_ptr, arg_ptr);
+
+    log_message record;
+    record.level = (UInt8)site->level;
+    record.site_id = id;
+    UInt64 length = 0;
+    if (!log_binary_pack(site, arg_ptr, (UInt8*)record.text, LOG_MESSAGE_MAX_LENGTH, &length)) {
+        log_output_v(site->level, site->format, retry_ptr);
+    } else {
+        record.length = (UInt16)length;
+        enqueue_message(&record);
+    }
+
+    va_end(retry_ptr);
+    va_end(arg_ptr);
+}
+
 void report_assertion_failure(const char* expression, const char* message, const char* file, Int32 line) {
     log_output(LOG_LEVEL_FATAL, "Assertion Failure: %s, message: '%s', in file: %s, line: %d\n", expression, message, file, line);
 }
\ No newline at end of file
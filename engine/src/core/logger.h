@@ -2,16 +2,33 @@
 
 #include "defines.h"
 
-#define LOG_WARN_ENABLED 1
-#define LOG_INFO_ENABLED 1
-#define LOG_DEBUG_ENABLED 1
-#define LOG_TRACE_ENABLED 1
-
-#if KRELEASE == 1
-    #define LOG_DEBUG_ENABLED 0
-    #define LOG_TRACE_ENABLED 0
+#include <stdatomic.h>
+
+// Calls above this level are compiled out, arguments and all: 2 = warn, 3 = info, 4 = debug, 5 = trace.
+#ifndef LOG_COMPILE_LEVEL
+    #if KRELEASE == 1
+        #define LOG_COMPILE_LEVEL 3
+    #else
+        #define LOG_COMPILE_LEVEL 5
+    #endif
 #endif
 
+#define LOG_WARN_ENABLED (LOG_COMPILE_LEVEL >= 2)
+#define LOG_INFO_ENABLED (LOG_COMPILE_LEVEL >= 3)
+#define LOG_DEBUG_ENABLED (LOG_COMPILE_LEVEL >= 4)
+#define LOG_TRACE_ENABLED (LOG_COMPILE_LEVEL >= 5)
+
+// KWARN, KINFO, KDEBUG and KTRACE only copy their raw arguments on the calling thread;
+// formatting is deferred to the log writer, or to the log decoder when writing a binary log.
+// KERROR and KFATAL always format immediately.
+#define LOG_BINARY_ENABLED 1
+
+#define LOG_SITE_MAX_ARGS 16
+#define LOG_MAX_SITES 4096
+#define LOG_BINARY_LINE_MAX_LENGTH 4096
+// Messages the writer can fall behind by before warnings and below are dropped. Must be a power of two.
+#define LOG_QUEUE_CAPACITY 1024
+
 typedef enum log_level
 {
     LOG_LEVEL_FATAL = 0,
@@ -22,10 +39,92 @@ typedef enum log_level
     LOG_LEVEL_TRACE = 5
 } log_level;
 
-Boolean initialize_logging(UInt64* memory_requirement, void* state);
-void shutdown_logging(void* state);
+typedef enum log_category {
+    LOG_CATEGORY_GENERAL = 0,
+    LOG_CATEGORY_RENDERER,
+    LOG_CATEGORY_VULKAN,
+    LOG_CATEGORY_MEMORY,
+    LOG_CATEGORY_INPUT,
+    LOG_CATEGORY_GAME,
+    LOG_CATEGORY_MAX
+} log_category;
+
+// The most verbose level each category currently writes. Read by the logging macros before
+// they evaluate any arguments; change it with log_set_level.
+KAPI extern _Atomic UInt8 log_category_levels[LOG_CATEGORY_MAX];
+
+typedef struct log_stats {
+    // Messages handed to the background writer.
+    UInt64 queued_count;
+    // Messages the writer has finished writing.
+    UInt64 written_count;
+    // Warnings and below lost because the queue was full. Errors are written synchronously instead.
+    UInt64 dropped_count;
+} log_stats;
+
+// One per logging call site, created statically by the logging macros.
+typedef struct log_site {
+    const char* format;
+    log_level level;
+    // 0 until first use. Afterwards the site's id, or LOG_SITE_ID_TEXT_ONLY if its format
+    // cannot be deferred and every call has to be formatted immediately.
+    _Atomic UInt32 id;
+    UInt8 arg_count;
+    UInt8 arg_kinds[LOG_SITE_MAX_ARGS];
+} log_site;
+
+#define LOG_SITE_ID_TEXT_ONLY 0xFFFFFFFF
+
+// Once initialized, messages are queued by the calling thread and written by a background
+// thread. Before that, and after shutdown, they are written to the console immediately.
+KAPI Boolean initialize_logging(UInt64* memory_requirement, void* state);
+KAPI void shutdown_logging(void* state);
 
 KAPI void log_output(log_level level, const char* message, ...);
+KAPI void log_output_binary(log_site* site, ...);
+
+// Blocks until every message logged so far has been written. Fatal messages flush implicitly.
+KAPI void log_flush();
+
+// Console output can be turned off, leaving only console.log; useful for benchmarks.
+KAPI void log_set_console_enabled(Boolean enabled);
+
+KAPI void log_get_stats(log_stats* out_stats);
+
+// Sends file output to a binary log at path instead of console.log, without formatting
+// deferred messages. Pass 0 to go back to console.log.
+KAPI Boolean log_set_binary_output(const char* path);
+
+// Errors and fatal messages are always written, so levels below LOG_LEVEL_ERROR are raised to it.
+KAPI void log_set_level(log_category category, log_level level);
+KAPI log_level log_get_level(log_category category);
+
+// Applies a comma separated list such as "vulkan=trace,renderer=debug"; "all" names every
+// category. The KOHI_LOG_LEVELS environment variable is applied this way at startup.
+KAPI Boolean log_set_levels(const char* levels);
+
+// Turns a binary log back into the text console.log would have held.
+KAPI Boolean log_decode_binary_file(const char* binary_path, const char* text_path);
+
+#define KLOG_ENABLED(category, level) \
+    ((level) <= atomic_load_explicit(&log_category_levels[category], memory_order_relaxed))
+
+#if LOG_BINARY_ENABLED == 1
+    #define KLOG_DEFERRED(category, level, message, ...)                          \
+        do {                                                                      \
+            if (KLOG_ENABLED(category, level)) {                                  \
+                static log_site log_call_site = {message, level};                 \
+                log_output_binary(&log_call_site, ##__VA_ARGS__);                 \
+            }                                                                     \
+        } while (0)
+#else
+    #define KLOG_DEFERRED(category, level, message, ...)                          \
+        do {                                                                      \
+            if (KLOG_ENABLED(category, level)) {                                  \
+                log_output(level, message, ##__VA_ARGS__);                        \
+            }                                                                     \
+        } while (0)
+#endif
 
 #define KFATAL(message, ...) log_output(LOG_LEVEL_FATAL, message, ##__VA_ARGS__)
 
@@ -34,26 +133,30 @@ KAPI void log_output(log_level level, const char* message, ...);
 #endif
 
 #if LOG_WARN_ENABLED == 1
-    #define KWARN(message, ...) log_output(LOG_LEVEL_WARN, message, ##__VA_ARGS__)
+    #define KWARN_C(category, message, ...) KLOG_DEFERRED(category, LOG_LEVEL_WARN, message, ##__VA_ARGS__)
 #else
-    #define KWARN(message, ...)
+    #define KWARN_C(category, message, ...)
 #endif
 
 #if LOG_INFO_ENABLED == 1
-    #define KINFO(message, ...) log_output(LOG_LEVEL_INFO, message, ##__VA_ARGS__)
+    #define KINFO_C(category, message, ...) KLOG_DEFERRED(category, LOG_LEVEL_INFO, message, ##__VA_ARGS__)
 #else
-    #define KINFO(message, ...)
+    #define KINFO_C(category, message, ...)
 #endif
 
 #if LOG_DEBUG_ENABLED == 1
-    #define KDEBUG(message, ...) log_output(LOG_LEVEL_DEBUG, message, ##__VA_ARGS__)
+    #define KDEBUG_C(category, message, ...) KLOG_DEFERRED(category, LOG_LEVEL_DEBUG, message, ##__VA_ARGS__)
 #else
-    #define KDEBUG(message, ...)
+    #define KDEBUG_C(category, message, ...)
 #endif
 
 #if LOG_TRACE_ENABLED == 1
-    #define KTRACE(message, ...) log_output(LOG_LEVEL_TRACE, message, ##__VA_ARGS__)
+    #define KTRACE_C(category, message, ...) KLOG_DEFERRED(category, LOG_LEVEL_TRACE, message, ##__VA_ARGS__)
 #else
-    #define KTRACE(message, ...)
+    #define KTRACE_C(category, message, ...)
 #endif
 
+#define KWARN(message, ...) KWARN_C(LOG_CATEGORY_GENERAL, message, ##__VA_ARGS__)
+#define KINFO(message, ...) KINFO_C(LOG_CATEGORY_GENERAL, message, ##__VA_ARGS__)
+#define KDEBUG(message, ...) KDEBUG_C(LOG_CATEGORY_GENERAL, message, ##__VA_ARGS__)
+#define KTRACE(message, ...) KTRACE_C(LOG_CATEGORY_GENERAL, message, ##__VA_ARGS__)
\ No newline at end of file
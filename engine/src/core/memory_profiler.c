@@ -0,0 +1,262 @@
+#include "memory_profiler.h"
+
+#include "core/logger.h"
+#include "platform/platform.h"
+
+#include <stdatomic.h>
+#include <stdio.h>
+
+typedef struct callsite_entry {
+    memory_callsite_stats stats;
+    Boolean used;
+    UInt64 frame_allocations;
+    UInt64 frame_bytes;
+} callsite_entry;
+
+// Open addressing with linear probing. Removal shifts later entries back instead of leaving
+// tombstones, so a busy frame loop can't fill the table with them.
+typedef struct live_block {
+    void* block;
+    UInt64 size;
+    UInt32 callsite;
+} live_block;
+
+typedef struct memory_profiler_state {
+    callsite_entry callsites[MEMORY_PROFILER_MAX_CALLSITES];
+    live_block live_blocks[MEMORY_PROFILER_MAX_LIVE_BLOCKS];
+    UInt32 live_block_count;
+    // Allocations that could not be tracked because the live block table was full.
+    UInt64 untracked_count;
+} memory_profiler_state;
+
+static memory_profiler_state* state_ptr;
+static atomic_flag profiler_lock = ATOMIC_FLAG_INIT;
+static _Atomic Boolean is_enabled;
+
+static void lock() {
+    while (atomic_flag_test_and_set_explicit(&profiler_lock, memory_order_acquire)) {
+    }
+}
+
+static void unlock() {
+    atomic_flag_clear_explicit(&profiler_lock, memory_order_release);
+}
+
+static inline UInt64 hash_pointer(const void* pointer) {
+    UInt64 h = (UInt64)pointer;
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdull;
+    h ^= h >> 33;
+    return h;
+}
+
+static UInt32 find_callsite(const char* file, UInt32 line, memory_tag tag) {
+    UInt64 h = hash_pointer(file) ^ (line * 0x9e3779b97f4a7c15ull) ^ tag;
+    UInt32 index = (UInt32)(h % (MEMORY_PROFILER_MAX_CALLSITES - 1));
+    // The last slot is kept for whatever doesn't fit.
+    for (UInt32 probe = 0; probe < MEMORY_PROFILER_MAX_CALLSITES - 1; ++probe) {
+        callsite_entry* entry = &state_ptr->callsites[index];
+        if (!entry->used) {
+            entry->used = TRUE;
+            entry->stats.file = file;
+            entry->stats.line = line;
+            entry->stats.tag = tag;
+            return index;
+        }
+        if (entry->stats.file == file && entry->stats.line == line && entry->stats.tag == tag) {
+            return index;
+        }
+        index = (index + 1) % (MEMORY_PROFILER_MAX_CALLSITES - 1);
+    }
+    return MEMORY_PROFILER_MAX_CALLSITES - 1;
+}
+
+Boolean memory_profiler_enable(Boolean enabled) {
+    lock();
+    if (enabled && !state_ptr) {
+        // Straight from the platform, so the profiler never shows up in its own numbers.
+        state_ptr = platform_allocate(sizeof(memory_profiler_state), FALSE);
+        if (!state_ptr) {
+            unlock();
+            KERROR("memory_profiler_enable - could not allocate the profiler tables.");
+            return FALSE;
+        }
+    } else if (!enabled && state_ptr) {
+        platform_free(state_ptr, FALSE);
+        state_ptr = 0;
+    }
+    if (state_ptr) {
+        platform_zero_memory(state_ptr, sizeof(memory_profiler_state));
+        state_ptr->callsites[MEMORY_PROFILER_MAX_CALLSITES - 1].used = TRUE;
+    }
+    atomic_store(&is_enabled, enabled);
+    unlock();
+    return TRUE;
+}
+
+Boolean memory_profiler_is_enabled() {
+    return atomic_load_explicit(&is_enabled, memory_order_relaxed);
+}
+
+void memory_profiler_record_allocation(void* block, UInt64 size, memory_tag tag, const char* file, UInt32 line) {
+    lock();
+    if (!state_ptr) {
+        unlock();
+        return;
+    }
+
+    UInt32 callsite = find_callsite(file, line, tag);
+    callsite_entry* entry = &state_ptr->callsites[callsite];
+    entry->frame_allocations++;
+    entry->frame_bytes += size;
+    entry->stats.total_allocations++;
+    entry->stats.total_bytes += size;
+
+    // One slot is always left empty, so lookups of blocks that aren't there still end.
+    if (state_ptr->live_block_count >= MEMORY_PROFILER_MAX_LIVE_BLOCKS - 1) {
+        state_ptr->untracked_count++;
+        unlock();
+        return;
+    }
+
+    UInt32 index = (UInt32)(hash_pointer(block) & (MEMORY_PROFILER_MAX_LIVE_BLOCKS - 1));
+    while (state_ptr->live_blocks[index].block) {
+        index = (index + 1) & (MEMORY_PROFILER_MAX_LIVE_BLOCKS - 1);
+    }
+    state_ptr->live_blocks[index] = (live_block){block, size, callsite};
+    state_ptr->live_block_count++;
+    entry->stats.live_allocations++;
+    entry->stats.live_bytes += size;
+    unlock();
+}
+
+void memory_profiler_record_free(void* block) {
+    lock();
+    if (!state_ptr || !block) {
+        unlock();
+        return;
+    }
+
+    UInt32 mask = MEMORY_PROFILER_MAX_LIVE_BLOCKS - 1;
+    UInt32 index = (UInt32)(hash_pointer(block) & mask);
+    while (state_ptr->live_blocks[index].block && state_ptr->live_blocks[index].block != block) {
+        index = (index + 1) & mask;
+    }
+    if (!state_ptr->live_blocks[index].block) {
+        // Allocated before profiling started, or while the table was full.
+        unlock();
+        return;
+    }
+
+    live_block* found = &state_ptr->live_blocks[index];
+    callsite_entry* entry = &state_ptr->callsites[found->callsite];
+    entry->stats.live_allocations--;
+    entry->stats.live_bytes -= found->size;
+    state_ptr->live_block_count--;
+
+    // Pull back any later entry of the same run that could sit in the freed slot.
+    UInt32 hole = index;
+    UInt32 next = (index + 1) & mask;
+    while (state_ptr->live_blocks[next].block) {
+        UInt32 home = (UInt32)(hash_pointer(state_ptr->live_blocks[next].block) & mask);
+        if (((next - home) & mask) >= ((next - hole) & mask)) {
+            state_ptr->live_blocks[hole] = state_ptr->live_blocks[next];
+            hole = next;
+        }
+        next = (next + 1) & mask;
+    }
+    state_ptr->live_blocks[hole].block = 0;
+    unlock();
+}
+
+void memory_profiler_frame_end() {
+    lock();
+    if (state_ptr) {
+        for (UInt32 i = 0; i < MEMORY_PROFILER_MAX_CALLSITES; ++i) {
+            callsite_entry* entry = &state_ptr->callsites[i];
+            entry->stats.frame_allocations = entry->frame_allocations;
+            entry->stats.frame_bytes = entry->frame_bytes;
+            entry->frame_allocations = 0;
+            entry->frame_bytes = 0;
+        }
+    }
+    unlock();
+}
+
+static UInt64 ranking(const memory_callsite_stats* stats, Boolean by_frame) {
+    return by_frame ? stats->frame_allocations : stats->live_allocations;
+}
+
+UInt32 memory_profiler_get_top_callsites(Boolean by_frame, memory_callsite_stats* out_callsites, UInt32 max_count) {
+    UInt32 count = 0;
+    lock();
+    if (state_ptr && max_count > 0) {
+        // An insertion sort into the caller's array; max_count is expected to be small.
+        for (UInt32 i = 0; i < MEMORY_PROFILER_MAX_CALLSITES; ++i) {
+            const memory_callsite_stats* stats = &state_ptr->callsites[i].stats;
+            UInt64 rank = ranking(stats, by_frame);
+            if (rank == 0 || (count == max_count && rank <= ranking(&out_callsites[count - 1], by_frame))) {
+                continue;
+            }
+
+            UInt32 position = count < max_count ? count++ : max_count - 1;
+            while (position > 0 && ranking(&out_callsites[position - 1], by_frame) < rank) {
+                out_callsites[position] = out_callsites[position - 1];
+                position--;
+            }
+            out_callsites[position] = *stats;
+        }
+    }
+    unlock();
+    return count;
+}
+
+static UInt64 write_report(Boolean by_frame, char* buffer, UInt64 buffer_size, UInt32 max_callsites) {
+    if (!buffer || buffer_size == 0) {
+        return 0;
+    }
+
+    memory_callsite_stats top[32];
+    UInt32 count = memory_profiler_get_top_callsites(by_frame, top, max_callsites < 32 ? max_callsites : 32);
+
+    UInt64 allocations = 0;
+    UInt64 bytes = 0;
+    UInt64 untracked = 0;
+    lock();
+    if (state_ptr) {
+        for (UInt32 i = 0; i < MEMORY_PROFILER_MAX_CALLSITES; ++i) {
+            const memory_callsite_stats* stats = &state_ptr->callsites[i].stats;
+            allocations += by_frame ? stats->frame_allocations : stats->live_allocations;
+            bytes += by_frame ? stats->frame_bytes : stats->live_bytes;
+        }
+        untracked = state_ptr->untracked_count;
+    }
+    unlock();
+
+    Int32 length = by_frame ? snprintf(buffer, buffer_size, "Allocations in the last frame: %llu (%llu bytes).\n", allocations, bytes)
+                            : snprintf(buffer, buffer_size, "Blocks still allocated: %llu (%llu bytes), %llu not tracked.\n", allocations, bytes, untracked);
+    UInt64 offset = length > 0 ? (UInt64)length : 0;
+
+    for (UInt32 i = 0; i < count && offset < buffer_size; ++i) {
+        const memory_callsite_stats* stats = &top[i];
+        length = snprintf(buffer + offset, buffer_size - offset, "  %s:%u [%s]: %llu blocks, %llu bytes\n",
+                          stats->file ? stats->file : "(unknown)", stats->line, memory_tag_name(stats->tag),
+                          by_frame ? stats->frame_allocations : stats->live_allocations,
+                          by_frame ? stats->frame_bytes : stats->live_bytes);
+        if (length < 0) {
+            break;
+        }
+        offset += length;
+    }
+
+    // On truncation snprintf has already terminated the buffer.
+    return offset < buffer_size ? offset : buffer_size - 1;
+}
+
+UInt64 memory_profiler_frame_report(char* buffer, UInt64 buffer_size, UInt32 max_callsites) {
+    return write_report(TRUE, buffer, buffer_size, max_callsites);
+}
+
+UInt64 memory_profiler_leak_report(char* buffer, UInt64 buffer_size, UInt32 max_callsites) {
+    return write_report(FALSE, buffer, buffer_size, max_callsites);
+}
\ No newline at end of file
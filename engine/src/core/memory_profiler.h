@@ -0,0 +1,47 @@
+#pragma once
+
+#include "defines.h"
+
+#include "core/kmemory.h"
+
+// Distinct file, line and tag combinations that can be told apart. Later ones are counted
+// against a single overflow callsite.
+#define MEMORY_PROFILER_MAX_CALLSITES 4096
+// Live blocks whose callsite can be looked up when freed. Must be a power of two.
+#define MEMORY_PROFILER_MAX_LIVE_BLOCKS 65536
+
+typedef struct memory_callsite_stats {
+    // 0 for allocations made without a callsite, such as through a function pointer.
+    const char* file;
+    UInt32 line;
+    memory_tag tag;
+    // Over the last frame closed by memory_profiler_frame_end.
+    UInt64 frame_allocations;
+    UInt64 frame_bytes;
+    // Since profiling started.
+    UInt64 total_allocations;
+    UInt64 total_bytes;
+    // Blocks from this callsite that have not been freed yet.
+    UInt64 live_allocations;
+    UInt64 live_bytes;
+} memory_callsite_stats;
+
+// Starts or stops recording where kallocate is called from. Starting clears everything
+// recorded before. Every thread shares one lock while it is on, so keep it for investigating.
+KAPI Boolean memory_profiler_enable(Boolean enabled);
+KAPI Boolean memory_profiler_is_enabled();
+
+// Called by kallocate and kfree.
+void memory_profiler_record_allocation(void* block, UInt64 size, memory_tag tag, const char* file, UInt32 line);
+void memory_profiler_record_free(void* block);
+
+// Closes the frame counts; the reports and top list describe the frame just closed.
+KAPI void memory_profiler_frame_end();
+
+// Fills out_callsites with up to max_count callsites, most allocations first. by_frame ranks by
+// the last frame, otherwise by blocks still live. Returns how many were written.
+KAPI UInt32 memory_profiler_get_top_callsites(Boolean by_frame, memory_callsite_stats* out_callsites, UInt32 max_count);
+
+// Write reports into buffer without allocating, truncated to fit. Return the characters written.
+KAPI UInt64 memory_profiler_frame_report(char* buffer, UInt64 buffer_size, UInt32 max_callsites);
+KAPI UInt64 memory_profiler_leak_report(char* buffer, UInt64 buffer_size, UInt32 max_callsites);
\ No newline at end of file
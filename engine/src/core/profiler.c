@@ -0,0 +1,414 @@
+#include "profiler.h"
+
+#include "core/logger.h"
+#include "core/kmemory.h"
+#include "core/kstring.h"
+#include "containers/ring_queue.h"
+#include "platform/platform.h"
+#include "platform/filesystem.h"
+
+#include <stdarg.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define PROFILER_CAPTURE_BATCH_SIZE (64 * 1024)
+
+// A zone as its thread records it, in raw timestamp ticks.
+typedef struct recorded_zone {
+    const char* name;
+    UInt64 start;
+    UInt64 end;
+    UInt32 depth;
+} recorded_zone;
+
+typedef struct open_zone {
+    const char* name;
+    UInt64 start;
+} open_zone;
+
+typedef struct profiler_thread {
+    // Single producer, the owning thread; single consumer, profiler_frame_end.
+    ring_queue zones;
+    open_zone stack[PROFILER_MAX_DEPTH];
+    UInt32 depth;
+    _Atomic UInt64 dropped_count;
+    // Set when the owning thread has given the slot back.
+    atomic_bool released;
+    atomic_bool named;
+    char name[PROFILER_THREAD_NAME_LENGTH];
+} profiler_thread;
+
+typedef struct profiler_system_state {
+    profiler_thread threads[PROFILER_MAX_THREADS];
+    _Atomic UInt32 thread_count;
+    atomic_bool out_of_threads_reported;
+
+    UInt64 start_ticks;
+    Double start_time;
+    Double seconds_per_tick;
+
+    UInt32 frame_zone_count;
+    profiler_zone frame_zones[PROFILER_MAX_FRAME_ZONES];
+    // Scratch space for one thread's zones while they are put in order.
+    recorded_zone sort_buffer[PROFILER_THREAD_CAPACITY];
+
+    file_handle capture_file;
+    Boolean capture_has_events;
+    UInt64 capture_length;
+    char capture_batch[PROFILER_CAPTURE_BATCH_SIZE];
+} profiler_system_state;
+
+static profiler_system_state* state_ptr;
+
+// Each initialization starts a new session, which makes threads register again.
+static _Atomic UInt32 active_session;
+static _Atomic UInt32 last_session;
+static _Thread_local UInt32 current_session;
+static _Thread_local profiler_thread* current_thread;
+
+static profiler_thread* register_current_thread(UInt32 session) {
+    current_session = session;
+    current_thread = 0;
+    if (session == 0 || !state_ptr) {
+        return 0;
+    }
+
+    // Take over a slot a finished thread gave back before opening a new one. Its zones and
+    // name carry on, since both are only read by the main thread.
+    UInt32 count = atomic_load_explicit(&state_ptr->thread_count, memory_order_acquire);
+    for (UInt32 i = 0; i < count && i < PROFILER_MAX_THREADS; ++i) {
+        profiler_thread* thread = &state_ptr->threads[i];
+        Boolean released = TRUE;
+        if (atomic_load_explicit(&thread->released, memory_order_relaxed) &&
+            atomic_compare_exchange_strong_explicit(&thread->released, &released, FALSE, memory_order_acquire, memory_order_relaxed)) {
+            thread->depth = 0;
+            current_thread = thread;
+            return current_thread;
+        }
+    }
+
+    UInt32 index = atomic_fetch_add(&state_ptr->thread_count, 1);
+    if (index >= PROFILER_MAX_THREADS) {
+        atomic_store(&state_ptr->thread_count, PROFILER_MAX_THREADS);
+        if (!atomic_exchange(&state_ptr->out_of_threads_reported, TRUE)) {
+            KWARN("Profiler - more than %u threads are recording at once; the rest are not profiled.", PROFILER_MAX_THREADS);
+        }
+        return 0;
+    }
+
+    current_thread = &state_ptr->threads[index];
+    return current_thread;
+}
+
+static inline profiler_thread* current_thread_state() {
+    UInt32 session = atomic_load_explicit(&active_session, memory_order_acquire);
+    if (session != current_session) {
+        return register_current_thread(session);
+    }
+    return current_thread;
+}
+
+Boolean profiler_system_initialize(UInt64* memory_requirement, void* state) {
+    UInt64 queue_requirement = ring_queue_memory_requirement(RING_QUEUE_MODE_SPSC, sizeof(recorded_zone), PROFILER_THREAD_CAPACITY);
+    *memory_requirement = sizeof(profiler_system_state) + queue_requirement * PROFILER_MAX_THREADS;
+
+    if (state == 0) {
+        return TRUE;
+    }
+
+    kzero_memory(state, sizeof(profiler_system_state));
+    profiler_system_state* new_state = state;
+    UInt8* queue_memory = (UInt8*)(new_state + 1);
+    for (UInt32 i = 0; i < PROFILER_MAX_THREADS; ++i) {
+        if (!ring_queue_create(RING_QUEUE_MODE_SPSC, sizeof(recorded_zone), PROFILER_THREAD_CAPACITY,
+                               queue_memory + queue_requirement * i, &new_state->threads[i].zones)) {
+            KERROR("profiler_system_initialize - failed to create a zone queue.");
+            return FALSE;
+        }
+    }
+
+    new_state->start_time = platform_get_absolute_time();
+    new_state->start_ticks = platform_get_timestamp();
+    state_ptr = new_state;
+    atomic_store(&active_session, atomic_fetch_add(&last_session, 1) + 1);
+    return TRUE;
+}
+
+void profiler_system_shutdown(void* state) {
+    if (!state_ptr) {
+        return;
+    }
+
+    profiler_end_capture();
+    atomic_store(&active_session, 0);
+
+    UInt64 dropped = profiler_get_dropped_count();
+    if (dropped > 0) {
+        KWARN("Profiler dropped %llu zone(s); call profiler_frame_end more often or raise PROFILER_THREAD_CAPACITY.", dropped);
+    }
+
+    for (UInt32 i = 0; i < PROFILER_MAX_THREADS; ++i) {
+        ring_queue_destroy(&state_ptr->threads[i].zones);
+    }
+    state_ptr = 0;
+}
+
+void profiler_thread_release() {
+    profiler_thread* thread = current_session == atomic_load(&active_session) ? current_thread : 0;
+    if (thread) {
+        current_thread = 0;
+        current_session = 0;
+        atomic_store_explicit(&thread->released, TRUE, memory_order_release);
+    }
+}
+
+void profiler_zone_begin(const char* name) {
+    profiler_thread* thread = current_thread_state();
+    if (!thread) {
+        return;
+    }
+
+    // Zones nested too deeply are not recorded, but still counted so the ends match up.
+    if (thread->depth < PROFILER_MAX_DEPTH) {
+        open_zone* zone = &thread->stack[thread->depth];
+        zone->name = name;
+        zone->start = platform_get_timestamp();
+    }
+    thread->depth++;
+}
+
+void profiler_zone_end() {
+    UInt64 end = platform_get_timestamp();
+    profiler_thread* thread = current_thread_state();
+    if (!thread || thread->depth == 0) {
+        return;
+    }
+
+    UInt32 depth = --thread->depth;
+    if (depth >= PROFILER_MAX_DEPTH) {
+        return;
+    }
+
+    recorded_zone zone = {thread->stack[depth].name, thread->stack[depth].start, end, depth};
+    if (!ring_queue_enqueue(&thread->zones, &zone)) {
+        atomic_fetch_add_explicit(&thread->dropped_count, 1, memory_order_relaxed);
+    }
+}
+
+void profiler_scope_end(UInt8* scope) {
+    profiler_zone_end();
+}
+
+void profiler_set_thread_name(const char* name) {
+    profiler_thread* thread = current_thread_state();
+    if (!thread || atomic_load_explicit(&thread->named, memory_order_relaxed)) {
+        return;
+    }
+
+    UInt64 length = string_length(name);
+    if (length >= PROFILER_THREAD_NAME_LENGTH) {
+        length = PROFILER_THREAD_NAME_LENGTH - 1;
+    }
+    kcopy_memory(thread->name, name, length);
+    thread->name[length] = 0;
+    atomic_store_explicit(&thread->named, TRUE, memory_order_release);
+}
+
+static void capture_write(const char* text, UInt64 length) {
+    if (state_ptr->capture_length + length > PROFILER_CAPTURE_BATCH_SIZE) {
+        UInt64 written = 0;
+        filesystem_write(&state_ptr->capture_file, state_ptr->capture_length, state_ptr->capture_batch, &written);
+        state_ptr->capture_length = 0;
+    }
+
+    kcopy_memory(state_ptr->capture_batch + state_ptr->capture_length, text, length);
+    state_ptr->capture_length += length;
+}
+
+// Names are usually literals, but quotes and backslashes would still break the JSON.
+// Writes at most out_size - 1 characters and terminates them.
+static UInt64 json_escape(const char* text, char* out, UInt64 out_size) {
+    UInt64 length = 0;
+    for (const char* c = text; *c && length + 2 < out_size; ++c) {
+        if (*c == '"' || *c == '\\') {
+            out[length++] = '\\';
+        }
+        out[length++] = (UInt8)*c < 0x20 ? ' ' : *c;
+    }
+    out[length] = 0;
+    return length;
+}
+
+static void capture_write_event(const char* name, const char* format, ...) {
+    char event[512];
+    UInt64 length = 0;
+    if (state_ptr->capture_has_events) {
+        event[length++] = ',';
+    }
+    event[length++] = '\n';
+    length += snprintf(event + length, sizeof(event) - length, "{\"name\":\"");
+    length += json_escape(name, event + length, sizeof(event) - 256 - length);
+
+    va_list arg_ptr;
+    va_start(arg_ptr, format);
+    Int32 written = vsnprintf(event + length, sizeof(event) - length, format, arg_ptr);
+    va_end(arg_ptr);
+    if (written > 0) {
+        length += written;
+    }
+    if (length > sizeof(event) - 1) {
+        length = sizeof(event) - 1;
+    }
+
+    capture_write(event, length);
+    state_ptr->capture_has_events = TRUE;
+}
+
+static int compare_recorded_zones(const void* a, const void* b) {
+    const recorded_zone* left = a;
+    const recorded_zone* right = b;
+    if (left->start != right->start) {
+        return left->start < right->start ? -1 : 1;
+    }
+    // Zones starting on the same tick are still nested outer first.
+    return (Int32)left->depth - (Int32)right->depth;
+}
+
+void profiler_frame_end() {
+    if (!state_ptr) {
+        return;
+    }
+
+    // The tick frequency is re-estimated over the whole run, so it keeps getting more precise.
+    UInt64 now_ticks = platform_get_timestamp();
+    Double now_time = platform_get_absolute_time();
+    if (now_ticks > state_ptr->start_ticks && now_time > state_ptr->start_time) {
+        state_ptr->seconds_per_tick = (now_time - state_ptr->start_time) / (Double)(now_ticks - state_ptr->start_ticks);
+    }
+
+    state_ptr->frame_zone_count = 0;
+    UInt32 thread_count = atomic_load(&state_ptr->thread_count);
+    if (thread_count > PROFILER_MAX_THREADS) {
+        thread_count = PROFILER_MAX_THREADS;
+    }
+
+    for (UInt32 t = 0; t < thread_count; ++t) {
+        profiler_thread* thread = &state_ptr->threads[t];
+        UInt32 count = 0;
+        while (count < PROFILER_THREAD_CAPACITY && ring_queue_dequeue(&thread->zones, &state_ptr->sort_buffer[count])) {
+            count++;
+        }
+        if (count == 0) {
+            continue;
+        }
+
+        // Zones are recorded as they end, children before their parents.
+        qsort(state_ptr->sort_buffer, count, sizeof(recorded_zone), compare_recorded_zones);
+
+        Int32 open[PROFILER_MAX_DEPTH];
+        for (UInt32 i = 0; i < PROFILER_MAX_DEPTH; ++i) {
+            open[i] = -1;
+        }
+
+        for (UInt32 i = 0; i < count; ++i) {
+            if (state_ptr->frame_zone_count == PROFILER_MAX_FRAME_ZONES) {
+                atomic_fetch_add_explicit(&thread->dropped_count, count - i, memory_order_relaxed);
+                break;
+            }
+
+            const recorded_zone* recorded = &state_ptr->sort_buffer[i];
+            Int32 index = (Int32)state_ptr->frame_zone_count++;
+            profiler_zone* zone = &state_ptr->frame_zones[index];
+            zone->name = recorded->name;
+            zone->start = (recorded->start - state_ptr->start_ticks) * state_ptr->seconds_per_tick;
+            zone->duration = (recorded->end - recorded->start) * state_ptr->seconds_per_tick;
+            zone->thread_index = t;
+            zone->depth = recorded->depth;
+            zone->parent = -1;
+
+            // A parent that began in an earlier frame has not been collected, so check that
+            // the candidate really encloses this zone.
+            if (recorded->depth > 0) {
+                Int32 candidate = open[recorded->depth - 1];
+                if (candidate >= 0) {
+                    const profiler_zone* parent = &state_ptr->frame_zones[candidate];
+                    if (parent->start + parent->duration >= zone->start) {
+                        zone->parent = candidate;
+                    }
+                }
+            }
+            open[recorded->depth] = index;
+        }
+    }
+
+    if (state_ptr->capture_file.is_valid) {
+        for (UInt32 i = 0; i < state_ptr->frame_zone_count; ++i) {
+            const profiler_zone* zone = &state_ptr->frame_zones[i];
+            capture_write_event(zone->name, "\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%u}",
+                                zone->start * 1000000.0, zone->duration * 1000000.0, zone->thread_index);
+        }
+    }
+}
+
+const profiler_zone* profiler_get_frame_zones(UInt32* out_count) {
+    if (!state_ptr) {
+        *out_count = 0;
+        return 0;
+    }
+
+    *out_count = state_ptr->frame_zone_count;
+    return state_ptr->frame_zones;
+}
+
+UInt64 profiler_get_dropped_count() {
+    UInt64 dropped = 0;
+    if (state_ptr) {
+        for (UInt32 i = 0; i < PROFILER_MAX_THREADS; ++i) {
+            dropped += atomic_load_explicit(&state_ptr->threads[i].dropped_count, memory_order_relaxed);
+        }
+    }
+    return dropped;
+}
+
+Boolean profiler_begin_capture(const char* path) {
+    if (!state_ptr) {
+        return FALSE;
+    }
+
+    profiler_end_capture();
+    if (!filesystem_open(path, FILE_MODE_WRITE, FALSE, &state_ptr->capture_file)) {
+        KERROR("profiler_begin_capture - unable to open '%s'.", path);
+        return FALSE;
+    }
+
+    state_ptr->capture_length = 0;
+    state_ptr->capture_has_events = FALSE;
+    const char* header = "{\"traceEvents\":[";
+    capture_write(header, string_length(header));
+    return TRUE;
+}
+
+void profiler_end_capture() {
+    if (!state_ptr || !state_ptr->capture_file.is_valid) {
+        return;
+    }
+
+    // Thread names are written last, since threads can be named at any point in the capture.
+    UInt32 thread_count = atomic_load(&state_ptr->thread_count);
+    for (UInt32 i = 0; i < thread_count && i < PROFILER_MAX_THREADS; ++i) {
+        profiler_thread* thread = &state_ptr->threads[i];
+        if (atomic_load_explicit(&thread->named, memory_order_acquire)) {
+            char name[PROFILER_THREAD_NAME_LENGTH * 2];
+            json_escape(thread->name, name, sizeof(name));
+            capture_write_event("thread_name", "\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"%s\"}}", i, name);
+        }
+    }
+
+    const char* footer = "\n]}\n";
+    capture_write(footer, string_length(footer));
+    UInt64 written = 0;
+    filesystem_write(&state_ptr->capture_file, state_ptr->capture_length, state_ptr->capture_batch, &written);
+    state_ptr->capture_length = 0;
+    filesystem_close(&state_ptr->capture_file);
+}
\ No newline at end of file
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "defines.h"
+
+// Define as 0 to compile every profiler zone out of the build.
+#ifndef KPROFILER_ENABLED
+    #define KPROFILER_ENABLED 1
+#endif
+
+#define PROFILER_MAX_THREADS 16
+#define PROFILER_MAX_DEPTH 32
+// Zones each thread can record between two calls to profiler_frame_end. Must be a power of two.
+#define PROFILER_THREAD_CAPACITY 4096
+#define PROFILER_MAX_FRAME_ZONES 8192
+#define PROFILER_THREAD_NAME_LENGTH 32
+
+typedef struct profiler_zone {
+    const char* name;
+    // Seconds since the profiler was initialized.
+    Double start;
+    Double duration;
+    UInt32 thread_index;
+    UInt32 depth;
+    // Index of the enclosing zone in the same frame, or -1 if it has none there.
+    Int32 parent;
+} profiler_zone;
+
+KAPI Boolean profiler_system_initialize(UInt64* memory_requirement, void* state);
+KAPI void profiler_system_shutdown(void* state);
+
+// Zone names must outlive the profiler; string literals are expected.
+KAPI void profiler_zone_begin(const char* name);
+KAPI void profiler_zone_end();
+
+// Only the first name given to a thread is kept, and a thread that takes over a released
+// slot shows up under that slot's name.
+KAPI void profiler_set_thread_name(const char* name);
+
+// Gives the calling thread's slot back for a later thread to use; call it before a thread
+// that recorded zones exits. Zones it already recorded are still collected.
+KAPI void profiler_thread_release();
+
+// Main thread only. Collects every zone that ended since the last call into the frame's zone
+// tree, and appends them to the capture if one is running.
+KAPI void profiler_frame_end();
+
+// Zones of the last collected frame, grouped by thread and ordered by start time.
+KAPI const profiler_zone* profiler_get_frame_zones(UInt32* out_count);
+
+// Zones lost because a thread recorded more than PROFILER_THREAD_CAPACITY in one frame.
+KAPI UInt64 profiler_get_dropped_count();
+
+// Writes every collected frame to path in the Chrome trace event format, which
+// about:tracing and Perfetto can open, until profiler_end_capture is called.
+KAPI Boolean profiler_begin_capture(const char* path);
+KAPI void profiler_end_capture();
+
+KAPI void profiler_scope_end(UInt8* scope);
+
+#define KPROFILE_CONCAT_INNER(a, b) a##b
+#define KPROFILE_CONCAT(a, b) KPROFILE_CONCAT_INNER(a, b)
+
+#if KPROFILER_ENABLED == 1
+    // Times the rest of the enclosing block.
+    #define KPROFILE_SCOPE(name)                                                               \
+        UInt8 KPROFILE_CONCAT(profile_scope_, __LINE__) __attribute__((cleanup(profiler_scope_end))) = \
+            (profiler_zone_begin(name), 0)
+    #define KPROFILE_BEGIN(name) profiler_zone_begin(name)
+    #define KPROFILE_END() profiler_zone_end()
+#else
+    #define KPROFILE_SCOPE(name)
+    #define KPROFILE_BEGIN(name)
+    #define KPROFILE_END()
+#endif
\ No newline at end of file
@@ -16,7 +16,7 @@ typedef double Double;
 typedef _Bool Boolean;
 typedef int Bool32;
 
-#if defined(__clang__) || defined(__gcc__)
+#if defined(__clang__) || defined(__GNUC__)
     #define STATIC_ASSERT _Static_assert
 #else
     #define STATIC_ASSERT static_assert
@@ -43,7 +43,7 @@ STATIC_ASSERT(sizeof(Double) == 8, "Expected Double to be 8 bytes.");
     #ifndef _WIN64
         #error "64-but is required on Windows!"
     #endif
-#elif defined(__linux__) || defines(__gnu_linux__)
+#elif defined(__linux__) || defined(__gnu_linux__)
     #define KPLATFORM_LINUX 1
     #if defined(__ANDROID__)
         #define KPLATFORM_ANDROID 1
@@ -82,6 +82,10 @@ STATIC_ASSERT(sizeof(Double) == 8, "Expected Double to be 8 bytes.");
     #endif
 #endif
 
+#define GIBIBYTES(amount) ((amount) * 1024ULL * 1024ULL * 1024ULL)
+#define MEBIBYTES(amount) ((amount) * 1024ULL * 1024ULL)
+#define KIBIBYTES(amount) ((amount) * 1024ULL)
+
 #define KCLAMP(value, min, max) (value <= min) ? min : (value >= max) ? max : value;
 
 #ifdef _MSC_VER
@@ -2,13 +2,14 @@
 
 #include "core/application.h"
 #include "core/logger.h"
+#include "core/benchmark.h"
 #include "game_types.h"
 
 extern Boolean create_game(game* out_game);
 
-int main(void) {
+int main(int argc, char** argv) {
 
-    game game_instance;
+    game game_instance = {0};
     if (!create_game(&game_instance)) {
         KFATAL("Could not create game!");
         return -1;
@@ -19,6 +20,11 @@ int main(void) {
         return -2;
     }
 
+    if (!benchmark_parse_arguments(argc, argv, &game_instance.app_config)) {
+        KFATAL("Usage: [--headless] [--benchmark <frames>] [--benchmark-output <path>] [--profile-memory]");
+        return -3;
+    }
+
     if (!application_create(&game_instance)) {
         KINFO("Application failed to create!");
         return 1;
@@ -7,7 +7,8 @@ typedef struct game
     application_config app_config;
     Boolean (*initialize)(struct game* game_inst);
     Boolean (*update)(struct game* game_inst, Single delta_time);
-    Boolean (*render)(struct game* game_inst, Single delta_time);
+    // alpha is how far the frame is between the last two fixed updates, or 1 without them.
+    Boolean (*render)(struct game* game_inst, Single delta_time, Single alpha);
     void (*on_resize)(struct game* game_inst, UInt32 width, UInt32 height);
     void* state;
     void* application_state;
@@ -0,0 +1,125 @@
+#include "dynamic_linear_allocator.h"
+
+#include "core/kmemory.h"
+#include "core/logger.h"
+
+typedef struct linear_allocator_page {
+    struct linear_allocator_page* next;
+    UInt64 size;
+} linear_allocator_page;
+
+static linear_allocator_page* page_create(UInt64 size) {
+    linear_allocator_page* page = kallocate(sizeof(linear_allocator_page) + size, MEMORY_TAG_LINEAR_ALLOC);
+    if (!page) {
+        return 0;
+    }
+    page->next = 0;
+    page->size = size;
+    return page;
+}
+
+static void page_destroy(linear_allocator_page* page) {
+    kfree(page, sizeof(linear_allocator_page) + page->size, MEMORY_TAG_LINEAR_ALLOC);
+}
+
+Boolean dynamic_linear_allocator_create(UInt64 page_size, dynamic_linear_allocator* out_allocator) {
+    if (!out_allocator) {
+        return FALSE;
+    }
+
+    kzero_memory(out_allocator, sizeof(dynamic_linear_allocator));
+    out_allocator->first_page = page_create(page_size);
+    if (!out_allocator->first_page) {
+        KERROR("dynamic_linear_allocator_create - failed to allocate a %llu byte page.", page_size);
+        return FALSE;
+    }
+
+    out_allocator->page_size = page_size;
+    out_allocator->current_page = out_allocator->first_page;
+    out_allocator->page_count = 1;
+    out_allocator->total_size = page_size;
+    return TRUE;
+}
+
+void dynamic_linear_allocator_destroy(dynamic_linear_allocator* allocator) {
+    if (allocator) {
+        linear_allocator_page* page = allocator->first_page;
+        while (page) {
+            linear_allocator_page* next = page->next;
+            page_destroy(page);
+            page = next;
+        }
+
+        allocator->first_page = 0;
+        allocator->current_page = 0;
+        allocator->current_offset = 0;
+        allocator->page_count = 0;
+        allocator->page_size = 0;
+        allocator->total_size = 0;
+        allocator->allocated = 0;
+    }
+}
+
+static UInt64 page_padding(linear_allocator_page* page, UInt64 offset, UInt16 alignment) {
+    UInt64 address = (UInt64)(page + 1) + offset;
+    return ((address + alignment - 1) & ~((UInt64)alignment - 1)) - address;
+}
+
+void* dynamic_linear_allocator_allocate(dynamic_linear_allocator* allocator, UInt64 size) {
+    return dynamic_linear_allocator_allocate_aligned(allocator, size, 1);
+}
+
+void* dynamic_linear_allocator_allocate_aligned(dynamic_linear_allocator* allocator, UInt64 size, UInt16 alignment) {
+    if (!allocator || !allocator->current_page) {
+        KERROR("dynamic_linear_allocator_allocate - provided allocator not initialized.");
+        return 0;
+    }
+
+    if (alignment == 0 || (alignment & (alignment - 1)) != 0) {
+        KERROR("dynamic_linear_allocator_allocate_aligned - alignment must be a power of two, got %u.", alignment);
+        return 0;
+    }
+
+    linear_allocator_page* page = allocator->current_page;
+    UInt64 offset = allocator->current_offset;
+    UInt64 padding = page_padding(page, offset, alignment);
+
+    // Move on to pages kept from earlier frames first; the tail of a skipped page is
+    // simply left unused until the next reset.
+    while (offset + padding + size > page->size) {
+        if (!page->next) {
+            // Page data starts 16-byte aligned; leave room for anything stricter.
+            UInt64 needed = size + (alignment > 16 ? alignment : 0);
+            UInt64 new_page_size = needed > allocator->page_size ? needed : allocator->page_size;
+            page->next = page_create(new_page_size);
+            if (!page->next) {
+                KERROR("dynamic_linear_allocator_allocate - failed to allocate a %llu byte page.", new_page_size);
+                return 0;
+            }
+            allocator->page_count++;
+            allocator->total_size += new_page_size;
+        }
+        page = page->next;
+        offset = 0;
+        padding = page_padding(page, offset, alignment);
+    }
+
+    void* block = ((UInt8*)(page + 1)) + offset + padding;
+    allocator->current_page = page;
+    allocator->current_offset = offset + padding + size;
+
+    allocator->allocated += padding + size;
+    if (allocator->allocated > allocator->high_water_mark) {
+        allocator->high_water_mark = allocator->allocated;
+    }
+
+    return block;
+}
+
+void dynamic_linear_allocator_reset(dynamic_linear_allocator* allocator) {
+    if (allocator) {
+        allocator->current_page = allocator->first_page;
+        allocator->current_offset = 0;
+        allocator->allocated = 0;
+    }
+}
\ No newline at end of file
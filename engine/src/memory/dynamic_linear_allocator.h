@@ -0,0 +1,30 @@
+#pragma once
+
+#include "defines.h"
+
+struct linear_allocator_page;
+
+// A linear allocator that chains additional pages when the current one runs out,
+// instead of failing. Reset rewinds to the first page in O(1) and keeps every page
+// for reuse, so once warmed up it no longer touches the heap at all.
+typedef struct dynamic_linear_allocator {
+    UInt64 page_size;
+    // Total capacity of all pages currently owned.
+    UInt64 total_size;
+    // Bytes handed out since the last reset.
+    UInt64 allocated;
+    // Largest value allocated has reached since creation. Use it to size the first page.
+    UInt64 high_water_mark;
+    UInt32 page_count;
+    struct linear_allocator_page* first_page;
+    struct linear_allocator_page* current_page;
+    UInt64 current_offset;
+} dynamic_linear_allocator;
+
+KAPI Boolean dynamic_linear_allocator_create(UInt64 page_size, dynamic_linear_allocator* out_allocator);
+KAPI void dynamic_linear_allocator_destroy(dynamic_linear_allocator* allocator);
+
+KAPI void* dynamic_linear_allocator_allocate(dynamic_linear_allocator* allocator, UInt64 size);
+// alignment must be a power of two.
+KAPI void* dynamic_linear_allocator_allocate_aligned(dynamic_linear_allocator* allocator, UInt64 size, UInt16 alignment);
+KAPI void dynamic_linear_allocator_reset(dynamic_linear_allocator* allocator);
\ No newline at end of file
@@ -0,0 +1,185 @@
+#include "freelist.h"
+
+#include "core/kmemory.h"
+#include "core/logger.h"
+
+// Free ranges are tracked intrusively: each one stores its own node in its first bytes,
+// kept in address order so that neighbouring ranges can be merged when a block is freed.
+typedef struct freelist_node {
+    UInt64 size;
+    struct freelist_node* next;
+} freelist_node;
+
+STATIC_ASSERT(sizeof(freelist_node) <= FREELIST_ALIGNMENT, "A freelist node must fit in the smallest block.");
+
+static UInt64 freelist_block_size(UInt64 size) {
+    if (size == 0) {
+        size = 1;
+    }
+    return (size + (FREELIST_ALIGNMENT - 1)) & ~((UInt64)FREELIST_ALIGNMENT - 1);
+}
+
+void freelist_create(UInt64 total_size, void* memory, freelist* out_allocator) {
+    if (out_allocator) {
+        out_allocator->owns_memory = memory == 0;
+        if (memory) {
+            out_allocator->memory = memory;
+        }
+        else {
+            out_allocator->memory = kallocate(total_size, MEMORY_TAG_FREELIST);
+        }
+
+        // Only whole, aligned blocks are managed; any leftover tail is never handed out.
+        out_allocator->total_size = total_size & ~((UInt64)FREELIST_ALIGNMENT - 1);
+        out_allocator->allocated = 0;
+        out_allocator->head = 0;
+
+        if (((UInt64)out_allocator->memory & (FREELIST_ALIGNMENT - 1)) != 0) {
+            KERROR("freelist_create - provided memory is not %i-byte aligned.", FREELIST_ALIGNMENT);
+        }
+
+        freelist_free_all(out_allocator);
+    }
+}
+
+void freelist_destroy(freelist* allocator) {
+    if (allocator) {
+        if (allocator->owns_memory && allocator->memory) {
+            kfree(allocator->memory, allocator->total_size, MEMORY_TAG_FREELIST);
+        }
+
+        allocator->memory = 0;
+        allocator->head = 0;
+        allocator->total_size = 0;
+        allocator->allocated = 0;
+        allocator->owns_memory = FALSE;
+    }
+}
+
+void* freelist_allocate(freelist* allocator, UInt64 size) {
+    if (!allocator || !allocator->memory) {
+        KERROR("freelist_allocate - provided allocator not initialized.");
+        return 0;
+    }
+
+    size = freelist_block_size(size);
+
+    // Best fit: take the smallest free range that can hold the request.
+    freelist_node* best = 0;
+    freelist_node* best_previous = 0;
+    freelist_node* previous = 0;
+    freelist_node* node = allocator->head;
+    while (node) {
+        if (node->size >= size && (!best || node->size < best->size)) {
+            best = node;
+            best_previous = previous;
+            if (node->size == size) {
+                break;
+            }
+        }
+        previous = node;
+        node = node->next;
+    }
+
+    if (!best) {
+        return 0;
+    }
+
+    freelist_node* next = best->next;
+    if (best->size > size) {
+        freelist_node* remainder = (freelist_node*)((UInt8*)best + size);
+        remainder->size = best->size - size;
+        remainder->next = best->next;
+        next = remainder;
+    }
+
+    if (best_previous) {
+        best_previous->next = next;
+    }
+    else {
+        allocator->head = next;
+    }
+
+    allocator->allocated += size;
+    return best;
+}
+
+Boolean freelist_free(freelist* allocator, void* block, UInt64 size) {
+    if (!allocator || !allocator->memory || !block) {
+        return FALSE;
+    }
+
+    if (!freelist_owns_block(allocator, block)) {
+        KERROR("freelist_free - block %p does not belong to this allocator.", block);
+        return FALSE;
+    }
+
+    size = freelist_block_size(size);
+    UInt8* start = block;
+
+    freelist_node* previous = 0;
+    freelist_node* next = allocator->head;
+    while (next && (UInt8*)next < start) {
+        previous = next;
+        next = next->next;
+    }
+
+    if ((previous && (UInt8*)previous + previous->size > start) || (next && start + size > (UInt8*)next)) {
+        KERROR("freelist_free - block %p (%lluB) overlaps free space. Double free or wrong size?", block, size);
+        return FALSE;
+    }
+
+    freelist_node* node = (freelist_node*)start;
+    node->size = size;
+    node->next = next;
+
+    if (next && start + size == (UInt8*)next) {
+        node->size += next->size;
+        node->next = next->next;
+    }
+
+    if (previous) {
+        if ((UInt8*)previous + previous->size == start) {
+            previous->size += node->size;
+            previous->next = node->next;
+        }
+        else {
+            previous->next = node;
+        }
+    }
+    else {
+        allocator->head = node;
+    }
+
+    allocator->allocated -= size;
+    return TRUE;
+}
+
+void freelist_free_all(freelist* allocator) {
+    if (allocator && allocator->memory) {
+        allocator->allocated = 0;
+        allocator->head = 0;
+        if (allocator->total_size >= FREELIST_ALIGNMENT) {
+            allocator->head = allocator->memory;
+            allocator->head->size = allocator->total_size;
+            allocator->head->next = 0;
+        }
+    }
+}
+
+Boolean freelist_owns_block(freelist* allocator, void* block) {
+    if (!allocator || !allocator->memory) {
+        return FALSE;
+    }
+
+    UInt8* start = allocator->memory;
+    return (UInt8*)block >= start && (UInt8*)block < start + allocator->total_size;
+}
+
+UInt64 freelist_free_space(freelist* allocator) {
+    if (!allocator) {
+        return 0;
+    }
+
+    return allocator->total_size - allocator->allocated;
+}
\ No newline at end of file
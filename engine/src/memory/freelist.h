@@ -0,0 +1,26 @@
+#pragma once
+
+#include "defines.h"
+
+// Every block handed out by a freelist is a multiple of this size and aligned to it.
+#define FREELIST_ALIGNMENT 16
+
+struct freelist_node;
+
+typedef struct freelist {
+    UInt64 total_size;
+    UInt64 allocated;
+    void* memory;
+    Boolean owns_memory;
+    struct freelist_node* head;
+} freelist;
+
+KAPI void freelist_create(UInt64 total_size, void* memory, freelist* out_allocator);
+KAPI void freelist_destroy(freelist* allocator);
+
+KAPI void* freelist_allocate(freelist* allocator, UInt64 size);
+KAPI Boolean freelist_free(freelist* allocator, void* block, UInt64 size);
+KAPI void freelist_free_all(freelist* allocator);
+
+KAPI Boolean freelist_owns_block(freelist* allocator, void* block);
+KAPI UInt64 freelist_free_space(freelist* allocator);
\ No newline at end of file
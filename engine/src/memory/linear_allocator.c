@@ -2,12 +2,19 @@
 
 #include "core/kmemory.h"
 #include "core/logger.h"
+#include "platform/platform.h"
+
+static UInt64 round_up(UInt64 value, UInt64 granularity) {
+    return (value + granularity - 1) / granularity * granularity;
+}
 
 KAPI void linear_allocator_create(UInt64 total_size, void* memory, linear_allocator* out_allocator) {
     if (out_allocator) {
         out_allocator->total_size = total_size;
         out_allocator->allocated = 0;
         out_allocator->owns_memory = memory == 0;
+        out_allocator->is_reserved = FALSE;
+        out_allocator->committed = 0;
         if (memory) {
             out_allocator->memory = memory;
         }
@@ -17,30 +24,84 @@ KAPI void linear_allocator_create(UInt64 total_size, void* memory, linear_alloca
     }
 }
 
+KAPI Boolean linear_allocator_create_reserved(UInt64 total_size, linear_allocator* out_allocator) {
+    if (!out_allocator) {
+        return FALSE;
+    }
+
+    kzero_memory(out_allocator, sizeof(linear_allocator));
+    out_allocator->memory = platform_reserve(round_up(total_size, platform_get_page_size()));
+    if (!out_allocator->memory) {
+        return FALSE;
+    }
+    out_allocator->total_size = total_size;
+    out_allocator->owns_memory = TRUE;
+    out_allocator->is_reserved = TRUE;
+    return TRUE;
+}
+
+// Commits whole pieces until the first end bytes are usable.
+static Boolean commit_to(linear_allocator* allocator, UInt64 end) {
+    UInt64 page_size = platform_get_page_size();
+    UInt64 granularity = round_up(LINEAR_ALLOCATOR_COMMIT_SIZE, page_size);
+    UInt64 new_committed = round_up(end, granularity);
+    UInt64 reserved = round_up(allocator->total_size, page_size);
+    if (new_committed > reserved) {
+        new_committed = reserved;
+    }
+
+    if (!platform_commit((UInt8*)allocator->memory + allocator->committed, new_committed - allocator->committed, FALSE)) {
+        return FALSE;
+    }
+    allocator->committed = new_committed;
+    return TRUE;
+}
+
 KAPI void linear_allocator_destroy(linear_allocator* allocator) {
     if (allocator) {
-        allocator->total_size = 0;
         allocator->allocated = 0;
-        if (allocator->owns_memory && allocator->memory) {
+        if (allocator->is_reserved) {
+            platform_release(allocator->memory, round_up(allocator->total_size, platform_get_page_size()));
+        }
+        else if (allocator->owns_memory && allocator->memory) {
             kfree(allocator->memory, allocator->total_size, MEMORY_TAG_LINEAR_ALLOC);
         }
 
         allocator->memory = 0;
         allocator->total_size = 0;
         allocator->owns_memory = FALSE;
+        allocator->is_reserved = FALSE;
+        allocator->committed = 0;
     }
 }
 
 KAPI void* linear_allocator_allocate(linear_allocator* allocator, UInt64 size) {
+    return linear_allocator_allocate_aligned(allocator, size, 1);
+}
+
+KAPI void* linear_allocator_allocate_aligned(linear_allocator* allocator, UInt64 size, UInt16 alignment) {
     if (allocator && allocator->memory) {
-        if (allocator->allocated + size > allocator->total_size) {
+        if (alignment == 0 || (alignment & (alignment - 1)) != 0) {
+            KERROR("linear_allocator_allocate_aligned - alignment must be a power of two, got %u.", alignment);
+            return 0;
+        }
+
+        UInt64 address = (UInt64)allocator->memory + allocator->allocated;
+        UInt64 padding = ((address + alignment - 1) & ~((UInt64)alignment - 1)) - address;
+        if (allocator->allocated + padding + size > allocator->total_size) {
             UInt64 remaining = allocator->total_size - allocator->allocated;
-            KERROR("linear_allocator_allocate - Tried to allocate %lluB, only %lluB remaining.", size, remaining);
+            KERROR("linear_allocator_allocate - Tried to allocate %lluB, only %lluB remaining.", size + padding, remaining);
             return 0;
         }
 
-        void* block = ((UInt8*)allocator->memory) + allocator->allocated;
-        allocator->allocated += size;
+        UInt64 end = allocator->allocated + padding + size;
+        if (allocator->is_reserved && end > allocator->committed && !commit_to(allocator, end)) {
+            KERROR("linear_allocator_allocate - could not commit memory for %lluB.", size + padding);
+            return 0;
+        }
+
+        void* block = ((UInt8*)allocator->memory) + allocator->allocated + padding;
+        allocator->allocated += padding + size;
         return block;
     }
 
@@ -51,6 +112,16 @@ KAPI void* linear_allocator_allocate(linear_allocator* allocator, UInt64 size) {
 KAPI void linear_allocator_free_all(linear_allocator* allocator) {
     if (allocator && allocator->memory) {
         allocator->allocated = 0;
-        kzero_memory(allocator->memory, allocator->total_size);
+        if (!allocator->is_reserved) {
+            kzero_memory(allocator->memory, allocator->total_size);
+            return;
+        }
+
+        // Pages past the first piece go back to the OS, and come back zeroed when recommitted.
+        UInt64 keep = round_up(LINEAR_ALLOCATOR_COMMIT_SIZE, platform_get_page_size());
+        if (allocator->committed > keep && platform_decommit((UInt8*)allocator->memory + keep, allocator->committed - keep)) {
+            allocator->committed = keep;
+        }
+        kzero_memory(allocator->memory, allocator->committed);
     }
 }
\ No newline at end of file
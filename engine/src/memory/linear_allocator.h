@@ -2,15 +2,26 @@
 
 #include "defines.h"
 
+// Reserved allocators commit address space in pieces of at least this size.
+#define LINEAR_ALLOCATOR_COMMIT_SIZE KIBIBYTES(64)
+
 typedef struct linear_allocator {
-    UInt32 total_size;
+    UInt64 total_size;
     UInt64 allocated;
     void* memory;
     Boolean owns_memory;
+    // Set when memory is reserved address space that is committed as allocations reach it.
+    Boolean is_reserved;
+    UInt64 committed;
 } linear_allocator;
 
 KAPI void linear_allocator_create(UInt64 total_size, void* memory, linear_allocator* out_allocator);
+// Reserves total_size bytes of address space, so a large allocator costs nothing until it is
+// used and never has to move to grow.
+KAPI Boolean linear_allocator_create_reserved(UInt64 total_size, linear_allocator* out_allocator);
 KAPI void linear_allocator_destroy(linear_allocator* allocator);
 
 KAPI void* linear_allocator_allocate(linear_allocator* allocator, UInt64 size);
+// alignment must be a power of two. Padding skipped to reach it counts as allocated.
+KAPI void* linear_allocator_allocate_aligned(linear_allocator* allocator, UInt64 size, UInt16 alignment);
 KAPI void linear_allocator_free_all(linear_allocator* allocator);
\ No newline at end of file
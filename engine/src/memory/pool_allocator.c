@@ -0,0 +1,195 @@
+#include "pool_allocator.h"
+
+#include "core/logger.h"
+
+typedef struct pool_allocator_chunk {
+    struct pool_allocator_chunk* next;
+    UInt64 size;
+} pool_allocator_chunk;
+
+static UInt64 pool_stride(UInt64 block_size, UInt64 alignment) {
+    UInt64 size = block_size < sizeof(void*) ? sizeof(void*) : block_size;
+    return (size + alignment - 1) & ~(alignment - 1);
+}
+
+static void* align_pointer(void* pointer, UInt64 alignment) {
+    return (void*)(((UInt64)pointer + alignment - 1) & ~(alignment - 1));
+}
+
+// Pushes every block of a region onto the free list, lowest address on top.
+static void pool_push_region(pool_allocator* allocator, void* region, UInt64 block_count) {
+    UInt8* start = align_pointer(region, allocator->alignment);
+    for (UInt64 i = block_count; i > 0; --i) {
+        void** block = (void**)(start + (i - 1) * allocator->stride);
+        *block = allocator->free_list;
+        allocator->free_list = block;
+    }
+}
+
+static Boolean pool_region_contains(pool_allocator* allocator, void* region, void* block) {
+    UInt8* start = align_pointer(region, allocator->alignment);
+    if ((UInt8*)block < start) {
+        return FALSE;
+    }
+
+    UInt64 offset = (UInt8*)block - start;
+    return offset < allocator->stride * allocator->blocks_per_chunk && offset % allocator->stride == 0;
+}
+
+static Boolean pool_grow(pool_allocator* allocator) {
+    UInt64 data_size = pool_allocator_memory_requirement(allocator->block_size, allocator->alignment, allocator->blocks_per_chunk);
+    UInt64 chunk_size = sizeof(pool_allocator_chunk) + data_size;
+    pool_allocator_chunk* chunk = kallocate(chunk_size, allocator->tag);
+    if (!chunk) {
+        return FALSE;
+    }
+
+    chunk->size = chunk_size;
+    chunk->next = allocator->chunks;
+    allocator->chunks = chunk;
+
+    pool_push_region(allocator, chunk + 1, allocator->blocks_per_chunk);
+    allocator->block_count += allocator->blocks_per_chunk;
+    return TRUE;
+}
+
+UInt64 pool_allocator_memory_requirement(UInt64 block_size, UInt64 alignment, UInt64 block_count) {
+    // Leaves room to align the first block regardless of where the memory starts.
+    return pool_stride(block_size, alignment) * block_count + alignment - 1;
+}
+
+Boolean pool_allocator_create(
+    UInt64 block_size,
+    UInt64 alignment,
+    UInt64 blocks_per_chunk,
+    Boolean can_grow,
+    memory_tag tag,
+    void* memory,
+    pool_allocator* out_allocator) {
+    if (!out_allocator) {
+        return FALSE;
+    }
+
+    if (alignment == 0 || (alignment & (alignment - 1)) != 0) {
+        KERROR("pool_allocator_create - alignment must be a power of two, got %llu.", alignment);
+        return FALSE;
+    }
+
+    if (block_size == 0 || blocks_per_chunk == 0) {
+        KERROR("pool_allocator_create - block size and block count must be non-zero.");
+        return FALSE;
+    }
+
+    out_allocator->block_size = block_size;
+    out_allocator->alignment = alignment;
+    out_allocator->stride = pool_stride(block_size, alignment);
+    out_allocator->blocks_per_chunk = blocks_per_chunk;
+    out_allocator->block_count = blocks_per_chunk;
+    out_allocator->allocated_count = 0;
+    out_allocator->can_grow = can_grow;
+    out_allocator->tag = tag;
+    out_allocator->free_list = 0;
+    out_allocator->chunks = 0;
+    out_allocator->owns_memory = memory == 0;
+    if (memory) {
+        out_allocator->memory = memory;
+    }
+    else {
+        out_allocator->memory = kallocate(pool_allocator_memory_requirement(block_size, alignment, blocks_per_chunk), tag);
+        if (!out_allocator->memory) {
+            KERROR("pool_allocator_create - failed to allocate %llu blocks.", blocks_per_chunk);
+            kzero_memory(out_allocator, sizeof(pool_allocator));
+            return FALSE;
+        }
+    }
+
+    pool_push_region(out_allocator, out_allocator->memory, blocks_per_chunk);
+    return TRUE;
+}
+
+void pool_allocator_destroy(pool_allocator* allocator) {
+    if (allocator) {
+        pool_allocator_chunk* chunk = allocator->chunks;
+        while (chunk) {
+            pool_allocator_chunk* next = chunk->next;
+            kfree(chunk, chunk->size, allocator->tag);
+            chunk = next;
+        }
+
+        if (allocator->owns_memory && allocator->memory) {
+            kfree(allocator->memory, pool_allocator_memory_requirement(allocator->block_size, allocator->alignment, allocator->blocks_per_chunk), allocator->tag);
+        }
+
+        allocator->memory = 0;
+        allocator->chunks = 0;
+        allocator->free_list = 0;
+        allocator->block_count = 0;
+        allocator->allocated_count = 0;
+        allocator->owns_memory = FALSE;
+    }
+}
+
+void* pool_allocator_allocate(pool_allocator* allocator) {
+    if (!allocator || !allocator->memory) {
+        KERROR("pool_allocator_allocate - provided allocator not initialized.");
+        return 0;
+    }
+
+    if (!allocator->free_list) {
+        if (!allocator->can_grow || !pool_grow(allocator)) {
+            KERROR("pool_allocator_allocate - pool of %llu blocks is exhausted.", allocator->block_count);
+            return 0;
+        }
+    }
+
+    void** block = allocator->free_list;
+    allocator->free_list = *block;
+    allocator->allocated_count++;
+    return block;
+}
+
+Boolean pool_allocator_free(pool_allocator* allocator, void* block) {
+    if (!allocator || !block) {
+        return FALSE;
+    }
+
+    if (((UInt64)block & (allocator->alignment - 1)) != 0) {
+        KERROR("pool_allocator_free - block %p is not %llu-byte aligned and cannot belong to this pool.", block, allocator->alignment);
+        return FALSE;
+    }
+
+#ifdef _DEBUG
+    Boolean owned = pool_region_contains(allocator, allocator->memory, block);
+    for (pool_allocator_chunk* chunk = allocator->chunks; chunk && !owned; chunk = chunk->next) {
+        owned = pool_region_contains(allocator, chunk + 1, block);
+    }
+    if (!owned) {
+        KERROR("pool_allocator_free - block %p does not belong to this pool.", block);
+        return FALSE;
+    }
+#endif
+
+    if (allocator->allocated_count == 0) {
+        KERROR("pool_allocator_free - no blocks are allocated. Double free?");
+        return FALSE;
+    }
+
+    *(void**)block = allocator->free_list;
+    allocator->free_list = block;
+    allocator->allocated_count--;
+    return TRUE;
+}
+
+void pool_allocator_free_all(pool_allocator* allocator) {
+    if (allocator && allocator->memory) {
+        allocator->free_list = 0;
+        allocator->allocated_count = 0;
+
+        pool_allocator_chunk* chunk = allocator->chunks;
+        while (chunk) {
+            pool_push_region(allocator, chunk + 1, allocator->blocks_per_chunk);
+            chunk = chunk->next;
+        }
+        pool_push_region(allocator, allocator->memory, allocator->blocks_per_chunk);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "defines.h"
+#include "core/kmemory.h"
+
+struct pool_allocator_chunk;
+
+// Hands out fixed-size blocks in O(1). Free blocks form an intrusive singly linked list,
+// so a block must be able to hold a pointer; smaller sizes are rounded up.
+typedef struct pool_allocator {
+    UInt64 block_size;
+    UInt64 alignment;
+    // Distance between consecutive blocks: block_size rounded up to alignment.
+    UInt64 stride;
+    UInt64 blocks_per_chunk;
+    UInt64 block_count;
+    UInt64 allocated_count;
+    Boolean can_grow;
+    memory_tag tag;
+    void* free_list;
+    void* memory;
+    Boolean owns_memory;
+    struct pool_allocator_chunk* chunks;
+} pool_allocator;
+
+// Bytes of caller memory needed to back a pool of block_count blocks.
+KAPI UInt64 pool_allocator_memory_requirement(UInt64 block_size, UInt64 alignment, UInt64 block_count);
+
+// alignment must be a power of two. If memory is provided it must hold
+// pool_allocator_memory_requirement() bytes. If can_grow is set, another chunk of
+// blocks_per_chunk blocks is allocated with tag whenever the pool runs out.
+KAPI Boolean pool_allocator_create(
+    UInt64 block_size,
+    UInt64 alignment,
+    UInt64 blocks_per_chunk,
+    Boolean can_grow,
+    memory_tag tag,
+    void* memory,
+    pool_allocator* out_allocator);
+KAPI void pool_allocator_destroy(pool_allocator* allocator);
+
+KAPI void* pool_allocator_allocate(pool_allocator* allocator);
+KAPI Boolean pool_allocator_free(pool_allocator* allocator, void* block);
+KAPI void pool_allocator_free_all(pool_allocator* allocator);
\ No newline at end of file
@@ -0,0 +1,109 @@
+#include "stack_allocator.h"
+
+#include "core/kmemory.h"
+#include "core/logger.h"
+
+Boolean stack_allocator_create(UInt64 total_size, void* memory, stack_allocator* out_allocator) {
+    if (!out_allocator) {
+        return FALSE;
+    }
+
+    kzero_memory(out_allocator, sizeof(stack_allocator));
+    out_allocator->owns_memory = memory == 0;
+    if (memory) {
+        out_allocator->memory = memory;
+    } else {
+        out_allocator->memory = kallocate(total_size, MEMORY_TAG_LINEAR_ALLOC);
+        if (!out_allocator->memory) {
+            KERROR("stack_allocator_create - failed to allocate %llu bytes.", total_size);
+            kzero_memory(out_allocator, sizeof(stack_allocator));
+            return FALSE;
+        }
+    }
+    out_allocator->total_size = total_size;
+    return TRUE;
+}
+
+void stack_allocator_destroy(stack_allocator* allocator) {
+    if (allocator) {
+        if (allocator->owns_memory && allocator->memory) {
+            kfree(allocator->memory, allocator->total_size, MEMORY_TAG_LINEAR_ALLOC);
+        }
+        kzero_memory(allocator, sizeof(stack_allocator));
+    }
+}
+
+void* stack_allocator_allocate(stack_allocator* allocator, UInt64 size) {
+    return stack_allocator_allocate_aligned(allocator, size, 1);
+}
+
+void* stack_allocator_allocate_aligned(stack_allocator* allocator, UInt64 size, UInt16 alignment) {
+    if (!allocator || !allocator->memory) {
+        KERROR("stack_allocator_allocate - provided allocator not initialized.");
+        return 0;
+    }
+
+    if (alignment == 0 || (alignment & (alignment - 1)) != 0) {
+        KERROR("stack_allocator_allocate_aligned - alignment must be a power of two, got %u.", alignment);
+        return 0;
+    }
+
+    UInt64 address = (UInt64)allocator->memory + allocator->allocated;
+    UInt64 padding = ((address + alignment - 1) & ~((UInt64)alignment - 1)) - address;
+    if (allocator->allocated + padding + size > allocator->total_size) {
+        UInt64 remaining = allocator->total_size - allocator->allocated;
+        KERROR("stack_allocator_allocate - Tried to allocate %lluB, only %lluB remaining.", size + padding, remaining);
+        return 0;
+    }
+
+    void* block = ((UInt8*)allocator->memory) + allocator->allocated + padding;
+    allocator->allocated += padding + size;
+    if (allocator->allocated > allocator->peak_allocated) {
+        allocator->peak_allocated = allocator->allocated;
+    }
+    return block;
+}
+
+stack_allocator_marker stack_allocator_get_marker(stack_allocator* allocator) {
+#if defined(_DEBUG)
+    if (allocator->open_marker_count < STACK_ALLOCATOR_MAX_MARKERS) {
+        allocator->open_markers[allocator->open_marker_count] = allocator->allocated;
+    } else if (allocator->open_marker_count == STACK_ALLOCATOR_MAX_MARKERS) {
+        KWARN("stack_allocator_get_marker - more than %u markers open; the deepest are not checked.", STACK_ALLOCATOR_MAX_MARKERS);
+    }
+    allocator->open_marker_count++;
+#endif
+    return allocator->allocated;
+}
+
+Boolean stack_allocator_free_to_marker(stack_allocator* allocator, stack_allocator_marker marker) {
+    if (marker > allocator->allocated) {
+        // Its memory has already been released by freeing to an earlier marker.
+        KERROR("stack_allocator_free_to_marker - marker %llu is above the top of the stack (%llu).", marker, allocator->allocated);
+        return FALSE;
+    }
+
+#if defined(_DEBUG)
+    if (allocator->open_marker_count == 0) {
+        KERROR("stack_allocator_free_to_marker - no markers are open.");
+        return FALSE;
+    }
+    UInt32 top = allocator->open_marker_count - 1;
+    if (top < STACK_ALLOCATOR_MAX_MARKERS && allocator->open_markers[top] != marker) {
+        KERROR("stack_allocator_free_to_marker - freed to %llu out of order; the innermost open marker is %llu.",
+               marker, allocator->open_markers[top]);
+        return FALSE;
+    }
+    allocator->open_marker_count--;
+#endif
+
+    allocator->allocated = marker;
+    return TRUE;
+}
+
+void stack_allocator_free_all(stack_allocator* allocator) {
+    if (allocator) {
+        allocator->allocated = 0;
+        allocator->open_marker_count = 0;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "defines.h"
+
+// Deepest nesting of markers that debug builds check for out-of-order frees.
+#define STACK_ALLOCATOR_MAX_MARKERS 64
+
+// Where the top of a stack allocator was; freeing to it releases everything allocated since.
+typedef UInt64 stack_allocator_marker;
+
+// A linear allocator that can also roll back to an earlier point, so nested temporaries can be
+// released innermost first without touching the heap. Not thread safe.
+typedef struct stack_allocator {
+    UInt64 total_size;
+    UInt64 allocated;
+    // Largest value allocated has reached since creation.
+    UInt64 peak_allocated;
+    void* memory;
+    Boolean owns_memory;
+    // Markers handed out and not yet freed to. Only kept in debug builds.
+    UInt32 open_marker_count;
+    stack_allocator_marker open_markers[STACK_ALLOCATOR_MAX_MARKERS];
+} stack_allocator;
+
+KAPI Boolean stack_allocator_create(UInt64 total_size, void* memory, stack_allocator* out_allocator);
+KAPI void stack_allocator_destroy(stack_allocator* allocator);
+
+KAPI void* stack_allocator_allocate(stack_allocator* allocator, UInt64 size);
+// alignment must be a power of two. Padding skipped to reach it counts as allocated.
+KAPI void* stack_allocator_allocate_aligned(stack_allocator* allocator, UInt64 size, UInt16 alignment);
+
+KAPI stack_allocator_marker stack_allocator_get_marker(stack_allocator* allocator);
+// Releases everything allocated since marker was taken. Markers must be freed to in the reverse
+// of the order they were taken; debug builds refuse anything else and return FALSE.
+KAPI Boolean stack_allocator_free_to_marker(stack_allocator* allocator, stack_allocator_marker marker);
+KAPI void stack_allocator_free_all(stack_allocator* allocator);
\ No newline at end of file
@@ -92,11 +92,20 @@ Boolean filesystem_read(file_handle* handle, UInt64 data_size, void* out_data, U
     return FALSE;
 }
 
-Boolean filesystem_read_all_bytes(file_handle* handle, UInt8** out_bytes, UInt64* out_bytes_read) {
+Boolean filesystem_size(file_handle* handle, UInt64* out_size) {
     if (handle->handle) {
         fseek((FILE*)handle->handle, 0, SEEK_END);
-        UInt64 size = ftell((FILE*)handle->handle);
+        *out_size = ftell((FILE*)handle->handle);
         rewind((FILE*)handle->handle);
+        return TRUE;
+    }
+
+    return FALSE;
+}
+
+Boolean filesystem_read_all_bytes(file_handle* handle, UInt8** out_bytes, UInt64* out_bytes_read) {
+    UInt64 size = 0;
+    if (filesystem_size(handle, &size)) {
 
         *out_bytes = kallocate(sizeof(UInt8) * size, MEMORY_TAG_STRING);
         *out_bytes_read = fread(*out_bytes, 1, size, (FILE*)handle->handle);
@@ -24,6 +24,9 @@ KAPI Boolean filesystem_write_line(file_handle* handle, const char* text);
 
 KAPI Boolean filesystem_read(file_handle* handle, UInt64 data_size, void* out_data, UInt64* out_bytes_read);
 
+// The size of the whole file, in bytes. Leaves the read position at the start.
+KAPI Boolean filesystem_size(file_handle* handle, UInt64* out_size);
+
 KAPI Boolean filesystem_read_all_bytes(file_handle* handle, UInt8** out_bytes, UInt64* out_bytes_read);
 
 KAPI Boolean filesystem_write(file_handle* handle, UInt64 data_size, const void* data, UInt64* out_bytes_written);
\ No newline at end of file
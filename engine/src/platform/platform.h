@@ -2,6 +2,7 @@
 
 #include "defines.h"
 
+// A headless startup creates no window, so nothing is shown and no window messages arrive.
 Boolean platform_system_startup(
     UInt64* memory_requirement,
     void* state,
@@ -9,14 +10,34 @@ Boolean platform_system_startup(
     Int32 x,
     Int32 y,
     Int32 width,
-    Int32 height);
+    Int32 height,
+    Boolean headless);
 
 void platform_system_shutdown(void* plat_state);
 
 Boolean platform_pump_messages();
 
+// Blocks until the OS has a message for the application, or timeout_ms passes.
+void platform_wait_messages(UInt64 timeout_ms);
+
 void* platform_allocate(UInt64 size, Boolean aligned);
 void platform_free(void* block, Boolean aligned);
+void* platform_allocate_aligned(UInt64 size, UInt64 alignment);
+void platform_free_aligned(void* block);
+
+// Address space can be reserved without using any memory, then committed a piece at a time.
+// Addresses and sizes passed to commit and decommit must be multiples of the page size.
+KAPI UInt64 platform_get_page_size();
+// Returns 0 on failure. Reserved memory can't be touched until it is committed.
+KAPI void* platform_reserve(UInt64 size);
+// Committed memory reads as zero until written. large_pages asks for transparent huge pages
+// where the OS offers them, which cuts TLB misses over big regions; it is only a hint.
+KAPI Boolean platform_commit(void* address, UInt64 size, Boolean large_pages);
+// Gives the pages back to the OS and makes the range untouchable again, still reserved.
+KAPI Boolean platform_decommit(void* address, UInt64 size);
+// size must be the size that was reserved.
+KAPI void platform_release(void* address, UInt64 size);
+
 void* platform_zero_memory(void* block, UInt64 size);
 void* platform_copy_memory(void* dest, const void* source, UInt64 size);
 void* platform_set_memory(void* dest, Int32 value, UInt64 size);
@@ -26,4 +47,42 @@ void platform_console_write_error(const char* message, UInt8 color);
 
 Double platform_get_absolute_time();
 
-void platform_sleep(UInt64 ms);
\ No newline at end of file
+// A cheap monotonic tick count for timing very short spans. Its frequency is unspecified;
+// calibrate it against platform_get_absolute_time.
+KAPI UInt64 platform_get_timestamp();
+
+KAPI void platform_sleep(UInt64 ms);
+
+KAPI Int32 platform_get_processor_count();
+
+typedef UInt32 (*pfn_thread_start)(void* params);
+
+typedef struct kthread {
+    void* internal_data;
+    UInt64 thread_id;
+} kthread;
+
+typedef struct kmutex {
+    void* internal_data;
+} kmutex;
+
+typedef struct ksemaphore {
+    void* internal_data;
+} ksemaphore;
+
+KAPI Boolean platform_thread_create(pfn_thread_start start_function, void* params, kthread* out_thread);
+// Waits for the thread to finish, then releases it.
+KAPI void platform_thread_destroy(kthread* thread);
+KAPI UInt64 platform_current_thread_id();
+
+// Mutexes are recursive: the thread holding one may lock it again, and must unlock it as often.
+KAPI Boolean platform_mutex_create(kmutex* out_mutex);
+KAPI void platform_mutex_destroy(kmutex* mutex);
+KAPI Boolean platform_mutex_lock(kmutex* mutex);
+KAPI Boolean platform_mutex_unlock(kmutex* mutex);
+
+KAPI Boolean platform_semaphore_create(ksemaphore* out_semaphore, UInt32 max_count, UInt32 start_count);
+KAPI void platform_semaphore_destroy(ksemaphore* semaphore);
+KAPI Boolean platform_semaphore_signal(ksemaphore* semaphore);
+// Returns FALSE if the timeout elapsed before the semaphore was signalled.
+KAPI Boolean platform_semaphore_wait(ksemaphore* semaphore, UInt64 timeout_ms);
\ No newline at end of file
@@ -0,0 +1,405 @@
+#include "platform.h"
+
+#if KPLATFORM_LINUX
+
+#include "containers/darray.h"
+
+#include "core/logger.h"
+#include "core/kstring.h"
+
+#include <errno.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include <vulkan/vulkan.h>
+#include "renderer/vulkan/vulkan_types.inl"
+
+// The Linux platform layer runs headless: no window is created and no OS messages
+// are pumped, so the engine core can run unattended on machines with no display.
+typedef struct platform_state {
+    Boolean headless_surface_supported;
+    VkSurfaceKHR surface;
+} platform_state;
+
+static platform_state* state_ptr;
+
+Boolean platform_system_startup(
+    UInt64 *memory_requirement,
+    void *state,
+    const char* application_name,
+    Int32 x,
+    Int32 y,
+    Int32 width,
+    Int32 height,
+    Boolean headless) {
+
+    *memory_requirement = sizeof(platform_state);
+
+    if (state == 0) {
+        return TRUE;
+    }
+
+    state_ptr = state;
+    state_ptr->headless_surface_supported = FALSE;
+    state_ptr->surface = 0;
+
+    KINFO("Linux platform started in headless mode for '%s' (%ix%i).", application_name, width, height);
+
+    return TRUE;
+}
+
+void platform_system_shutdown(void *plat_state) {
+    state_ptr = 0;
+}
+
+Boolean platform_pump_messages() {
+    // There is no window, so there are no messages to process.
+    return TRUE;
+}
+
+void platform_wait_messages(UInt64 timeout_ms) {
+    // Nothing can arrive, so this is just the wait.
+    platform_sleep(timeout_ms);
+}
+
+void* platform_allocate(UInt64 size, Boolean aligned) {
+    if (aligned) {
+        void* block = 0;
+        if (posix_memalign(&block, 16, size) != 0) {
+            return 0;
+        }
+        return block;
+    }
+
+    return malloc(size);
+}
+
+void platform_free(void* block, Boolean aligned) {
+    free(block);
+}
+
+void* platform_allocate_aligned(UInt64 size, UInt64 alignment) {
+    void* block = 0;
+    if (alignment < sizeof(void*)) {
+        alignment = sizeof(void*);
+    }
+    if (posix_memalign(&block, alignment, size) != 0) {
+        return 0;
+    }
+    return block;
+}
+
+void platform_free_aligned(void* block) {
+    free(block);
+}
+
+UInt64 platform_get_page_size() {
+    long size = sysconf(_SC_PAGESIZE);
+    return size > 0 ? (UInt64)size : 4096;
+}
+
+void* platform_reserve(UInt64 size) {
+    void* block = mmap(0, size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (block == MAP_FAILED) {
+        KERROR("platform_reserve - could not reserve %llu bytes: error %i.", size, errno);
+        return 0;
+    }
+    return block;
+}
+
+Boolean platform_commit(void* address, UInt64 size, Boolean large_pages) {
+    // Anonymous pages are only backed when first touched, so this costs nothing up front.
+    if (mprotect(address, size, PROT_READ | PROT_WRITE) != 0) {
+        KERROR("platform_commit - could not commit %llu bytes at %p: error %i.", size, address, errno);
+        return FALSE;
+    }
+#if defined(MADV_HUGEPAGE)
+    if (large_pages) {
+        madvise(address, size, MADV_HUGEPAGE);
+    }
+#endif
+    return TRUE;
+}
+
+Boolean platform_decommit(void* address, UInt64 size) {
+    if (madvise(address, size, MADV_DONTNEED) != 0 || mprotect(address, size, PROT_NONE) != 0) {
+        KERROR("platform_decommit - could not decommit %llu bytes at %p: error %i.", size, address, errno);
+        return FALSE;
+    }
+    return TRUE;
+}
+
+void platform_release(void* address, UInt64 size) {
+    if (address) {
+        munmap(address, size);
+    }
+}
+
+void* platform_zero_memory(void* block, UInt64 size) {
+    return memset(block, 0, size);
+}
+
+void* platform_copy_memory(void* dest, const void* source, UInt64 size) {
+    return memcpy(dest, source, size);
+}
+
+void* platform_set_memory(void* dest, Int32 value, UInt64 size) {
+    return memset(dest, value, size);
+}
+
+void platform_console_write(const char* message, UInt8 color) {
+    // FATAL, ERROR, WARN, INFO, DEBUG, TRACE
+    const char* color_strings[] = { "0;41", "1;31", "1;33", "1;32", "1;34", "1;30" };
+    fprintf(stdout, "\033[%sm%s\033[0m", color_strings[color], message);
+}
+
+void platform_console_write_error(const char* message, UInt8 color) {
+    // FATAL, ERROR, WARN, INFO, DEBUG, TRACE
+    const char* color_strings[] = { "0;41", "1;31", "1;33", "1;32", "1;34", "1;30" };
+    fprintf(stderr, "\033[%sm%s\033[0m", color_strings[color], message);
+}
+
+Double platform_get_absolute_time() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec * 0.000000001;
+}
+
+UInt64 platform_get_timestamp() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (UInt64)now.tv_sec * 1000000000ull + now.tv_nsec;
+#endif
+}
+
+void platform_sleep(UInt64 ms) {
+    struct timespec ts;
+    ts.tv_sec = ms / 1000;
+    ts.tv_nsec = (ms % 1000) * 1000 * 1000;
+    while (nanosleep(&ts, &ts) != 0) {
+        // Interrupted by a signal; keep sleeping for whatever remains.
+    }
+}
+
+Int32 platform_get_processor_count() {
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? (Int32)count : 1;
+}
+
+typedef struct linux_thread_start {
+    pfn_thread_start start_function;
+    void* params;
+} linux_thread_start;
+
+static void* linux_thread_trampoline(void* arg) {
+    linux_thread_start start = *(linux_thread_start*)arg;
+    platform_free(arg, FALSE);
+    start.start_function(start.params);
+    return 0;
+}
+
+Boolean platform_thread_create(pfn_thread_start start_function, void* params, kthread* out_thread) {
+    if (!start_function || !out_thread) {
+        return FALSE;
+    }
+
+    linux_thread_start* start = platform_allocate(sizeof(linux_thread_start), FALSE);
+    pthread_t* handle = platform_allocate(sizeof(pthread_t), FALSE);
+    if (!start || !handle) {
+        KERROR("Failed to create thread: out of memory.");
+        platform_free(start, FALSE);
+        platform_free(handle, FALSE);
+        return FALSE;
+    }
+    start->start_function = start_function;
+    start->params = params;
+
+    Int32 result = pthread_create(handle, 0, linux_thread_trampoline, start);
+    if (result != 0) {
+        KERROR("Failed to create thread: error %i.", result);
+        platform_free(start, FALSE);
+        platform_free(handle, FALSE);
+        return FALSE;
+    }
+
+    out_thread->internal_data = handle;
+    out_thread->thread_id = (UInt64)*handle;
+    return TRUE;
+}
+
+void platform_thread_destroy(kthread* thread) {
+    if (thread && thread->internal_data) {
+        pthread_join(*(pthread_t*)thread->internal_data, 0);
+        platform_free(thread->internal_data, FALSE);
+        thread->internal_data = 0;
+        thread->thread_id = 0;
+    }
+}
+
+UInt64 platform_current_thread_id() {
+    return (UInt64)syscall(SYS_gettid);
+}
+
+Boolean platform_mutex_create(kmutex* out_mutex) {
+    if (!out_mutex) {
+        return FALSE;
+    }
+
+    pthread_mutex_t* mutex = platform_allocate(sizeof(pthread_mutex_t), FALSE);
+    if (!mutex) {
+        KERROR("Failed to create mutex: out of memory.");
+        return FALSE;
+    }
+
+    // Recursive, to match the Win32 mutex.
+    pthread_mutexattr_t attributes;
+    pthread_mutexattr_init(&attributes);
+    pthread_mutexattr_settype(&attributes, PTHREAD_MUTEX_RECURSIVE);
+    Int32 result = pthread_mutex_init(mutex, &attributes);
+    pthread_mutexattr_destroy(&attributes);
+    if (result != 0) {
+        KERROR("Failed to create mutex.");
+        platform_free(mutex, FALSE);
+        return FALSE;
+    }
+
+    out_mutex->internal_data = mutex;
+    return TRUE;
+}
+
+void platform_mutex_destroy(kmutex* mutex) {
+    if (mutex && mutex->internal_data) {
+        pthread_mutex_destroy(mutex->internal_data);
+        platform_free(mutex->internal_data, FALSE);
+        mutex->internal_data = 0;
+    }
+}
+
+Boolean platform_mutex_lock(kmutex* mutex) {
+    return mutex && mutex->internal_data && pthread_mutex_lock(mutex->internal_data) == 0;
+}
+
+Boolean platform_mutex_unlock(kmutex* mutex) {
+    return mutex && mutex->internal_data && pthread_mutex_unlock(mutex->internal_data) == 0;
+}
+
+Boolean platform_semaphore_create(ksemaphore* out_semaphore, UInt32 max_count, UInt32 start_count) {
+    if (!out_semaphore) {
+        return FALSE;
+    }
+
+    // POSIX semaphores have no maximum count; max_count is only honoured on Windows.
+    sem_t* semaphore = platform_allocate(sizeof(sem_t), FALSE);
+    if (!semaphore) {
+        KERROR("Failed to create semaphore: out of memory.");
+        return FALSE;
+    }
+    if (sem_init(semaphore, 0, start_count) != 0) {
+        KERROR("Failed to create semaphore.");
+        platform_free(semaphore, FALSE);
+        return FALSE;
+    }
+
+    out_semaphore->internal_data = semaphore;
+    return TRUE;
+}
+
+void platform_semaphore_destroy(ksemaphore* semaphore) {
+    if (semaphore && semaphore->internal_data) {
+        sem_destroy(semaphore->internal_data);
+        platform_free(semaphore->internal_data, FALSE);
+        semaphore->internal_data = 0;
+    }
+}
+
+Boolean platform_semaphore_signal(ksemaphore* semaphore) {
+    return semaphore && semaphore->internal_data && sem_post(semaphore->internal_data) == 0;
+}
+
+Boolean platform_semaphore_wait(ksemaphore* semaphore, UInt64 timeout_ms) {
+    if (!semaphore || !semaphore->internal_data) {
+        return FALSE;
+    }
+
+    struct timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += timeout_ms / 1000;
+    deadline.tv_nsec += (timeout_ms % 1000) * 1000 * 1000;
+    if (deadline.tv_nsec >= 1000 * 1000 * 1000) {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000 * 1000 * 1000;
+    }
+
+    Int32 result;
+    while ((result = sem_timedwait(semaphore->internal_data, &deadline)) != 0 && errno == EINTR) {
+    }
+    return result == 0;
+}
+
+void platform_get_required_extension_names(const char*** names_darray) {
+    UInt32 available_count = 0;
+    vkEnumerateInstanceExtensionProperties(0, &available_count, 0);
+    VkExtensionProperties* available = darray_reserve(VkExtensionProperties, available_count);
+    vkEnumerateInstanceExtensionProperties(0, &available_count, available);
+
+    Boolean supported = FALSE;
+    for (UInt32 i = 0; i < available_count; ++i) {
+        if (strings_equal(available[i].extensionName, VK_EXT_HEADLESS_SURFACE_EXTENSION_NAME)) {
+            supported = TRUE;
+            break;
+        }
+    }
+    darray_destroy(available);
+
+    if (state_ptr) {
+        state_ptr->headless_surface_supported = supported;
+    }
+
+    if (supported) {
+        darray_push(*names_darray, &VK_EXT_HEADLESS_SURFACE_EXTENSION_NAME);
+    }
+    else {
+        KWARN("%s is not available from the installed Vulkan driver.", VK_EXT_HEADLESS_SURFACE_EXTENSION_NAME);
+    }
+}
+
+Boolean platform_create_vulkan_surface(vulkan_context *context) {
+    if (!state_ptr || !state_ptr->headless_surface_supported) {
+        KERROR("No surface: this platform is headless and the Vulkan driver has no headless surface support.");
+        return FALSE;
+    }
+
+    PFN_vkCreateHeadlessSurfaceEXT func =
+        (PFN_vkCreateHeadlessSurfaceEXT)vkGetInstanceProcAddr(context->instance, "vkCreateHeadlessSurfaceEXT");
+    if (!func) {
+        KERROR("No surface: vkCreateHeadlessSurfaceEXT could not be loaded.");
+        return FALSE;
+    }
+
+    VkHeadlessSurfaceCreateInfoEXT create_info = { VK_STRUCTURE_TYPE_HEADLESS_SURFACE_CREATE_INFO_EXT };
+    VkResult result = func(context->instance, &create_info, context->allocator, &state_ptr->surface);
+    if (result != VK_SUCCESS) {
+        KFATAL("Vulkan headless surface creation failed.");
+        return FALSE;
+    }
+
+    context->surface = state_ptr->surface;
+
+    return TRUE;
+}
+
+#endif
\ No newline at end of file
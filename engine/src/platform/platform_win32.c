@@ -11,6 +11,8 @@
 #include <Windows.h>
 #include <windowsx.h>
 #include <stdlib.h>
+#include <malloc.h>
+#include <intrin.h>
 
 #include <vulkan/vulkan.h>
 #include <vulkan/vulkan_win32.h>
@@ -43,7 +45,8 @@ Boolean platform_system_startup(
     Int32 x,
     Int32 y,
     Int32 width,
-    Int32 height) {
+    Int32 height,
+    Boolean headless) {
 
     *memory_requirement = sizeof(platform_state);
 
@@ -53,6 +56,12 @@ Boolean platform_system_startup(
 
     state_ptr = state;
     state_ptr->h_instance = GetModuleHandleA(0);
+    state_ptr->hwnd = 0;
+
+    if (headless) {
+        clock_setup();
+        return TRUE;
+    }
 
     HICON icon = LoadIcon(state_ptr->h_instance, IDI_APPLICATION);
     WNDCLASSA wc;
@@ -138,6 +147,10 @@ Boolean platform_pump_messages() {
     return TRUE;
 }
 
+void platform_wait_messages(UInt64 timeout_ms) {
+    MsgWaitForMultipleObjects(0, 0, FALSE, (DWORD)timeout_ms, QS_ALLINPUT);
+}
+
 void* platform_allocate(UInt64 size, Boolean aligned) {
     return malloc(size);
 }
@@ -146,6 +159,52 @@ void platform_free(void* block, Boolean aligned) {
     free(block);
 }
 
+void* platform_allocate_aligned(UInt64 size, UInt64 alignment) {
+    return _aligned_malloc(size, alignment);
+}
+
+void platform_free_aligned(void* block) {
+    _aligned_free(block);
+}
+
+UInt64 platform_get_page_size() {
+    SYSTEM_INFO sysinfo;
+    GetSystemInfo(&sysinfo);
+    return sysinfo.dwPageSize;
+}
+
+void* platform_reserve(UInt64 size) {
+    void* block = VirtualAlloc(0, size, MEM_RESERVE, PAGE_NOACCESS);
+    if (!block) {
+        KERROR("platform_reserve - could not reserve %llu bytes: error %lu.", size, GetLastError());
+    }
+    return block;
+}
+
+Boolean platform_commit(void* address, UInt64 size, Boolean large_pages) {
+    // Large pages on Windows need SeLockMemoryPrivilege and a reservation made for them up
+    // front, so the hint is not used here.
+    if (!VirtualAlloc(address, size, MEM_COMMIT, PAGE_READWRITE)) {
+        KERROR("platform_commit - could not commit %llu bytes at %p: error %lu.", size, address, GetLastError());
+        return FALSE;
+    }
+    return TRUE;
+}
+
+Boolean platform_decommit(void* address, UInt64 size) {
+    if (!VirtualFree(address, size, MEM_DECOMMIT)) {
+        KERROR("platform_decommit - could not decommit %llu bytes at %p: error %lu.", size, address, GetLastError());
+        return FALSE;
+    }
+    return TRUE;
+}
+
+void platform_release(void* address, UInt64 size) {
+    if (address) {
+        VirtualFree(address, 0, MEM_RELEASE);
+    }
+}
+
 void* platform_zero_memory(void* block, UInt64 size) {
     return memset(block, 0, size);
 }
@@ -190,10 +249,117 @@ Double platform_get_absolute_time() {
     return (Double)now_time.QuadPart * clock_frequency;
 }
 
+UInt64 platform_get_timestamp() {
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    LARGE_INTEGER now_time;
+    QueryPerformanceCounter(&now_time);
+    return (UInt64)now_time.QuadPart;
+#endif
+}
+
 void platform_sleep(UInt64 ms) {
     Sleep(ms);
 }
 
+Int32 platform_get_processor_count() {
+    SYSTEM_INFO sysinfo;
+    GetSystemInfo(&sysinfo);
+    return (Int32)sysinfo.dwNumberOfProcessors;
+}
+
+Boolean platform_thread_create(pfn_thread_start start_function, void* params, kthread* out_thread) {
+    if (!start_function || !out_thread) {
+        return FALSE;
+    }
+
+    DWORD thread_id = 0;
+    out_thread->internal_data = CreateThread(0, 0, (LPTHREAD_START_ROUTINE)start_function, params, 0, &thread_id);
+    if (!out_thread->internal_data) {
+        KERROR("Failed to create thread: error %lu.", GetLastError());
+        return FALSE;
+    }
+
+    out_thread->thread_id = thread_id;
+    return TRUE;
+}
+
+void platform_thread_destroy(kthread* thread) {
+    if (thread && thread->internal_data) {
+        WaitForSingleObject((HANDLE)thread->internal_data, INFINITE);
+        CloseHandle((HANDLE)thread->internal_data);
+        thread->internal_data = 0;
+        thread->thread_id = 0;
+    }
+}
+
+UInt64 platform_current_thread_id() {
+    return (UInt64)GetCurrentThreadId();
+}
+
+Boolean platform_mutex_create(kmutex* out_mutex) {
+    if (!out_mutex) {
+        return FALSE;
+    }
+
+    out_mutex->internal_data = CreateMutexA(0, FALSE, 0);
+    if (!out_mutex->internal_data) {
+        KERROR("Failed to create mutex.");
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+void platform_mutex_destroy(kmutex* mutex) {
+    if (mutex && mutex->internal_data) {
+        CloseHandle((HANDLE)mutex->internal_data);
+        mutex->internal_data = 0;
+    }
+}
+
+Boolean platform_mutex_lock(kmutex* mutex) {
+    return mutex && mutex->internal_data && WaitForSingleObject((HANDLE)mutex->internal_data, INFINITE) == WAIT_OBJECT_0;
+}
+
+Boolean platform_mutex_unlock(kmutex* mutex) {
+    return mutex && mutex->internal_data && ReleaseMutex((HANDLE)mutex->internal_data) != 0;
+}
+
+Boolean platform_semaphore_create(ksemaphore* out_semaphore, UInt32 max_count, UInt32 start_count) {
+    if (!out_semaphore) {
+        return FALSE;
+    }
+
+    out_semaphore->internal_data = CreateSemaphoreA(0, start_count, max_count, 0);
+    if (!out_semaphore->internal_data) {
+        KERROR("Failed to create semaphore.");
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+void platform_semaphore_destroy(ksemaphore* semaphore) {
+    if (semaphore && semaphore->internal_data) {
+        CloseHandle((HANDLE)semaphore->internal_data);
+        semaphore->internal_data = 0;
+    }
+}
+
+Boolean platform_semaphore_signal(ksemaphore* semaphore) {
+    return semaphore && semaphore->internal_data && ReleaseSemaphore((HANDLE)semaphore->internal_data, 1, 0) != 0;
+}
+
+Boolean platform_semaphore_wait(ksemaphore* semaphore, UInt64 timeout_ms) {
+    if (!semaphore || !semaphore->internal_data) {
+        return FALSE;
+    }
+
+    return WaitForSingleObject((HANDLE)semaphore->internal_data, (DWORD)timeout_ms) == WAIT_OBJECT_0;
+}
+
 void platform_get_required_extension_names(const char*** names_darray) {
     darray_push(*names_darray, &"VK_KHR_win32_surface");
 }
@@ -226,6 +392,13 @@ LRESULT CALLBACK win_32_process_message(HWND hwnd, UInt32 msg, WPARAM w_param, L
         case WM_DESTROY:
             PostQuitMessage(0);
             return 0;
+        case WM_SETFOCUS:
+        case WM_KILLFOCUS:
+        {
+            event_context context;
+            context.data.u8[0] = msg == WM_SETFOCUS;
+            event_post(EVENT_CODE_FOCUS_CHANGED, 0, context);
+        } break;
         case WM_SIZE:
         {
             RECT r;
@@ -236,7 +409,7 @@ LRESULT CALLBACK win_32_process_message(HWND hwnd, UInt32 msg, WPARAM w_param, L
             event_context context;
             context.data.u16[0] = (UInt16)width;
             context.data.u16[1] = (UInt16)height;
-            event_fire(EVENT_CODE_RESIZED, 0, context);
+            event_post(EVENT_CODE_RESIZED, 0, context);
         } break;
         case WM_KEYDOWN:
         case WM_SYSKEYDOWN:
@@ -1,5 +1,6 @@
 #include "renderer_backend.h"
 #include "vulkan/vulkan_backend.h"
+#include "null/null_backend.h"
 
 Boolean renderer_backend_create(renderer_backend_type type, renderer_backend* out_renderer_backend) {
     if (type == RENDERER_BACKEND_TYPE_VULKAN) {
@@ -12,6 +13,16 @@ Boolean renderer_backend_create(renderer_backend_type type, renderer_backend* ou
         return TRUE;
     }
 
+    if (type == RENDERER_BACKEND_TYPE_NULL) {
+        out_renderer_backend->initialize = null_renderer_backend_initialize;
+        out_renderer_backend->shutdown = null_renderer_backend_shutdown;
+        out_renderer_backend->begin_frame = null_renderer_backend_begin_frame;
+        out_renderer_backend->update_global_state = null_renderer_update_global_state;
+        out_renderer_backend->end_frame = null_renderer_backend_end_frame;
+        out_renderer_backend->resized = null_renderer_backend_on_resized;
+        return TRUE;
+    }
+
     return FALSE;
 }
 
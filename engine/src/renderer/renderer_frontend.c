@@ -3,6 +3,9 @@
 
 #include "core/logger.h"
 #include "core/kmemory.h"
+#include "core/profiler.h"
+#include "core/frame_stats.h"
+#include "platform/platform.h"
 #include "math/kmath.h"
 
 typedef struct renderer_system_state {
@@ -11,7 +14,7 @@ typedef struct renderer_system_state {
 
 static renderer_system_state* state_ptr;
 
-Boolean renderer_system_initialize(UInt64* memory_requirement, void* state, const char* application_name) {
+Boolean renderer_system_initialize(UInt64* memory_requirement, void* state, const char* application_name, renderer_backend_type backend_type, Boolean vsync) {
     *memory_requirement = sizeof(renderer_system_state);
 
     if (state == 0) {
@@ -20,8 +23,12 @@ Boolean renderer_system_initialize(UInt64* memory_requirement, void* state, cons
 
     state_ptr = state;
 
-    renderer_backend_create(RENDERER_BACKEND_TYPE_VULKAN, &state_ptr->backend);
+    if (!renderer_backend_create(backend_type, &state_ptr->backend)) {
+        KFATAL("Renderer backend type %i is not supported.", backend_type);
+        return FALSE;
+    }
     state_ptr->backend.frame_number = 0;
+    state_ptr->backend.vsync = vsync;
 
     if (!state_ptr->backend.initialize(&state_ptr->backend, application_name)) {
         KFATAL("Renderer backend failed to initialize. Shutting down.");
@@ -40,19 +47,27 @@ void renderer_system_shutdown(void* state) {
 }
 
 Boolean renderer_begin_frame(Single delta_time) {
+    KPROFILE_SCOPE("renderer_begin_frame");
     if (!state_ptr) {
         return FALSE;
     }
 
-    return state_ptr->backend.begin_frame(&state_ptr->backend, delta_time);
+    Double start_time = platform_get_absolute_time();
+    Boolean result = state_ptr->backend.begin_frame(&state_ptr->backend, delta_time);
+    // Mostly the wait for a previous frame's fence, which is presentation time, not rendering.
+    frame_stats_record(FRAME_STAT_PRESENT, platform_get_absolute_time() - start_time);
+    return result;
 }
 
 Boolean renderer_end_frame(Single delta_time) {
+    KPROFILE_SCOPE("renderer_end_frame");
      if (!state_ptr) {
         return FALSE;
     }
 
+    Double start_time = platform_get_absolute_time();
     Boolean result = state_ptr->backend.end_frame(&state_ptr->backend, delta_time);
+    frame_stats_record(FRAME_STAT_PRESENT, platform_get_absolute_time() - start_time);
     state_ptr->backend.frame_number++;
     return result;
 }
@@ -61,7 +76,7 @@ void renderer_on_resized(UInt16 width, UInt16 height) {
     if (state_ptr) {
         state_ptr->backend.resized(&state_ptr->backend, width, height);
     } else {
-        KWARN("renderer backend does not exist to accept resize: %i %i", width, height);
+        KWARN_C(LOG_CATEGORY_RENDERER, "renderer backend does not exist to accept resize: %i %i", width, height);
     }
 }
 
@@ -5,7 +5,8 @@
 struct static_mesh_data;
 struct platform_state;
 
-Boolean renderer_system_initialize(UInt64* memory_requirement, void* state, const char* application_name);
+// With vsync, presentation waits for the display, which paces the frame loop.
+Boolean renderer_system_initialize(UInt64* memory_requirement, void* state, const char* application_name, renderer_backend_type backend_type, Boolean vsync);
 void renderer_system_shutdown(void* state);
 
 void renderer_on_resized(UInt16 width, UInt16 height);
@@ -7,7 +7,9 @@
 typedef enum renderer_backend_type {
     RENDERER_BACKEND_TYPE_VULKAN,
     RENDERER_BACKEND_TYPE_OPENGL,
-    RENDERER_BACKEND_TYPE_DIRECTX
+    RENDERER_BACKEND_TYPE_DIRECTX,
+    // Draws nothing; used when running headless.
+    RENDERER_BACKEND_TYPE_NULL
 } renderer_backend_type;
 
 typedef struct global_uniform_object {
@@ -19,6 +21,7 @@ typedef struct global_uniform_object {
 
 typedef struct renderer_backend {
     UInt64 frame_number;
+    Boolean vsync;
 
     Boolean (*initialize)(struct renderer_backend* backend, const char* application_name);
     void (*shutdown)(struct renderer_backend* backend);
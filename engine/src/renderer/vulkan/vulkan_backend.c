@@ -57,6 +57,7 @@ Boolean vulkan_renderer_backend_initialize(renderer_backend* backend, const char
 
     context.find_memory_index = find_memory_index;
     context.allocator = 0;
+    context.vsync = backend->vsync;
 
     application_get_framebuffer_size(&cached_framebuffer_width, &cached_framebuffer_height);
     context.framebuffer_width = cached_framebuffer_width != 0 ? cached_framebuffer_width : 800;
@@ -80,10 +81,10 @@ Boolean vulkan_renderer_backend_initialize(renderer_backend* backend, const char
 #if defined(_DEBUG)
     darray_push(required_extensions, &VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
 
-    KDEBUG("Required extensions:");
+    KDEBUG_C(LOG_CATEGORY_VULKAN, "Required extensions:");
     UInt32 length = darray_length(required_extensions);
     for (UInt32 i = 0; i< length; ++i) {
-        KDEBUG(required_extensions[i]);
+        KDEBUG_C(LOG_CATEGORY_VULKAN, "%s", required_extensions[i]);
     }
 #endif
 
@@ -94,7 +95,7 @@ Boolean vulkan_renderer_backend_initialize(renderer_backend* backend, const char
     UInt32 required_validation_layer_count = 0;
 
 #if defined(_DEBUG)
-    KINFO("Validation layers enabled. Enumerating...");
+    KINFO_C(LOG_CATEGORY_VULKAN, "Validation layers enabled. Enumerating...");
 
     required_validation_layer_names = darray_create(const char*);
     darray_push(required_validation_layer_names, &"VK_LAYER_KHRONOS_validation");
@@ -106,12 +107,12 @@ Boolean vulkan_renderer_backend_initialize(renderer_backend* backend, const char
     VK_CHECK(vkEnumerateInstanceLayerProperties(&available_layer_count, available_layers));
 
     for (UInt32 i = 0; i < required_validation_layer_count; ++i) {
-        KINFO("Searching for later: %s...", required_validation_layer_names[i]);
+        KINFO_C(LOG_CATEGORY_VULKAN, "Searching for later: %s...", required_validation_layer_names[i]);
         Boolean found = FALSE;
         for (UInt32 j = 0; j < available_layer_count; ++j) {
             if (strings_equal(required_validation_layer_names[i], available_layers[j].layerName)) {
                 found = TRUE;
-                KINFO("Found.");
+                KINFO_C(LOG_CATEGORY_VULKAN, "Found.");
                 break;
             }
         }
@@ -122,17 +123,17 @@ Boolean vulkan_renderer_backend_initialize(renderer_backend* backend, const char
         }
     }
 
-    KINFO("All required validation layers are present.");
+    KINFO_C(LOG_CATEGORY_VULKAN, "All required validation layers are present.");
 #endif
 
     create_info.enabledLayerCount = required_validation_layer_count;
     create_info.ppEnabledLayerNames = required_validation_layer_names;
 
     VK_CHECK(vkCreateInstance(&create_info, context.allocator, &context.instance));
-    KINFO("Vulkan instance created.");
+    KINFO_C(LOG_CATEGORY_VULKAN, "Vulkan instance created.");
 
 #if defined(_DEBUG)
-    KDEBUG("Creating Vulkan debugger...");
+    KDEBUG_C(LOG_CATEGORY_VULKAN, "Creating Vulkan debugger...");
     UInt32 log_severity = VK_DEBUG_UTILS_MESSAGE_SEVERITY_ERROR_BIT_EXT |
                           VK_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT |
                           VK_DEBUG_UTILS_MESSAGE_SEVERITY_INFO_BIT_EXT;
@@ -146,16 +147,16 @@ Boolean vulkan_renderer_backend_initialize(renderer_backend* backend, const char
         (PFN_vkCreateDebugUtilsMessengerEXT)vkGetInstanceProcAddr(context.instance, "vkCreateDebugUtilsMessengerEXT");
     KASSERT_MSG(func, "Failed to create debug messenger!");
     VK_CHECK(func(context.instance, &debug_create_info, context.allocator, &context.debug_messenger));
-    KDEBUG("Vulkan debugger created~!");
+    KDEBUG_C(LOG_CATEGORY_VULKAN, "Vulkan debugger created~!");
 #endif
 
-    KDEBUG("Creating Vulkan surface...");
+    KDEBUG_C(LOG_CATEGORY_VULKAN, "Creating Vulkan surface...");
     if (!platform_create_vulkan_surface(&context)) {
         KERROR("Failed to create platform surface!");
         return FALSE;
     }
 
-    KDEBUG("Vulkan surface created.");
+    KDEBUG_C(LOG_CATEGORY_VULKAN, "Vulkan surface created.");
 
     // Device creation
     if (!vulkan_device_create(&context)) {
@@ -229,7 +230,7 @@ Boolean vulkan_renderer_backend_initialize(renderer_backend* backend, const char
     upload_data_range(&context, context.device.graphics_command_pool, 0, context.device.graphics_queue, &context.object_vertex_buffer, 0, sizeof(vertex_3d) * vert_count, verts);
     upload_data_range(&context, context.device.graphics_command_pool, 0, context.device.graphics_queue, &context.object_index_buffer, 0, sizeof(UInt32) * index_count, indices);
 
-    KINFO("Vulkan renderer intialized successfully.");
+    KINFO_C(LOG_CATEGORY_VULKAN, "Vulkan renderer intialized successfully.");
     return TRUE;
 }
 
@@ -291,23 +292,23 @@ void vulkan_renderer_backend_shutdown(renderer_backend* backend) {
     vulkan_renderpass_destroy(&context, &context.main_renderpass);
     vulkan_swapchain_destroy(&context, &context.swapchain);
     
-    KDEBUG("Destroying Vulkan device...");
+    KDEBUG_C(LOG_CATEGORY_VULKAN, "Destroying Vulkan device...");
     vulkan_device_destroy(&context);
 
-    KDEBUG("Destroying Vulkan surface...");
+    KDEBUG_C(LOG_CATEGORY_VULKAN, "Destroying Vulkan surface...");
     if (context.surface) {
         vkDestroySurfaceKHR(context.instance, context.surface, context.allocator);
         context.surface = 0;
     }
 
-    KDEBUG("Destroying Vulkan debugger");
+    KDEBUG_C(LOG_CATEGORY_VULKAN, "Destroying Vulkan debugger");
     if(context.debug_messenger) {
         PFN_vkDestroyDebugUtilsMessengerEXT func = 
             (PFN_vkDestroyDebugUtilsMessengerEXT)vkGetInstanceProcAddr(context.instance, "vkDestroyDebugUtilsMessengerEXT");
         func(context.instance, context.debug_messenger, context.allocator);
     }
 
-    KDEBUG("Destroying Vulkan instance...");
+    KDEBUG_C(LOG_CATEGORY_VULKAN, "Destroying Vulkan instance...");
     vkDestroyInstance(context.instance, context.allocator);
 }
 
@@ -316,7 +317,7 @@ void vulkan_renderer_backend_on_resized(renderer_backend* backend, UInt16 width,
     cached_framebuffer_height = height;
     context.framebuffer_size_generation++;
 
-    KINFO("Vulkan renderer backend->resized: w/h/gen: %i/%i/%llu", width, height, context.framebuffer_size_generation);
+    KINFO_C(LOG_CATEGORY_VULKAN, "Vulkan renderer backend->resized: w/h/gen: %i/%i/%llu", width, height, context.framebuffer_size_generation);
 }
 
 Boolean vulkan_renderer_backend_begin_frame(renderer_backend* backend, Single delta_time) {
@@ -329,7 +330,7 @@ Boolean vulkan_renderer_backend_begin_frame(renderer_backend* backend, Single de
             return FALSE;
         }
 
-        KINFO("Recreating swapchain, booting...");
+        KINFO_C(LOG_CATEGORY_VULKAN, "Recreating swapchain, booting...");
         return FALSE;
     }
 
@@ -344,12 +345,12 @@ Boolean vulkan_renderer_backend_begin_frame(renderer_backend* backend, Single de
             return FALSE;
         }
 
-        KINFO("Resized. Booting...");
+        KINFO_C(LOG_CATEGORY_VULKAN, "Resized. Booting...");
         return FALSE;
     }
 
     if (!vulkan_fence_wait(&context, &context.in_flight_fences[context.current_frame], UINT64_MAX)) {
-        KWARN("In-flight fence wait failure.");
+        KWARN_C(LOG_CATEGORY_VULKAN, "In-flight fence wait failure.");
         return FALSE;
     }
 
@@ -468,16 +469,16 @@ VKAPI_ATTR VkBool32 VKAPI_CALL vk_debug_callback(
     switch (message_severity) {
         default:
         case VK_DEBUG_UTILS_MESSAGE_SEVERITY_ERROR_BIT_EXT:
-            KERROR(callback_data->pMessage);
+            KERROR("%s", callback_data->pMessage);
             break;
         case VK_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT:
-            KWARN(callback_data->pMessage);
+            KWARN_C(LOG_CATEGORY_VULKAN, "%s", callback_data->pMessage);
             break;
         case VK_DEBUG_UTILS_MESSAGE_SEVERITY_INFO_BIT_EXT:
-            KINFO(callback_data->pMessage);
+            KINFO_C(LOG_CATEGORY_VULKAN, "%s", callback_data->pMessage);
             break;
         case VK_DEBUG_UTILS_MESSAGE_SEVERITY_VERBOSE_BIT_EXT:
-            KTRACE(callback_data->pMessage);
+            KTRACE_C(LOG_CATEGORY_VULKAN, "%s", callback_data->pMessage);
             break;
     }
 
@@ -494,7 +495,7 @@ Int32 find_memory_index(UInt32 type_filter, UInt32 property_flags) {
         }
     }
     
-    KWARN("Unable to find suitable memory type!");
+    KWARN_C(LOG_CATEGORY_VULKAN, "Unable to find suitable memory type!");
     return -1;
 }
 
@@ -521,7 +522,7 @@ void create_command_buffers(renderer_backend* backend) {
             &context.graphics_command_buffers[i]);
     }
     
-    KINFO("Vulkan command buffers created.");
+    KINFO_C(LOG_CATEGORY_VULKAN, "Vulkan command buffers created.");
 }
 
 void regenerate_framebuffers(renderer_backend* backend, vulkan_swapchain* swapchain, vulkan_renderpass* renderpass) {
@@ -545,12 +546,12 @@ void regenerate_framebuffers(renderer_backend* backend, vulkan_swapchain* swapch
 Boolean recreate_swapchain(renderer_backend* backend) {
 
     if (context.recreating_swapchain) {
-        KDEBUG("recreate_swapchain called when already recreating. Booting.");
+        KDEBUG_C(LOG_CATEGORY_VULKAN, "recreate_swapchain called when already recreating. Booting.");
         return FALSE;
     }
 
     if (context.framebuffer_width == 0 || context.framebuffer_height == 0) {
-        KDEBUG("recreate_swapchain called when window is < 1 in a dimension. Booting.");
+        KDEBUG_C(LOG_CATEGORY_VULKAN, "recreate_swapchain called when window is < 1 in a dimension. Booting.");
         return FALSE;
     }
 
@@ -36,7 +36,7 @@ Boolean vulkan_device_create(vulkan_context* context) {
         return FALSE;
     }
 
-    KINFO("Creating logical device...");
+    KINFO_C(LOG_CATEGORY_VULKAN, "Creating logical device...");
     Boolean present_shares_graphics_queue = context->device.graphics_queue_index == context->device.present_queue_index;
     Boolean transfer_shares_graphics_queue = context->device.graphics_queue_index == context->device.transfer_queue_index;
     UInt32 index_count = 1;
@@ -88,12 +88,12 @@ Boolean vulkan_device_create(vulkan_context* context) {
 
     VK_CHECK(vkCreateDevice(context->device.physical_device, &device_create_info, context->allocator, &context->device.logical_device));
 
-    KINFO("Logical device created.");
+    KINFO_C(LOG_CATEGORY_VULKAN, "Logical device created.");
 
     vkGetDeviceQueue(context->device.logical_device, context->device.graphics_queue_index, 0, &context->device.graphics_queue);
     vkGetDeviceQueue(context->device.logical_device, context->device.present_queue_index, 0, &context->device.present_queue);
     vkGetDeviceQueue(context->device.logical_device, context->device.transfer_queue_index, 0, &context->device.transfer_queue);
-    KINFO("Queues obtained.");
+    KINFO_C(LOG_CATEGORY_VULKAN, "Queues obtained.");
 
     VkCommandPoolCreateInfo pool_create_info = { VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO };
     pool_create_info.queueFamilyIndex = context->device.graphics_queue_index;
@@ -103,7 +103,7 @@ Boolean vulkan_device_create(vulkan_context* context) {
         &pool_create_info,
         context->allocator,
         &context->device.graphics_command_pool));
-    KINFO("Graphics command pool created.");
+    KINFO_C(LOG_CATEGORY_VULKAN, "Graphics command pool created.");
 
     return TRUE;
 }
@@ -114,19 +114,19 @@ void vulkan_device_destroy(vulkan_context* context) {
     context->device.present_queue = 0;
     context->device.transfer_queue = 0;
 
-    KINFO("Destroying command pools...");
+    KINFO_C(LOG_CATEGORY_VULKAN, "Destroying command pools...");
     vkDestroyCommandPool(
         context->device.logical_device,
         context->device.graphics_command_pool,
         context->allocator);
 
-    KINFO("Destroying logical device...");
+    KINFO_C(LOG_CATEGORY_VULKAN, "Destroying logical device...");
     if (context->device.logical_device) {
         vkDestroyDevice(context->device.logical_device, context->allocator);
         context->device.logical_device = 0;
     }
 
-    KINFO("Releasing physical device resources...");
+    KINFO_C(LOG_CATEGORY_VULKAN, "Releasing physical device resources...");
     context->device.physical_device = 0;
 
     if (context->device.swapchain_support.formats) {
@@ -249,33 +249,35 @@ Boolean select_physical_device(vulkan_context* context) {
             &context->device.swapchain_support);
 
         if (result) {
-            KINFO("Selected device: '%s'.", properties.deviceName);
+            KINFO_C(LOG_CATEGORY_VULKAN, "Selected device: '%s'.", properties.deviceName);
             switch (properties.deviceType) {
                 default:
                 case VK_PHYSICAL_DEVICE_TYPE_OTHER:
-                    KINFO("GPU type is Unknown.");
+                    KINFO_C(LOG_CATEGORY_VULKAN, "GPU type is Unknown.");
                     break;
                 case VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU:
-                    KINFO("GPU type is Integrated.");
+                    KINFO_C(LOG_CATEGORY_VULKAN, "GPU type is Integrated.");
                     break;
                 case VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU:
-                    KINFO("GPU type is Descrete.");
+                    KINFO_C(LOG_CATEGORY_VULKAN, "GPU type is Descrete.");
                     break;
                 case VK_PHYSICAL_DEVICE_TYPE_VIRTUAL_GPU:
-                    KINFO("GPU type is Virtual.");
+                    KINFO_C(LOG_CATEGORY_VULKAN, "GPU type is Virtual.");
                     break;
                 case VK_PHYSICAL_DEVICE_TYPE_CPU:
-                    KINFO("GPU type is CPU.");
+                    KINFO_C(LOG_CATEGORY_VULKAN, "GPU type is CPU.");
                     break;
             }
 
-            KINFO(
+            KINFO_C(
+                LOG_CATEGORY_VULKAN,
                 "GPU Driver version: %d.%d.%d",
                 VK_VERSION_MAJOR(properties.driverVersion),
                 VK_VERSION_MINOR(properties.driverVersion),
                 VK_VERSION_PATCH(properties.driverVersion));
 
-            KINFO(
+            KINFO_C(
+                LOG_CATEGORY_VULKAN,
                 "Vulkan API version: %d.%d.%d",
                 VK_VERSION_MAJOR(properties.apiVersion),
                 VK_VERSION_MINOR(properties.apiVersion),
@@ -284,9 +286,9 @@ Boolean select_physical_device(vulkan_context* context) {
             for (UInt32 j = 0; j < memory.memoryHeapCount; ++j) {
                 Single memory_size_gib = (((Single)memory.memoryHeaps[j].size) / 1024.f / 1024.f / 1024.f);
                 if (memory.memoryHeaps[j].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) {
-                    KINFO("Local GPU memory: %.2f GiB", memory_size_gib);
+                    KINFO_C(LOG_CATEGORY_VULKAN, "Local GPU memory: %.2f GiB", memory_size_gib);
                 } else {
-                    KINFO("Shared System memory: %.2f GiB", memory_size_gib);
+                    KINFO_C(LOG_CATEGORY_VULKAN, "Shared System memory: %.2f GiB", memory_size_gib);
                 }
             }
 
@@ -307,7 +309,7 @@ Boolean select_physical_device(vulkan_context* context) {
         return FALSE;
     }
 
-    KINFO("Physical device selected.");
+    KINFO_C(LOG_CATEGORY_VULKAN, "Physical device selected.");
     return TRUE;
 }
 
@@ -326,7 +328,7 @@ Boolean physical_device_meets_requirements(
 
     if (requirements->discrete_gpu) {
         if (properties->deviceType != VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU) {
-            KINFO("Device is not a discrete GPU, and one is required. Skipping.");
+            KINFO_C(LOG_CATEGORY_VULKAN, "Device is not a discrete GPU, and one is required. Skipping.");
             return FALSE;
         }
     }
@@ -336,7 +338,7 @@ Boolean physical_device_meets_requirements(
     VkQueueFamilyProperties queue_families[32];
     vkGetPhysicalDeviceQueueFamilyProperties(device, &queue_family_count, queue_families);
 
-    KINFO("Graphics | Present | Compute | Transfer | Name");
+    KINFO_C(LOG_CATEGORY_VULKAN, "Graphics | Present | Compute | Transfer | Name");
     UInt8 min_transfer_score = 255;
     for (UInt32 i = 0; i < queue_family_count; ++i) {
         UInt8 current_transfer_score = 0;
@@ -365,23 +367,24 @@ Boolean physical_device_meets_requirements(
         }
     }
 
-    KINFO("       %d |       %d |       %d |        %d | %s",
-          out_queue_info->graphics_family_index != -1,
-          out_queue_info->present_family_index != -1,
-          out_queue_info->compute_family_index != -1,
-          out_queue_info->transfer_family_index != -1,
-          properties->deviceName);
+    KINFO_C(LOG_CATEGORY_VULKAN,
+            "       %d |       %d |       %d |        %d | %s",
+            out_queue_info->graphics_family_index != -1,
+            out_queue_info->present_family_index != -1,
+            out_queue_info->compute_family_index != -1,
+            out_queue_info->transfer_family_index != -1,
+            properties->deviceName);
 
     if (
         (!requirements->graphics || (requirements->graphics && out_queue_info->graphics_family_index != -1)) &&
         (!requirements->present || (requirements->present && out_queue_info->present_family_index != -1)) &&
         (!requirements->compute || (requirements->compute && out_queue_info->compute_family_index != -1)) &&
         (!requirements->transfer || (requirements->transfer && out_queue_info->transfer_family_index != -1))) {
-        KINFO("Device meets queue requirements.");
-        KTRACE("Graphics Family Index: %i", out_queue_info->graphics_family_index);
-        KTRACE("Present Family Index:  %i", out_queue_info->present_family_index);
-        KTRACE("Transfer Family Index: %i", out_queue_info->transfer_family_index);
-        KTRACE("Compute Family Index:  %i", out_queue_info->compute_family_index);
+        KINFO_C(LOG_CATEGORY_VULKAN, "Device meets queue requirements.");
+        KTRACE_C(LOG_CATEGORY_VULKAN, "Graphics Family Index: %i", out_queue_info->graphics_family_index);
+        KTRACE_C(LOG_CATEGORY_VULKAN, "Present Family Index:  %i", out_queue_info->present_family_index);
+        KTRACE_C(LOG_CATEGORY_VULKAN, "Transfer Family Index: %i", out_queue_info->transfer_family_index);
+        KTRACE_C(LOG_CATEGORY_VULKAN, "Compute Family Index:  %i", out_queue_info->compute_family_index);
 
         vulkan_device_query_swapchain_support(device, surface, out_swapchain_support);
 
@@ -393,7 +396,7 @@ Boolean physical_device_meets_requirements(
                 kfree(out_swapchain_support->present_modes, sizeof(VkPresentModeKHR) * out_swapchain_support->present_mode_count, MEMORY_TAG_RENDERER);
             }
 
-            KINFO("Required swapchain support not present, skipping device.");
+            KINFO_C(LOG_CATEGORY_VULKAN, "Required swapchain support not present, skipping device.");
             return FALSE;
         }
 
@@ -417,7 +420,7 @@ Boolean physical_device_meets_requirements(
                     }
 
                     if (!found) {
-                        KINFO("Required extension not found: '%s', skipping device.", requirements->device_extension_names[i]);
+                        KINFO_C(LOG_CATEGORY_VULKAN, "Required extension not found: '%s', skipping device.", requirements->device_extension_names[i]);
                         kfree(available_extensions, sizeof(VkExtensionProperties) * available_extension_count, MEMORY_TAG_RENDERER);
                         return FALSE;
                     }
@@ -428,7 +431,7 @@ Boolean physical_device_meets_requirements(
         }
 
         if (requirements->sampler_anisotropy && !features->samplerAnisotropy) {
-            KINFO("Device does not support samplerAnisotropy, skipping.");
+            KINFO_C(LOG_CATEGORY_VULKAN, "Device does not support samplerAnisotropy, skipping.");
             return FALSE;
         }
 
@@ -1,6 +1,7 @@
 #include "vulkan_fence.h"
 
 #include "core/logger.h"
+#include "core/profiler.h"
 
 void vulkan_fence_create(vulkan_context* context, Boolean create_signaled, vulkan_fence* out_fence) {
     out_fence->is_signaled = create_signaled;
@@ -23,13 +24,15 @@ void vulkan_fence_destroy(vulkan_context* context, vulkan_fence* fence) {
 
 Boolean vulkan_fence_wait(vulkan_context* context, vulkan_fence* fence, UInt64 timeout_ns) {
     if (!fence->is_signaled) {
+        KPROFILE_BEGIN("vulkan_fence_wait");
         VkResult result = vkWaitForFences(context->device.logical_device, 1, &fence->handle, TRUE, timeout_ns);
+        KPROFILE_END();
         switch (result) {
         case VK_SUCCESS:
             fence->is_signaled = TRUE;
             break;
         case VK_TIMEOUT:
-            KWARN("vk_fence_wait - Timed out.");
+            KWARN_C(LOG_CATEGORY_VULKAN, "vk_fence_wait - Timed out.");
             break;
         case VK_ERROR_DEVICE_LOST:
             KERROR("vk_fence_wait - VK_ERROR_DEVICE_LOST.");
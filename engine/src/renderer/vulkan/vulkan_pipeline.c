@@ -135,7 +135,7 @@ Boolean vulkan_graphics_pipeline_create(
         &out_pipeline->handle);
 
     if (vulkan_result_is_success(result)) {
-        KDEBUG("Graphics pipeline created!");
+        KDEBUG_C(LOG_CATEGORY_VULKAN, "Graphics pipeline created!");
         return TRUE;
     }
 
@@ -3,6 +3,9 @@
 #include "core/logger.h"
 #include "core/kstring.h"
 #include "core/kmemory.h"
+#include "core/application.h"
+
+#include "memory/stack_allocator.h"
 
 #include "platform/filesystem.h"
 
@@ -26,15 +29,26 @@ Boolean create_shader_module(
         return FALSE;
     }
 
+    // The file is only needed until the module is created, so it lives on the scratch stack.
+    stack_allocator* scratch = application_get_scratch_stack();
+    stack_allocator_marker marker = stack_allocator_get_marker(scratch);
+
     UInt64 size = 0;
-    UInt8* file_buffer = 0;
-    if (!filesystem_read_all_bytes(&handle, &file_buffer, &size)) {
+    UInt64 bytes_read = 0;
+    UInt32* file_buffer = 0;
+    if (filesystem_size(&handle, &size)) {
+        // SPIR-V is read as 32-bit words.
+        file_buffer = stack_allocator_allocate_aligned(scratch, size, sizeof(UInt32));
+    }
+    if (!file_buffer || !filesystem_read(&handle, size, file_buffer, &bytes_read) || bytes_read != size) {
         KERROR("Unable to read binary shader module: %s", file_name);
+        filesystem_close(&handle);
+        stack_allocator_free_to_marker(scratch, marker);
         return FALSE;
     }
 
     shader_stages[stage_index].create_info.codeSize = size;
-    shader_stages[stage_index].create_info.pCode = (UInt32*)file_buffer;
+    shader_stages[stage_index].create_info.pCode = file_buffer;
 
     filesystem_close(&handle);
 
@@ -50,10 +64,7 @@ Boolean create_shader_module(
     shader_stages[stage_index].shader_state_create_info.module = shader_stages[stage_index].handle;
     shader_stages[stage_index].shader_state_create_info.pName = "main";
 
-    if (file_buffer) {
-        kfree(file_buffer, sizeof(UInt8) * size, MEMORY_TAG_STRING);
-        file_buffer = 0;
-    }
+    stack_allocator_free_to_marker(scratch, marker);
 
     return TRUE;
 }
\ No newline at end of file
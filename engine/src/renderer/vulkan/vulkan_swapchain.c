@@ -2,6 +2,7 @@
 
 #include "core/logger.h"
 #include "core/kmemory.h"
+#include "core/profiler.h"
 #include "vulkan_device.h"
 #include "vulkan_image.h"
 
@@ -56,7 +57,8 @@ void vulkan_swapchain_present(
     VkQueue present_queue,
     VkSemaphore render_complete_semaphore,
     UInt32 present_image_index) {
-    
+    KPROFILE_SCOPE("vulkan_swapchain_present");
+
     VkPresentInfoKHR present_info = { VK_STRUCTURE_TYPE_PRESENT_INFO_KHR };
     present_info.waitSemaphoreCount = 1;
     present_info.pWaitSemaphores = &render_complete_semaphore;
@@ -95,8 +97,9 @@ void create(vulkan_context* context, UInt32 width, UInt32 height, vulkan_swapcha
         swapchain->image_format = context->device.swapchain_support.formats[0];
     }
 
+    // FIFO is always supported.
     VkPresentModeKHR present_mode = VK_PRESENT_MODE_FIFO_KHR;
-    for (UInt32 i = 0; i < context->device.swapchain_support.present_mode_count; ++i) {
+    for (UInt32 i = 0; i < context->device.swapchain_support.present_mode_count && !context->vsync; ++i) {
         VkPresentModeKHR mode = context->device.swapchain_support.present_modes[i];
         if (mode == VK_PRESENT_MODE_MAILBOX_KHR) {
             present_mode = mode;
@@ -200,7 +203,7 @@ void create(vulkan_context* context, UInt32 width, UInt32 height, vulkan_swapcha
         VK_IMAGE_ASPECT_DEPTH_BIT,
         &swapchain->depth_attachment);
 
-    KINFO("Swapchain created successfully.");
+    KINFO_C(LOG_CATEGORY_VULKAN, "Swapchain created successfully.");
 }
 
 void destroy(vulkan_context* context, vulkan_swapchain* swapchain) {
@@ -151,6 +151,9 @@ typedef struct vulkan_context {
     UInt64 framebuffer_size_generation;
     UInt64 framebuffer_size_last_generation;
 
+    // Present with FIFO, which waits for vertical blank, instead of preferring mailbox.
+    Boolean vsync;
+
     VkInstance instance;
     VkAllocationCallbacks* allocator;
     VkSurfaceKHR surface;
@@ -0,0 +1,18 @@
+#include <core/logger.h>
+
+#include <stdio.h>
+
+// Converts a binary log written by log_set_binary_output back into text.
+int main(int argc, char** argv) {
+    if (argc != 3) {
+        printf("Usage: logdecoder <binary log> <output text file>\n");
+        return 1;
+    }
+
+    if (!log_decode_binary_file(argv[1], argv[2])) {
+        printf("Failed to decode '%s'.\n", argv[1]);
+        return 1;
+    }
+
+    return 0;
+}
\ No newline at end of file
@@ -10,6 +10,15 @@ Boolean create_game(game* out_game) {
     out_game->app_config.start_width = 1280;
     out_game->app_config.start_height = 720;
     out_game->app_config.name = "Kohi Engine Testbed";
+    out_game->app_config.heap_size = MEBIBYTES(256);
+    out_game->app_config.frame_allocator_size = MEBIBYTES(1);
+    out_game->app_config.job_worker_count = 0;
+    out_game->app_config.frame_stats_log_interval = 10.0;
+    out_game->app_config.frame_pacing = FRAME_PACING_FIXED;
+    out_game->app_config.target_frame_rate = 60;
+    out_game->app_config.fixed_update_rate = 60;
+    out_game->app_config.max_updates_per_frame = 5;
+    out_game->app_config.background_frame_rate = 10;
 
     out_game->update = game_update;
     out_game->render = game_render;
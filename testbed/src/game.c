@@ -3,25 +3,29 @@
 #include <core/logger.h>
 #include <core/input.h>
 #include <core/kmemory.h>
+#include <core/memory_profiler.h>
 
 Boolean game_initialize(game* game_inst) {
-    KDEBUG("game_initialize() called!");
+    KDEBUG_C(LOG_CATEGORY_GAME, "game_initialize() called!");
     return TRUE;
 }
 
 Boolean game_update(game* game_inst, Single delta_time) {
 
-    static UInt64 alloc_count = 0;
-    UInt64 prev_alloc_count = alloc_count;
-    alloc_count = get_memory_alloc_count();
     if (input_is_key_up('M') && input_was_key_down('M')) {
-        KDEBUG("Allocations: %llu (%llu this frame).", alloc_count, alloc_count - prev_alloc_count);
-    } 
+        if (memory_profiler_is_enabled()) {
+            char report[2048];
+            memory_profiler_frame_report(report, sizeof(report), 10);
+            KDEBUG_C(LOG_CATEGORY_GAME, "%s", report);
+        } else {
+            KDEBUG_C(LOG_CATEGORY_GAME, "Allocations: %llu. Run with --profile-memory to see where they come from.", get_memory_alloc_count());
+        }
+    }
 
     return TRUE;
 }
 
-Boolean game_render(game* game_inst, Single delta_time) {
+Boolean game_render(game* game_inst, Single delta_time, Single alpha) {
     return TRUE;
 }
 
@@ -11,6 +11,6 @@ Boolean game_initialize(game* game_inst);
 
 Boolean game_update(game* game_inst, Single delta_time);
 
-Boolean game_render(game* game_inst, Single delta_time);
+Boolean game_render(game* game_inst, Single delta_time, Single alpha);
 
 void game_on_resize(game* game_inst, UInt32 width, UInt32 height);
\ No newline at end of file
@@ -0,0 +1,82 @@
+#include "darray_tests.h"
+#include "../test_manager.h"
+#include "../expect.h"
+
+#include <defines.h>
+
+#include <containers/darray.h>
+
+UInt8 darray_should_push_and_grow() {
+    UInt64* array = darray_create(UInt64);
+    expect_should_be(DARRAY_DEFAULT_CAPACITY, darray_capacity(array));
+
+    for (UInt64 i = 0; i < 100; ++i) {
+        darray_push(array, i);
+    }
+
+    expect_should_be(100, darray_length(array));
+    expect_should_be(128, darray_capacity(array));
+    for (UInt64 i = 0; i < 100; ++i) {
+        expect_should_be(i, array[i]);
+    }
+
+    darray_destroy(array);
+
+    return TRUE;
+}
+
+UInt8 darray_aligned_should_stay_aligned_when_growing() {
+    Single* array = darray_create_aligned(Single, 64);
+    expect_should_be(64, darray_alignment(array));
+    expect_should_be(0, ((UInt64)array % 64));
+
+    for (UInt32 i = 0; i < 100; ++i) {
+        Single value = (Single)i;
+        darray_push(array, value);
+        expect_should_be(0, ((UInt64)array % 64));
+    }
+
+    expect_should_be(100, darray_length(array));
+    expect_should_be(99, (UInt64)array[99]);
+
+    darray_destroy(array);
+
+    Single* reserved = darray_reserve_aligned(Single, 16, 256);
+    expect_should_be(0, ((UInt64)reserved % 256));
+    expect_should_be(16, darray_capacity(reserved));
+    darray_destroy(reserved);
+
+    return TRUE;
+}
+
+UInt8 darray_insert_and_pop_at_shift_elements() {
+    UInt32* array = darray_create(UInt32);
+    for (UInt32 i = 0; i < 4; ++i) {
+        darray_push(array, i);
+    }
+
+    // Inserting before the last element must keep it.
+    UInt32 value = 10;
+    darray_insert_at(array, 3, value);
+    expect_should_be(5, darray_length(array));
+    expect_should_be(10, array[3]);
+    expect_should_be(3, array[4]);
+
+    UInt32 popped;
+    darray_pop_at(array, 1, &popped);
+    expect_should_be(1, popped);
+    expect_should_be(4, darray_length(array));
+    expect_should_be(2, array[1]);
+    expect_should_be(10, array[2]);
+    expect_should_be(3, array[3]);
+
+    darray_destroy(array);
+
+    return TRUE;
+}
+
+void darray_register_tests() {
+    test_manager_register_test(darray_should_push_and_grow, "Darray should push and grow");
+    test_manager_register_test(darray_aligned_should_stay_aligned_when_growing, "Darray aligned data stays aligned when growing");
+    test_manager_register_test(darray_insert_and_pop_at_shift_elements, "Darray insert and pop at shift elements");
+}
\ No newline at end of file
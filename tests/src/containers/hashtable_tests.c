@@ -0,0 +1,270 @@
+#include "hashtable_tests.h"
+#include "../test_manager.h"
+#include "../expect.h"
+
+#include <defines.h>
+
+#include <containers/hashtable.h>
+#include <core/clock.h>
+#include <core/kmemory.h>
+#include <core/kstring.h>
+#include <core/logger.h>
+
+typedef struct hashtable_test_value {
+    UInt64 id;
+    Single weight;
+} hashtable_test_value;
+
+UInt8 hashtable_should_set_and_get_values() {
+    hashtable table;
+    expect_to_be_true(hashtable_create(sizeof(hashtable_test_value), 16, 0, 0, FALSE, &table));
+    expect_should_be(32, table.capacity);
+
+    hashtable_test_value value = {7, 1.5f};
+    expect_to_be_true(hashtable_set(&table, "material.brick", &value));
+    value.id = 9;
+    expect_to_be_true(hashtable_set(&table, "material.stone", &value));
+    expect_should_be(2, table.count);
+
+    hashtable_test_value out = {0};
+    expect_to_be_true(hashtable_get(&table, "material.brick", &out));
+    expect_should_be(7, out.id);
+    expect_to_be_true(hashtable_get(&table, "material.stone", &out));
+    expect_should_be(9, out.id);
+    expect_to_be_false(hashtable_get(&table, "material.wood", &out));
+
+    // Setting an existing key replaces its value.
+    value.id = 11;
+    hashtable_set(&table, "material.brick", &value);
+    hashtable_get(&table, "material.brick", &out);
+    expect_should_be(11, out.id);
+    expect_should_be(2, table.count);
+
+    hashtable_destroy(&table);
+    expect_should_be(0, table.hashes);
+
+    return TRUE;
+}
+
+UInt8 hashtable_pointer_mode_stores_pointers() {
+    hashtable table;
+    hashtable_create(0, 8, 0, 0, TRUE, &table);
+
+    UInt64 a = 1, b = 2;
+    expect_to_be_true(hashtable_set_ptr(&table, "a", &a));
+    expect_to_be_true(hashtable_set_ptr(&table, "b", &b));
+
+    void* out = 0;
+    expect_to_be_true(hashtable_get_ptr(&table, "a", &out));
+    expect_should_be(&a, out);
+    expect_to_be_true(hashtable_get_ptr(&table, "b", &out));
+    expect_should_be(&b, out);
+
+    hashtable_destroy(&table);
+    return TRUE;
+}
+
+UInt8 hashtable_fixed_mode_uses_caller_memory() {
+    UInt64 requirement = hashtable_memory_requirement(sizeof(UInt32), 6, 0, FALSE);
+    void* memory = kallocate(requirement, MEMORY_TAG_DICT);
+
+    hashtable table;
+    hashtable_create(sizeof(UInt32), 6, 0, memory, FALSE, &table);
+    expect_should_be(memory, table.hashes);
+    expect_to_be_false(table.owns_memory);
+
+    char key[16];
+    for (UInt32 i = 0; i < 6; ++i) {
+        string_format(key, "key%u", i);
+        expect_to_be_true(hashtable_set(&table, key, &i));
+    }
+
+    KDEBUG("Note: The following error is intentionally caused by this test.");
+    UInt32 extra = 6;
+    expect_to_be_false(hashtable_set(&table, "key6", &extra));
+    expect_should_be(6, table.count);
+
+    hashtable_destroy(&table);
+    kfree(memory, requirement, MEMORY_TAG_DICT);
+
+    return TRUE;
+}
+
+UInt8 hashtable_fixed_pointer_mode_uses_caller_memory() {
+    // element_size is ignored for pointer tables, by the requirement as well as by create.
+    UInt64 requirement = hashtable_memory_requirement(0, 4, 0, TRUE);
+    expect_should_be(hashtable_memory_requirement(sizeof(void*), 4, 0, FALSE), requirement);
+    void* memory = kallocate(requirement, MEMORY_TAG_DICT);
+
+    hashtable table;
+    expect_to_be_true(hashtable_create(0, 4, 0, memory, TRUE, &table));
+
+    UInt64 values[4];
+    char key[16];
+    for (UInt32 i = 0; i < 4; ++i) {
+        string_format(key, "key%u", i);
+        expect_to_be_true(hashtable_set_ptr(&table, key, &values[i]));
+    }
+
+    void* out = 0;
+    expect_to_be_true(hashtable_get_ptr(&table, "key3", &out));
+    expect_should_be(&values[3], out);
+
+    hashtable_destroy(&table);
+    kfree(memory, requirement, MEMORY_TAG_DICT);
+
+    return TRUE;
+}
+
+UInt8 hashtable_grows_and_removes() {
+    hashtable table;
+    hashtable_create(sizeof(UInt32), 8, 0, 0, FALSE, &table);
+
+    char key[32];
+    const UInt32 count = 1000;
+    for (UInt32 i = 0; i < count; ++i) {
+        string_format(key, "entity_%u", i);
+        hashtable_set(&table, key, &i);
+    }
+    expect_should_be(count, table.count);
+    expect_should_be(2048, table.capacity);
+
+    // Remove every other key; the survivors must still be reachable through the shifted chains.
+    for (UInt32 i = 0; i < count; i += 2) {
+        string_format(key, "entity_%u", i);
+        expect_to_be_true(hashtable_remove(&table, key));
+    }
+    expect_should_be(count / 2, table.count);
+
+    for (UInt32 i = 0; i < count; ++i) {
+        string_format(key, "entity_%u", i);
+        UInt32 out = 0;
+        Boolean found = hashtable_get(&table, key, &out);
+        if (i % 2) {
+            expect_to_be_true(found);
+            expect_should_be(i, out);
+        } else {
+            expect_to_be_false(found);
+        }
+    }
+
+    hashtable_clear(&table);
+    expect_should_be(0, table.count);
+    expect_to_be_false(hashtable_get(&table, "entity_1", 0));
+
+    hashtable_destroy(&table);
+    return TRUE;
+}
+
+UInt8 hashtable_rejects_long_keys() {
+    hashtable table;
+    hashtable_create(sizeof(UInt32), 8, 0, 0, FALSE, &table);
+
+    char key[HASHTABLE_DEFAULT_KEY_CAPACITY + 1];
+    kset_memory(key, 'k', HASHTABLE_DEFAULT_KEY_CAPACITY);
+    key[HASHTABLE_DEFAULT_KEY_CAPACITY] = 0;
+
+    UInt32 value = 1;
+    KDEBUG("Note: The following error is intentionally caused by this test.");
+    expect_to_be_false(hashtable_set(&table, key, &value));
+
+    key[HASHTABLE_DEFAULT_KEY_CAPACITY - 1] = 0;
+    expect_to_be_true(hashtable_set(&table, key, &value));
+
+    hashtable_destroy(&table);
+    return TRUE;
+}
+
+UInt8 hashtable_key_capacity_fits_asset_paths() {
+    hashtable table;
+    expect_to_be_true(hashtable_create(sizeof(UInt32), 8, 256, 0, FALSE, &table));
+    expect_should_be(256, table.key_capacity);
+
+    // Long enough to share a prefix with its neighbours, as paths under one folder do.
+    char paths[20][256];
+    for (UInt32 i = 0; i < 20; ++i) {
+        kset_memory(paths[i], 'p', 240);
+        string_format(paths[i] + 240, "/%u.png", i);
+        expect_to_be_true(hashtable_set(&table, paths[i], &i));
+    }
+
+    // Growing and removing move whole keys, not just the first 64 bytes.
+    expect_to_be_true(hashtable_remove(&table, paths[3]));
+    for (UInt32 i = 0; i < 20; ++i) {
+        UInt32 value = 0;
+        expect_should_be((i != 3), hashtable_get(&table, paths[i], &value));
+        expect_should_be((i != 3 ? i : 0), value);
+    }
+
+    hashtable_destroy(&table);
+    return TRUE;
+}
+
+UInt8 hashtable_benchmark_against_linear_search() {
+    const UInt32 count = 512;
+    const UInt32 rounds = 64;
+
+    char (*keys)[32] = kallocate(sizeof(char[32]) * count, MEMORY_TAG_ARRAY);
+    for (UInt32 i = 0; i < count; ++i) {
+        string_format(keys[i], "textures/terrain_%u.png", i);
+    }
+
+    hashtable table;
+    hashtable_create(sizeof(UInt32), count, 0, 0, FALSE, &table);
+    for (UInt32 i = 0; i < count; ++i) {
+        hashtable_set(&table, keys[i], &i);
+    }
+
+    UInt64 table_sum = 0;
+    clock timer;
+    clock_start(&timer);
+    for (UInt32 r = 0; r < rounds; ++r) {
+        for (UInt32 i = 0; i < count; ++i) {
+            UInt32 out;
+            hashtable_get(&table, keys[(i * 7) % count], &out);
+            table_sum += out;
+        }
+    }
+    clock_update(&timer);
+    Double table_seconds = timer.elapsed;
+
+    UInt64 linear_sum = 0;
+    clock_start(&timer);
+    for (UInt32 r = 0; r < rounds; ++r) {
+        for (UInt32 i = 0; i < count; ++i) {
+            const char* key = keys[(i * 7) % count];
+            for (UInt32 j = 0; j < count; ++j) {
+                if (strings_equal(keys[j], key)) {
+                    linear_sum += j;
+                    break;
+                }
+            }
+        }
+    }
+    clock_update(&timer);
+    Double linear_seconds = timer.elapsed;
+
+    expect_should_be(linear_sum, table_sum);
+
+    Double lookups = (Double)count * rounds;
+    KINFO("Hashtable: %.2f M lookups/sec, linear search: %.2f M lookups/sec over %u keys (%.1fx).",
+          lookups / table_seconds / 1000000.0,
+          lookups / linear_seconds / 1000000.0,
+          count,
+          linear_seconds / table_seconds);
+
+    hashtable_destroy(&table);
+    kfree(keys, sizeof(char[32]) * count, MEMORY_TAG_ARRAY);
+    return TRUE;
+}
+
+void hashtable_register_tests() {
+    test_manager_register_test(hashtable_should_set_and_get_values, "Hashtable should set and get values");
+    test_manager_register_test(hashtable_pointer_mode_stores_pointers, "Hashtable pointer mode stores pointers");
+    test_manager_register_test(hashtable_fixed_mode_uses_caller_memory, "Hashtable fixed mode uses caller memory and refuses to overfill");
+    test_manager_register_test(hashtable_fixed_pointer_mode_uses_caller_memory, "Hashtable fixed pointer mode fits its memory requirement");
+    test_manager_register_test(hashtable_grows_and_removes, "Hashtable grows and removes without losing entries");
+    test_manager_register_test(hashtable_rejects_long_keys, "Hashtable rejects keys that are too long");
+    test_manager_register_test(hashtable_key_capacity_fits_asset_paths, "Hashtable key capacity is set per table");
+    test_manager_register_test(hashtable_benchmark_against_linear_search, "Hashtable lookups against linear search");
+}
\ No newline at end of file
@@ -0,0 +1,166 @@
+#include "ring_queue_tests.h"
+#include "../test_manager.h"
+#include "../expect.h"
+
+#include <defines.h>
+
+#include <containers/ring_queue.h>
+#include <core/clock.h>
+#include <core/kmemory.h>
+#include <core/logger.h>
+#include <platform/platform.h>
+
+static UInt8 ring_queue_fifo_in_mode(ring_queue_mode mode) {
+    ring_queue queue;
+    expect_to_be_true(ring_queue_create(mode, sizeof(UInt32), 4, 0, &queue));
+
+    UInt32 value = 0;
+    expect_to_be_false(ring_queue_dequeue(&queue, &value));
+
+    for (UInt32 i = 0; i < 4; ++i) {
+        expect_to_be_true(ring_queue_enqueue(&queue, &i));
+    }
+    UInt32 overflow = 99;
+    expect_to_be_false(ring_queue_enqueue(&queue, &overflow));
+    expect_should_be(4, ring_queue_count(&queue));
+
+    // Wrap around the end of the buffer a few times.
+    for (UInt32 i = 0; i < 10; ++i) {
+        expect_to_be_true(ring_queue_dequeue(&queue, &value));
+        expect_should_be(i, value);
+        UInt32 next = i + 4;
+        expect_to_be_true(ring_queue_enqueue(&queue, &next));
+    }
+
+    ring_queue_destroy(&queue);
+    expect_should_be(0, queue.slots);
+    return TRUE;
+}
+
+UInt8 ring_queue_spsc_is_fifo() {
+    return ring_queue_fifo_in_mode(RING_QUEUE_MODE_SPSC);
+}
+
+UInt8 ring_queue_mpmc_is_fifo() {
+    return ring_queue_fifo_in_mode(RING_QUEUE_MODE_MPMC);
+}
+
+UInt8 ring_queue_rejects_bad_capacity() {
+    ring_queue queue;
+    KDEBUG("Note: The following error is intentionally caused by this test.");
+    expect_to_be_false(ring_queue_create(RING_QUEUE_MODE_SPSC, sizeof(UInt32), 12, 0, &queue));
+
+    UInt64 requirement = ring_queue_memory_requirement(RING_QUEUE_MODE_MPMC, sizeof(UInt32), 8);
+    expect_should_be(128, requirement);
+    void* memory = kallocate(requirement, MEMORY_TAG_RING_QUEUE);
+    expect_to_be_true(ring_queue_create(RING_QUEUE_MODE_MPMC, sizeof(UInt32), 8, memory, &queue));
+    expect_should_be(memory, queue.slots);
+    ring_queue_destroy(&queue);
+    kfree(memory, requirement, MEMORY_TAG_RING_QUEUE);
+
+    return TRUE;
+}
+
+typedef struct ring_queue_thread_data {
+    ring_queue* queue;
+    UInt64 item_count;
+    UInt64 first_value;
+    UInt64 sum;
+    Boolean in_order;
+} ring_queue_thread_data;
+
+static UInt32 producer_thread(void* params) {
+    ring_queue_thread_data* data = params;
+    for (UInt64 i = 0; i < data->item_count; ++i) {
+        UInt64 value = data->first_value + i;
+        while (!ring_queue_enqueue(data->queue, &value)) {
+            platform_sleep(0);
+        }
+    }
+    return 0;
+}
+
+static UInt32 consumer_thread(void* params) {
+    ring_queue_thread_data* data = params;
+    UInt64 previous = 0;
+    data->in_order = TRUE;
+    for (UInt64 i = 0; i < data->item_count; ++i) {
+        UInt64 value;
+        while (!ring_queue_dequeue(data->queue, &value)) {
+            platform_sleep(0);
+        }
+        if (i > 0 && value <= previous) {
+            data->in_order = FALSE;
+        }
+        previous = value;
+        data->sum += value;
+    }
+    return 0;
+}
+
+static Double run_threads(ring_queue* queue, UInt32 producers, UInt32 consumers, UInt64 items_per_producer, UInt64* out_sum, Boolean* out_in_order) {
+    ring_queue_thread_data data[8] = {0};
+    kthread threads[8];
+    UInt64 items_per_consumer = items_per_producer * producers / consumers;
+
+    clock timer;
+    clock_start(&timer);
+    for (UInt32 i = 0; i < consumers; ++i) {
+        data[i].queue = queue;
+        data[i].item_count = items_per_consumer;
+        platform_thread_create(consumer_thread, &data[i], &threads[i]);
+    }
+    for (UInt32 i = 0; i < producers; ++i) {
+        ring_queue_thread_data* producer = &data[consumers + i];
+        producer->queue = queue;
+        producer->item_count = items_per_producer;
+        producer->first_value = (UInt64)i * items_per_producer;
+        platform_thread_create(producer_thread, producer, &threads[consumers + i]);
+    }
+    for (UInt32 i = 0; i < producers + consumers; ++i) {
+        platform_thread_destroy(&threads[i]);
+    }
+    clock_update(&timer);
+
+    *out_sum = 0;
+    *out_in_order = TRUE;
+    for (UInt32 i = 0; i < consumers; ++i) {
+        *out_sum += data[i].sum;
+        *out_in_order = *out_in_order && data[i].in_order;
+    }
+    return timer.elapsed;
+}
+
+UInt8 ring_queue_benchmark_contention() {
+    const UInt64 items = 200000;
+
+    ring_queue queue;
+    ring_queue_create(RING_QUEUE_MODE_SPSC, sizeof(UInt64), 1024, 0, &queue);
+    UInt64 sum;
+    Boolean in_order;
+    Double spsc_seconds = run_threads(&queue, 1, 1, items, &sum, &in_order);
+    expect_should_be((items * (items - 1) / 2), sum);
+    expect_to_be_true(in_order);
+    ring_queue_destroy(&queue);
+
+    // Each of the four producers hands out its own value range, so the total is known.
+    ring_queue_create(RING_QUEUE_MODE_MPMC, sizeof(UInt64), 1024, 0, &queue);
+    UInt64 total_items = items * 4;
+    Double mpmc_seconds = run_threads(&queue, 4, 4, items, &sum, &in_order);
+    expect_should_be((total_items * (total_items - 1) / 2), sum);
+    expect_should_be(0, ring_queue_count(&queue));
+    ring_queue_destroy(&queue);
+
+    KINFO("Ring queue: SPSC %.2f M items/sec (1:1), MPMC %.2f M items/sec (4:4).",
+          items / spsc_seconds / 1000000.0,
+          total_items / mpmc_seconds / 1000000.0);
+
+    return TRUE;
+}
+
+void ring_queue_register_tests() {
+    test_manager_register_test(ring_queue_spsc_is_fifo, "Ring queue SPSC mode is first in, first out");
+    test_manager_register_test(ring_queue_mpmc_is_fifo, "Ring queue MPMC mode is first in, first out");
+    test_manager_register_test(ring_queue_rejects_bad_capacity, "Ring queue rejects non power of two capacity");
+    test_manager_register_test(ring_queue_benchmark_contention, "Ring queue throughput under contention");
+}
\ No newline at end of file
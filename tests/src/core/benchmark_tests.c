@@ -0,0 +1,66 @@
+#include "benchmark_tests.h"
+#include "../test_manager.h"
+#include "../expect.h"
+
+#include <defines.h>
+
+#include <core/application.h>
+#include <core/benchmark.h>
+#include <core/kmemory.h>
+
+#include <string.h>
+
+UInt8 benchmark_counts_frames_and_allocations() {
+    benchmark bench;
+    benchmark_begin(&bench, 3, 1.0 / 60, 100, 10.0);
+
+    expect_to_be_false(benchmark_end_frame(&bench, 100, 10.1));
+    expect_to_be_false(benchmark_end_frame(&bench, 104, 10.2));
+    expect_to_be_true(benchmark_end_frame(&bench, 105, 10.3));
+    expect_should_be(3, bench.frames_run);
+    expect_should_be(4, bench.max_frame_allocs);
+    expect_should_be(2, bench.allocating_frames);
+    expect_to_be_true((bench.elapsed_seconds > 0.299 && bench.elapsed_seconds < 0.301));
+
+    frame_stats_report report;
+    kzero_memory(&report, sizeof(report));
+    report.window_count = 3;
+    report.channels[FRAME_STAT_FRAME].p99 = 0.0125;
+
+    char json[4096];
+    UInt64 length = benchmark_write_json(&bench, &report, json, sizeof(json));
+    expect_to_be_true((length > 0 && length == strlen(json)));
+    expect_to_be_true((strstr(json, "\"frames\": 3,") != 0));
+    expect_to_be_true((strstr(json, "\"allocations\": 5,") != 0));
+    expect_to_be_true((strstr(json, "\"frame\": {\"min\": 0.0000, \"avg\": 0.0000, \"p50\": 0.0000, \"p95\": 0.0000, \"p99\": 12.5000") != 0));
+    expect_to_be_true((json[length - 2] == '}'));
+
+    // A buffer that is too small gets nothing rather than half a document.
+    expect_should_be(0, benchmark_write_json(&bench, &report, json, 64));
+    expect_should_be(0, benchmark_write_json(&bench, &report, json, length));
+    return TRUE;
+}
+
+UInt8 benchmark_parses_command_line() {
+    application_config config;
+    kzero_memory(&config, sizeof(config));
+
+    char* args[] = {"testbed", "--headless", "--benchmark", "600", "--benchmark-output", "bench.json"};
+    expect_to_be_true(benchmark_parse_arguments(6, args, &config));
+    expect_to_be_true(config.headless);
+    expect_should_be(600, config.benchmark_frame_count);
+    expect_to_be_true((strcmp(config.benchmark_output_path, "bench.json") == 0));
+
+    char* bad_count[] = {"testbed", "--benchmark", "lots"};
+    expect_to_be_false(benchmark_parse_arguments(3, bad_count, &config));
+    char* unknown[] = {"testbed", "--fast"};
+    expect_to_be_false(benchmark_parse_arguments(2, unknown, &config));
+    char* missing_count[] = {"testbed", "--benchmark"};
+    expect_to_be_false(benchmark_parse_arguments(2, missing_count, &config));
+    return TRUE;
+}
+
+void benchmark_register_tests() {
+    test_manager_register_test(benchmark_counts_frames_and_allocations, "Benchmark counts frames and allocations and writes JSON");
+    test_manager_register_test(benchmark_parses_command_line, "Benchmark options parse from the command line");
+}
\ No newline at end of file
@@ -0,0 +1,308 @@
+#include "event_tests.h"
+#include "../test_manager.h"
+#include "../expect.h"
+#include "../test_systems.h"
+
+#include <defines.h>
+
+#include <core/event.h>
+#include <core/kmemory.h>
+#include <platform/platform.h>
+
+#define TEST_EVENT_CODE 0x100
+
+typedef struct event_test_listener {
+    UInt32 calls;
+    UInt16 last_code;
+    UInt32 values[64];
+} event_test_listener;
+
+static Boolean on_test_event(UInt16 code, void* sender, void* listener_inst, event_context context) {
+    event_test_listener* listener = listener_inst;
+    if (listener->calls < 64) {
+        listener->values[listener->calls] = context.data.u32[0];
+    }
+    listener->calls++;
+    listener->last_code = code;
+    return FALSE;
+}
+
+UInt8 event_post_defers_until_dispatch() {
+    test_system events;
+    test_system_start(&events, event_system_initialize);
+
+    event_test_listener listener = {0};
+    event_register(TEST_EVENT_CODE, &listener, on_test_event);
+
+    for (UInt32 i = 0; i < 3; ++i) {
+        event_context context = {0};
+        context.data.u32[0] = i;
+        expect_to_be_true(event_post(TEST_EVENT_CODE, 0, context));
+    }
+    expect_should_be(0, listener.calls);
+
+    event_dispatch_posted();
+    expect_should_be(3, listener.calls);
+    for (UInt32 i = 0; i < 3; ++i) {
+        expect_should_be(i, listener.values[i]);
+    }
+
+    // Nothing left over for the next frame.
+    event_dispatch_posted();
+    expect_should_be(3, listener.calls);
+
+    test_system_stop(&events, event_system_shutdown);
+    return TRUE;
+}
+
+UInt8 event_post_coalesces_superseded_events() {
+    test_system events;
+    test_system_start(&events, event_system_initialize);
+
+    event_test_listener moves = {0};
+    event_test_listener keys = {0};
+    event_register(EVENT_CODE_MOUSE_MOVED, &moves, on_test_event);
+    event_register(EVENT_CODE_KEY_PRESSED, &keys, on_test_event);
+
+    for (UInt32 i = 0; i < 10; ++i) {
+        event_context context = {0};
+        context.data.u32[0] = i;
+        event_post(EVENT_CODE_MOUSE_MOVED, 0, context);
+        event_post(EVENT_CODE_KEY_PRESSED, 0, context);
+    }
+
+    event_dispatch_posted();
+    expect_should_be(1, moves.calls);
+    expect_should_be(9, moves.values[0]);
+    expect_should_be(10, keys.calls);
+
+    event_queue_stats stats;
+    event_get_queue_stats(&stats);
+    expect_should_be(20, stats.posted_count);
+    expect_should_be(9, stats.coalesced_count);
+    expect_should_be(11, stats.dispatched_count);
+    expect_should_be(11, stats.last_dispatch_count);
+
+    // Coalescing can be switched off per code.
+    event_set_coalescing(EVENT_CODE_MOUSE_MOVED, FALSE);
+    event_context context = {0};
+    event_post(EVENT_CODE_MOUSE_MOVED, 0, context);
+    event_post(EVENT_CODE_MOUSE_MOVED, 0, context);
+    event_dispatch_posted();
+    expect_should_be(3, moves.calls);
+
+    test_system_stop(&events, event_system_shutdown);
+    return TRUE;
+}
+
+typedef struct event_poster_data {
+    UInt32 first_value;
+    UInt32 count;
+} event_poster_data;
+
+static UInt32 event_poster_thread(void* params) {
+    event_poster_data* data = params;
+    for (UInt32 i = 0; i < data->count; ++i) {
+        event_context context = {0};
+        context.data.u32[0] = data->first_value + i;
+        while (!event_post(TEST_EVENT_CODE, 0, context)) {
+            platform_sleep(0);
+        }
+    }
+    return 0;
+}
+
+typedef struct event_sum_listener {
+    UInt64 sum;
+    UInt32 count;
+} event_sum_listener;
+
+static Boolean on_sum_event(UInt16 code, void* sender, void* listener_inst, event_context context) {
+    event_sum_listener* listener = listener_inst;
+    listener->sum += context.data.u32[0];
+    listener->count++;
+    return FALSE;
+}
+
+UInt8 event_post_is_safe_from_other_threads() {
+    test_system events;
+    test_system_start(&events, event_system_initialize);
+
+    event_sum_listener listener = {0};
+    event_register(TEST_EVENT_CODE, &listener, on_sum_event);
+
+    event_poster_data data[4];
+    kthread threads[4];
+    for (UInt32 i = 0; i < 4; ++i) {
+        data[i].first_value = i * 1000;
+        data[i].count = 1000;
+        platform_thread_create(event_poster_thread, &data[i], &threads[i]);
+    }
+
+    // Keep dispatching like the frame loop would, while the threads post.
+    while (listener.count < 4000) {
+        event_dispatch_posted();
+        platform_sleep(0);
+    }
+    for (UInt32 i = 0; i < 4; ++i) {
+        platform_thread_destroy(&threads[i]);
+    }
+
+    expect_should_be((UInt64)(3999 * 4000 / 2), listener.sum);
+
+    test_system_stop(&events, event_system_shutdown);
+    return TRUE;
+}
+
+typedef struct priority_test_listener {
+    UInt32* order;
+    UInt32* count;
+    UInt32 id;
+} priority_test_listener;
+
+static Boolean on_priority_event(UInt16 code, void* sender, void* listener_inst, event_context context) {
+    priority_test_listener* listener = listener_inst;
+    listener->order[(*listener->count)++] = listener->id;
+    return FALSE;
+}
+
+UInt8 event_listeners_fire_in_priority_order() {
+    test_system events;
+    test_system_start(&events, event_system_initialize);
+
+    UInt32 order[4];
+    UInt32 count = 0;
+    priority_test_listener listeners[4] = {
+        {order, &count, 0},
+        {order, &count, 1},
+        {order, &count, 2},
+        {order, &count, 3}};
+    event_register_listener(TEST_EVENT_CODE, &listeners[0], on_priority_event, 0);
+    event_register_listener(TEST_EVENT_CODE, &listeners[1], on_priority_event, 10);
+    event_register_listener(TEST_EVENT_CODE, &listeners[2], on_priority_event, -5);
+    event_register_listener(TEST_EVENT_CODE, &listeners[3], on_priority_event, 0);
+
+    event_context context = {0};
+    event_fire(TEST_EVENT_CODE, 0, context);
+    expect_should_be(4, count);
+    expect_should_be(1, order[0]);
+    expect_should_be(0, order[1]);
+    expect_should_be(3, order[2]);
+    expect_should_be(2, order[3]);
+
+    test_system_stop(&events, event_system_shutdown);
+    return TRUE;
+}
+
+UInt8 event_handles_unregister_and_go_stale() {
+    test_system events;
+    test_system_start(&events, event_system_initialize);
+
+    event_test_listener listener = {0};
+    event_listener_handle handle = event_register_listener(TEST_EVENT_CODE, &listener, on_test_event, EVENT_PRIORITY_DEFAULT);
+    expect_should_not_be(INVALID_EVENT_LISTENER_HANDLE, handle);
+
+    event_context context = {0};
+    event_fire(TEST_EVENT_CODE, 0, context);
+    expect_should_be(1, listener.calls);
+
+    expect_to_be_true(event_unregister_listener(handle));
+    expect_to_be_false(event_unregister_listener(handle));
+    event_fire(TEST_EVENT_CODE, 0, context);
+    expect_should_be(1, listener.calls);
+
+    // The slot is reused, but the old handle must not reach the new listener.
+    event_listener_handle reused = event_register_listener(TEST_EVENT_CODE, &listener, on_test_event, EVENT_PRIORITY_DEFAULT);
+    expect_should_not_be(handle, reused);
+    expect_to_be_false(event_unregister_listener(handle));
+    event_fire(TEST_EVENT_CODE, 0, context);
+    expect_should_be(2, listener.calls);
+
+    // The legacy pointer-based API still works alongside handles.
+    expect_to_be_false(event_register(TEST_EVENT_CODE, &listener, on_test_event));
+    expect_to_be_true(event_unregister(TEST_EVENT_CODE, &listener, on_test_event));
+    event_fire(TEST_EVENT_CODE, 0, context);
+    expect_should_be(2, listener.calls);
+
+    test_system_stop(&events, event_system_shutdown);
+    return TRUE;
+}
+
+typedef struct reentrant_test_listener {
+    UInt32 calls;
+    event_listener_handle self;
+    event_listener_handle victim;
+    event_test_listener* added;
+} reentrant_test_listener;
+
+static Boolean on_reentrant_event(UInt16 code, void* sender, void* listener_inst, event_context context) {
+    reentrant_test_listener* listener = listener_inst;
+    listener->calls++;
+    if (listener->calls == 1) {
+        event_unregister_listener(listener->self);
+        event_unregister_listener(listener->victim);
+        event_register_listener(code, listener->added, on_test_event, 100);
+    }
+    return FALSE;
+}
+
+UInt8 event_registry_changes_during_fire_are_safe() {
+    test_system events;
+    test_system_start(&events, event_system_initialize);
+
+    event_test_listener victim = {0};
+    event_test_listener added = {0};
+    reentrant_test_listener reentrant = {0};
+    reentrant.added = &added;
+    reentrant.self = event_register_listener(TEST_EVENT_CODE, &reentrant, on_reentrant_event, 1);
+    reentrant.victim = event_register_listener(TEST_EVENT_CODE, &victim, on_test_event, 0);
+
+    event_context context = {0};
+    event_fire(TEST_EVENT_CODE, 0, context);
+    // The removed listener is skipped, and the new one waits for the next fire.
+    expect_should_be(1, reentrant.calls);
+    expect_should_be(0, victim.calls);
+    expect_should_be(0, added.calls);
+
+    event_fire(TEST_EVENT_CODE, 0, context);
+    expect_should_be(1, reentrant.calls);
+    expect_should_be(1, added.calls);
+
+    test_system_stop(&events, event_system_shutdown);
+    return TRUE;
+}
+
+UInt8 event_registry_handles_many_listeners() {
+    test_system events;
+    test_system_start(&events, event_system_initialize);
+
+    event_test_listener listeners[512] = {0};
+    event_listener_handle handles[512];
+    for (UInt32 i = 0; i < 512; ++i) {
+        handles[i] = event_register_listener(TEST_EVENT_CODE, &listeners[i], on_test_event, (Int16)(i % 7));
+    }
+
+    // Detach every other listener, as scene objects stream out.
+    for (UInt32 i = 0; i < 512; i += 2) {
+        expect_to_be_true(event_unregister_listener(handles[i]));
+    }
+
+    event_context context = {0};
+    event_fire(TEST_EVENT_CODE, 0, context);
+    for (UInt32 i = 0; i < 512; ++i) {
+        expect_should_be((i % 2), listeners[i].calls);
+    }
+
+    test_system_stop(&events, event_system_shutdown);
+    return TRUE;
+}
+
+void event_register_tests() {
+    test_manager_register_test(event_post_defers_until_dispatch, "Posted events are held until dispatch");
+    test_manager_register_test(event_post_coalesces_superseded_events, "Posted mouse moves coalesce to the latest");
+    test_manager_register_test(event_post_is_safe_from_other_threads, "Events can be posted from other threads");
+    test_manager_register_test(event_listeners_fire_in_priority_order, "Event listeners fire in priority order");
+    test_manager_register_test(event_handles_unregister_and_go_stale, "Event listener handles unregister and go stale");
+    test_manager_register_test(event_registry_changes_during_fire_are_safe, "Event registry changes during a fire are safe");
+    test_manager_register_test(event_registry_handles_many_listeners, "Event registry handles many listeners");
+}
\ No newline at end of file
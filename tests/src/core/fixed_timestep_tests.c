@@ -0,0 +1,58 @@
+#include "fixed_timestep_tests.h"
+#include "../test_manager.h"
+#include "../expect.h"
+
+#include <defines.h>
+
+#include <core/fixed_timestep.h>
+
+UInt8 fixed_timestep_steps_with_frame_time() {
+    fixed_timestep timestep;
+    fixed_timestep_create(60, 5, &timestep);
+
+    // 30 fps runs two steps a frame, 120 fps one step every other frame.
+    expect_should_be(2, fixed_timestep_advance(&timestep, 1.0 / 30));
+    expect_should_be(2, fixed_timestep_advance(&timestep, 1.0 / 30));
+    expect_to_be_true((fixed_timestep_alpha(&timestep) < 0.001f));
+
+    expect_should_be(0, fixed_timestep_advance(&timestep, 1.0 / 120));
+    Single alpha = fixed_timestep_alpha(&timestep);
+    expect_to_be_true((alpha > 0.499f && alpha < 0.501f));
+    expect_should_be(1, fixed_timestep_advance(&timestep, 1.0 / 120));
+    expect_should_be(5, timestep.step_count);
+
+    // Irregular frames still add up to one step per 60th of a second.
+    fixed_timestep_create(60, 1000, &timestep);
+    Double total = 0;
+    UInt64 steps = 0;
+    for (UInt32 i = 0; i < 1000; ++i) {
+        Double frame = 0.004 + (i * 7919 % 23) * 0.001;
+        total += frame;
+        steps += fixed_timestep_advance(&timestep, frame);
+    }
+    expect_should_be((UInt64)(total * 60 + 0.000001), steps);
+    expect_to_be_true((timestep.dropped_seconds == 0));
+    return TRUE;
+}
+
+UInt8 fixed_timestep_caps_catch_up() {
+    fixed_timestep timestep;
+    fixed_timestep_create(60, 0, &timestep);
+    expect_should_be(5, timestep.max_steps_per_frame);
+
+    // A one second hitch runs the cap, drops the whole steps past it and keeps the fraction.
+    fixed_timestep_advance(&timestep, 0.5 / 60);
+    expect_should_be(5, fixed_timestep_advance(&timestep, 1.0));
+    Double dropped = timestep.dropped_seconds - 55.0 / 60;
+    expect_to_be_true((dropped > -0.000001 && dropped < 0.000001));
+    expect_to_be_true((timestep.accumulator < timestep.step_seconds));
+
+    // The next normal frame is back to normal instead of catching up further.
+    expect_should_be(1, fixed_timestep_advance(&timestep, 1.0 / 60));
+    return TRUE;
+}
+
+void fixed_timestep_register_tests() {
+    test_manager_register_test(fixed_timestep_steps_with_frame_time, "Fixed timestep runs steps in proportion to frame time");
+    test_manager_register_test(fixed_timestep_caps_catch_up, "Fixed timestep caps catch-up steps");
+}
\ No newline at end of file
@@ -0,0 +1,83 @@
+#include "frame_pacer_tests.h"
+#include "../test_manager.h"
+#include "../expect.h"
+
+#include <defines.h>
+
+#include <core/clock.h>
+#include <core/logger.h>
+#include <core/frame_pacer.h>
+#include <platform/platform.h>
+
+UInt8 frame_pacer_holds_fixed_rate() {
+    const UInt32 frame_count = 100;
+    frame_pacer pacer;
+    frame_pacer_create(FRAME_PACING_FIXED, 200, &pacer);
+    frame_pacer_wait(&pacer);
+
+    // Each frame is measured against its own deadline, so a stall on a busy machine costs a
+    // few late frames here rather than failing a comparison against the wall clock.
+    Boolean started_early = FALSE;
+    for (UInt32 i = 0; i < frame_count; ++i) {
+        started_early |= frame_pacer_wait(&pacer) < 0;
+    }
+    expect_to_be_false(started_early);
+    expect_should_be(frame_count, pacer.frame_count);
+    expect_to_be_true((pacer.late_count < frame_count / 4));
+
+    KINFO("Frame pacer: %.3f ms mean error, %.3f ms worst, %llu of %u frames late at 200 Hz.",
+          pacer.total_error / pacer.frame_count * 1000.0, pacer.max_error * 1000.0, pacer.late_count, frame_count);
+    return TRUE;
+}
+
+UInt8 frame_pacer_resyncs_after_stall() {
+    frame_pacer pacer;
+    frame_pacer_create(FRAME_PACING_FIXED, 100, &pacer);
+    frame_pacer_wait(&pacer);
+    frame_pacer_wait(&pacer);
+
+    // A stall several frames long is reported once, then the cadence restarts from now.
+    platform_sleep(50);
+    Double error = frame_pacer_wait(&pacer);
+    expect_to_be_true((error > 0.030));
+
+    clock timer;
+    clock_start(&timer);
+    for (UInt32 i = 0; i < 3; ++i) {
+        frame_pacer_wait(&pacer);
+    }
+    clock_update(&timer);
+    expect_to_be_true((timer.elapsed > 0.025));
+    return TRUE;
+}
+
+UInt8 frame_pacer_uncapped_never_waits() {
+    frame_pacer pacer;
+    frame_pacer_create(FRAME_PACING_UNCAPPED, 1, &pacer);
+
+    clock timer;
+    clock_start(&timer);
+    for (UInt32 i = 0; i < 1000; ++i) {
+        expect_to_be_true((frame_pacer_wait(&pacer) == 0));
+    }
+    clock_update(&timer);
+    expect_to_be_true((timer.elapsed < 0.1));
+    expect_should_be(0, pacer.frame_count);
+
+    // Vsync measures against the expected refresh rate but leaves the waiting to presentation.
+    frame_pacer_create(FRAME_PACING_VSYNC, 1, &pacer);
+    clock_start(&timer);
+    for (UInt32 i = 0; i < 10; ++i) {
+        frame_pacer_wait(&pacer);
+    }
+    clock_update(&timer);
+    expect_to_be_true((timer.elapsed < 0.1));
+    expect_should_be(9, pacer.frame_count);
+    return TRUE;
+}
+
+void frame_pacer_register_tests() {
+    test_manager_register_test(frame_pacer_holds_fixed_rate, "Frame pacer holds a fixed rate");
+    test_manager_register_test(frame_pacer_resyncs_after_stall, "Frame pacer restarts its cadence after a stall");
+    test_manager_register_test(frame_pacer_uncapped_never_waits, "Frame pacer does not wait when uncapped or on vsync");
+}
\ No newline at end of file
@@ -0,0 +1,146 @@
+#include "frame_stats_tests.h"
+#include "../test_manager.h"
+#include "../expect.h"
+#include "../test_systems.h"
+
+#include <defines.h>
+
+#include <core/clock.h>
+#include <core/kmemory.h>
+#include <core/logger.h>
+#include <core/kstring.h>
+#include <core/frame_stats.h>
+#include <platform/filesystem.h>
+
+static Boolean nearly(Double expected, Double actual) {
+    Double difference = expected - actual;
+    return difference < 0.000001 && difference > -0.000001;
+}
+
+UInt8 frame_stats_reports_percentiles() {
+    test_system frame_stats;
+    test_system_start(&frame_stats, frame_stats_system_initialize);
+
+    frame_stats_report report;
+    frame_stats_get_report(&report);
+    expect_should_be(0, report.window_count);
+
+    // Frames of 1 to 100 ms, shuffled, with update recorded in two parts.
+    for (UInt32 i = 0; i < 100; ++i) {
+        UInt32 ms = (i * 37) % 100 + 1;
+        frame_stats_record(FRAME_STAT_UPDATE, ms * 0.0001);
+        frame_stats_record(FRAME_STAT_UPDATE, ms * 0.0001);
+        frame_stats_record(FRAME_STAT_PRESENT, 0.001);
+        frame_stats_end_frame(ms * 0.001);
+    }
+
+    frame_stats_get_report(&report);
+    expect_should_be(100, report.frame_count);
+    expect_should_be(100, report.window_count);
+    const frame_stat_summary* frame = &report.channels[FRAME_STAT_FRAME];
+    expect_to_be_true(nearly(0.001, frame->min));
+    expect_to_be_true(nearly(0.100, frame->max));
+    expect_to_be_true(nearly(0.0505, frame->average));
+    expect_to_be_true(nearly(0.050, frame->p50));
+    expect_to_be_true(nearly(0.095, frame->p95));
+    expect_to_be_true(nearly(0.099, frame->p99));
+    expect_to_be_true(nearly(0.020, report.channels[FRAME_STAT_UPDATE].max));
+    expect_to_be_true(nearly(0.001, report.channels[FRAME_STAT_PRESENT].p50));
+    expect_to_be_true(nearly(0, report.channels[FRAME_STAT_RENDER].max));
+    // Frames over 100 ms, twice the median, would be stutters; there are none.
+    expect_should_be(0, report.stutter_count);
+
+    test_system_stop(&frame_stats, frame_stats_system_shutdown);
+    return TRUE;
+}
+
+UInt8 frame_stats_window_rolls_over() {
+    test_system frame_stats;
+    test_system_start(&frame_stats, frame_stats_system_initialize);
+
+    // A slow start that falls out of the window, then steady frames with a few hitches.
+    for (UInt32 i = 0; i < 10; ++i) {
+        frame_stats_end_frame(1.0);
+    }
+    for (UInt32 i = 0; i < FRAME_STATS_WINDOW; ++i) {
+        frame_stats_end_frame(i % 100 == 0 ? 0.050 : 0.016);
+    }
+
+    frame_stats_report report;
+    frame_stats_get_report(&report);
+    expect_should_be(FRAME_STATS_WINDOW + 10, report.frame_count);
+    expect_should_be(FRAME_STATS_WINDOW, report.window_count);
+    expect_to_be_true(nearly(0.050, report.channels[FRAME_STAT_FRAME].max));
+    expect_to_be_true(nearly(0.016, report.channels[FRAME_STAT_FRAME].p50));
+    expect_should_be(11, report.stutter_count);
+
+    test_system_stop(&frame_stats, frame_stats_system_shutdown);
+    return TRUE;
+}
+
+UInt8 frame_stats_writes_csv() {
+    test_system frame_stats;
+    test_system_start(&frame_stats, frame_stats_system_initialize);
+
+    expect_to_be_true(frame_stats_set_csv_output("frame_stats_test.csv"));
+    for (UInt32 i = 0; i < 3; ++i) {
+        frame_stats_record(FRAME_STAT_RENDER, 0.002);
+        frame_stats_end_frame(0.016);
+    }
+    frame_stats_set_csv_output(0);
+
+    file_handle file;
+    expect_to_be_true(filesystem_open("frame_stats_test.csv", FILE_MODE_READ, FALSE, &file));
+    char* line = 0;
+    UInt32 line_count = 0;
+    while (filesystem_read_line(&file, &line)) {
+        line_count++;
+        if (line_count == 2) {
+            expect_to_be_true(strings_equal("1,16.0000,0.0000,2.0000,0.0000,0.0000\n", line));
+        }
+        kfree(line, string_length(line) + 1, MEMORY_TAG_STRING);
+        line = 0;
+    }
+    filesystem_close(&file);
+    expect_should_be(4, line_count);
+
+    test_system_stop(&frame_stats, frame_stats_system_shutdown);
+    return TRUE;
+}
+
+UInt8 frame_stats_benchmark_cost() {
+    test_system frame_stats;
+    test_system_start(&frame_stats, frame_stats_system_initialize);
+
+    const UInt32 frame_count = 100000;
+    clock timer;
+    clock_start(&timer);
+    for (UInt32 i = 0; i < frame_count; ++i) {
+        frame_stats_record(FRAME_STAT_UPDATE, 0.004);
+        frame_stats_record(FRAME_STAT_RENDER, 0.006);
+        frame_stats_record(FRAME_STAT_PRESENT, 0.002);
+        frame_stats_end_frame(0.016 + (i % 7) * 0.001);
+    }
+    clock_update(&timer);
+    Double record_seconds = timer.elapsed;
+
+    frame_stats_report report;
+    clock_start(&timer);
+    frame_stats_get_report(&report);
+    clock_update(&timer);
+    Double report_seconds = timer.elapsed;
+
+    expect_should_be(frame_count, report.frame_count);
+    test_system_stop(&frame_stats, frame_stats_system_shutdown);
+
+    KINFO("Frame stats: %.1f ns per frame recorded, %.1f us per report over %u frames.",
+          record_seconds / frame_count * 1000000000.0, report_seconds * 1000000.0, report.window_count);
+    return TRUE;
+}
+
+void frame_stats_register_tests() {
+    test_manager_register_test(frame_stats_reports_percentiles, "Frame stats report min/avg/percentiles/max");
+    test_manager_register_test(frame_stats_window_rolls_over, "Frame stats only cover the rolling window");
+    test_manager_register_test(frame_stats_writes_csv, "Frame stats write a CSV row per frame");
+    test_manager_register_test(frame_stats_benchmark_cost, "Frame stats cost per frame");
+}
\ No newline at end of file
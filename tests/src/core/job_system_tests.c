@@ -0,0 +1,257 @@
+#include "job_system_tests.h"
+#include "../test_manager.h"
+#include "../expect.h"
+#include "../test_systems.h"
+
+#include <defines.h>
+
+#include <core/clock.h>
+#include <core/kmemory.h>
+#include <core/job_system.h>
+#include <platform/platform.h>
+
+#include <stdatomic.h>
+
+static void job_increment(void* params) {
+    atomic_fetch_add((_Atomic UInt32*)params, 1);
+}
+
+UInt8 job_system_runs_all_submitted_jobs() {
+    test_system jobs;
+    test_system_start(&jobs, job_system_initialize, 3);
+    expect_should_be(3, job_system_worker_count());
+
+    _Atomic UInt32 total = 0;
+    job_counter counter = {0};
+    const UInt32 job_count = 2000;
+    for (UInt32 i = 0; i < job_count; ++i) {
+        job_info job = {0};
+        job.entry_point = job_increment;
+        job.params = &total;
+        job.priority = (i % 2) ? JOB_PRIORITY_LOW : JOB_PRIORITY_HIGH;
+        job.counter = &counter;
+        job_submit(&job);
+    }
+
+    job_counter_wait(&counter);
+    expect_should_be(0, atomic_load(&counter.value));
+    expect_should_be(job_count, atomic_load(&total));
+
+    test_system_stop(&jobs, job_system_shutdown);
+    return TRUE;
+}
+
+UInt8 job_system_runs_inline_when_not_started() {
+    _Atomic UInt32 total = 0;
+    job_counter counter = {0};
+    job_info job = {0};
+    job.entry_point = job_increment;
+    job.params = &total;
+    job.counter = &counter;
+    job_submit(&job);
+
+    expect_should_be(1, atomic_load(&total));
+    expect_should_be(0, atomic_load(&counter.value));
+    return TRUE;
+}
+
+typedef struct dependency_test_data {
+    _Atomic UInt32 first_stage_done;
+    _Atomic UInt32 violations;
+    _Atomic UInt32 second_stage_done;
+} dependency_test_data;
+
+static void first_stage_job(void* params) {
+    dependency_test_data* data = params;
+    platform_sleep(1);
+    atomic_fetch_add(&data->first_stage_done, 1);
+}
+
+static void second_stage_job(void* params) {
+    dependency_test_data* data = params;
+    if (atomic_load(&data->first_stage_done) != 8) {
+        atomic_fetch_add(&data->violations, 1);
+    }
+    atomic_fetch_add(&data->second_stage_done, 1);
+}
+
+UInt8 job_system_waits_for_dependencies() {
+    test_system jobs;
+    test_system_start(&jobs, job_system_initialize, 4);
+
+    dependency_test_data data = {0};
+    job_counter first_stage = {0};
+    job_counter second_stage = {0};
+
+    for (UInt32 i = 0; i < 8; ++i) {
+        job_info job = {0};
+        job.entry_point = first_stage_job;
+        job.params = &data;
+        job.counter = &first_stage;
+        job_submit(&job);
+    }
+
+    for (UInt32 i = 0; i < 8; ++i) {
+        job_info job = {0};
+        job.entry_point = second_stage_job;
+        job.params = &data;
+        job.counter = &second_stage;
+        job.dependency = &first_stage;
+        job_submit(&job);
+    }
+
+    job_counter_wait(&second_stage);
+    expect_should_be(8, atomic_load(&data.first_stage_done));
+    expect_should_be(8, atomic_load(&data.second_stage_done));
+    expect_should_be(0, atomic_load(&data.violations));
+
+    test_system_stop(&jobs, job_system_shutdown);
+    return TRUE;
+}
+
+static void record_thread_job(void* params) {
+    *(UInt64*)params = platform_current_thread_id();
+}
+
+UInt8 job_system_main_thread_jobs_run_on_main_thread() {
+    test_system jobs;
+    test_system_start(&jobs, job_system_initialize, 2);
+
+    UInt64 ran_on = 0;
+    job_info job = {0};
+    job.entry_point = record_thread_job;
+    job.params = &ran_on;
+    job.main_thread_only = TRUE;
+    job_submit(&job);
+
+    // Main-thread jobs wait for the frame update; workers never pick them up.
+    platform_sleep(5);
+    expect_should_be(0, ran_on);
+
+    job_system_update();
+    expect_should_be(platform_current_thread_id(), ran_on);
+
+    test_system_stop(&jobs, job_system_shutdown);
+    return TRUE;
+}
+
+typedef struct benchmark_chunk {
+    const Single* values;
+    UInt32 count;
+    Double result;
+} benchmark_chunk;
+
+static void benchmark_job(void* params) {
+    benchmark_chunk* chunk = params;
+    Double sum = 0;
+    for (UInt32 i = 0; i < chunk->count; ++i) {
+        Double v = chunk->values[i];
+        sum += v * v + v * 0.5;
+    }
+    chunk->result = sum;
+}
+
+UInt8 job_system_benchmark_worker_scaling() {
+    const UInt32 value_count = 1 << 20;
+    const UInt32 chunk_count = 256;
+    const UInt32 rounds = 16;
+    const UInt32 chunk_size = value_count / chunk_count;
+
+    Single* values = kallocate(sizeof(Single) * value_count, MEMORY_TAG_ARRAY);
+    for (UInt32 i = 0; i < value_count; ++i) {
+        values[i] = (Single)(i % 1000) * 0.001f;
+    }
+    benchmark_chunk* chunks = kallocate(sizeof(benchmark_chunk) * chunk_count, MEMORY_TAG_ARRAY);
+
+    // Always exercise several workers, even where they outnumber the processors.
+    UInt32 max_workers = platform_get_processor_count();
+    if (max_workers < 4) {
+        max_workers = 4;
+    } else if (max_workers > 8) {
+        max_workers = 8;
+    }
+
+    Double single_worker_seconds = 0;
+    Double reference = 0;
+    for (UInt32 workers = 1; workers <= max_workers; workers *= 2) {
+        test_system jobs;
+        test_system_start(&jobs, job_system_initialize, workers);
+
+        clock timer;
+        clock_start(&timer);
+        for (UInt32 r = 0; r < rounds; ++r) {
+            job_counter counter = {0};
+            for (UInt32 c = 0; c < chunk_count; ++c) {
+                chunks[c].values = values + c * chunk_size;
+                chunks[c].count = chunk_size;
+                job_info job = {0};
+                job.entry_point = benchmark_job;
+                job.params = &chunks[c];
+                job.counter = &counter;
+                job_submit(&job);
+            }
+            job_counter_wait(&counter);
+        }
+        clock_update(&timer);
+
+        Double total = 0;
+        for (UInt32 c = 0; c < chunk_count; ++c) {
+            total += chunks[c].result;
+        }
+
+        if (workers == 1) {
+            single_worker_seconds = timer.elapsed;
+            reference = total;
+        }
+        expect_to_be_true((reference == total));
+
+        KINFO("Job system: %u worker(s) took %.3f ms (%.2fx).",
+              workers, timer.elapsed * 1000.0, single_worker_seconds / timer.elapsed);
+
+        test_system_stop(&jobs, job_system_shutdown);
+    }
+
+    kfree(chunks, sizeof(benchmark_chunk) * chunk_count, MEMORY_TAG_ARRAY);
+    kfree(values, sizeof(Single) * value_count, MEMORY_TAG_ARRAY);
+    return TRUE;
+}
+
+UInt8 job_system_shutdown_finishes_queued_jobs() {
+    test_system jobs;
+    test_system_start(&jobs, job_system_initialize, 2);
+
+    _Atomic UInt32 total = 0;
+    job_counter counter = {0};
+    job_counter dependents = {0};
+    for (UInt32 i = 0; i < 500; ++i) {
+        job_info job = {0};
+        job.entry_point = job_increment;
+        job.params = &total;
+        job.main_thread_only = (i % 10) == 0;
+        job.counter = &counter;
+        job_submit(&job);
+
+        // Held until the whole batch has run.
+        job_info dependent = job;
+        dependent.main_thread_only = FALSE;
+        dependent.counter = &dependents;
+        dependent.dependency = &counter;
+        job_submit(&dependent);
+    }
+
+    // Nobody waits or updates, so only shutdown can get these done.
+    test_system_stop(&jobs, job_system_shutdown);
+    expect_should_be(0, atomic_load(&counter.value));
+    expect_should_be(0, atomic_load(&dependents.value));
+    expect_should_be(1000, atomic_load(&total));
+    return TRUE;
+}
+
+void job_system_register_tests() {
+    test_manager_register_test(job_system_runs_all_submitted_jobs, "Job system runs every submitted job");
+    test_manager_register_test(job_system_runs_inline_when_not_started, "Job system runs jobs inline when not started");
+    test_manager_register_test(job_system_waits_for_dependencies, "Job system holds jobs until their dependency completes");
+    test_manager_register_test(job_system_main_thread_jobs_run_on_main_thread, "Job system runs main-thread jobs on the main thread");
+    test_manager_register_test(job_system_shutdown_finishes_queued_jobs, "Job system finishes queued jobs when it shuts down");
+    test_manager_register_test(job_system_benchmark_worker_scaling, "Job system throughput from 1 to N workers");
+}
\ No newline at end of file
@@ -0,0 +1,245 @@
+#include "logger_tests.h"
+#include "../test_manager.h"
+#include "../expect.h"
+#include "../test_systems.h"
+
+#include <defines.h>
+
+#include <core/clock.h>
+#include <core/kmemory.h>
+#include <core/logger.h>
+#include <core/kstring.h>
+#include <platform/filesystem.h>
+
+UInt8 logger_writes_everything_it_queues() {
+    test_system logging;
+    expect_to_be_true(test_system_start(&logging, initialize_logging));
+    log_set_console_enabled(FALSE);
+
+    for (UInt32 i = 0; i < 200; ++i) {
+        KTRACE("Queued message %u.", i);
+    }
+
+    // Longer than a queue slot, so this one takes the synchronous path.
+    char long_text[2048];
+    kset_memory(long_text, 'x', sizeof(long_text) - 1);
+    long_text[sizeof(long_text) - 1] = 0;
+    KTRACE("%s", long_text);
+
+    log_flush();
+    log_stats stats;
+    log_get_stats(&stats);
+    expect_should_be(200, (stats.queued_count + stats.dropped_count));
+    expect_should_be(stats.queued_count, stats.written_count);
+
+    test_system_stop(&logging, shutdown_logging);
+    return TRUE;
+}
+
+UInt8 logger_never_drops_errors() {
+    test_system logging;
+    expect_to_be_true(test_system_start(&logging, initialize_logging));
+    log_set_console_enabled(FALSE);
+
+    // Several times the queue capacity, so some of these find the queue full.
+    for (UInt32 i = 0; i < 8192; ++i) {
+        KERROR("Error %u.", i);
+    }
+
+    log_flush();
+    log_stats stats;
+    log_get_stats(&stats);
+    expect_should_be(0, stats.dropped_count);
+    expect_should_be(stats.queued_count, stats.written_count);
+
+    test_system_stop(&logging, shutdown_logging);
+    return TRUE;
+}
+
+// Logs in batches that fit the queue, flushing between them, so nothing is dropped and only
+// the logging calls themselves are timed. Returns the time spent logging.
+static Double log_in_batches(UInt32 message_count, Boolean formatted, Double* out_total_seconds) {
+    Double logging_seconds = 0;
+    *out_total_seconds = 0;
+    clock timer;
+    for (UInt32 first = 0; first < message_count; first += LOG_QUEUE_CAPACITY) {
+        UInt32 end = first + LOG_QUEUE_CAPACITY < message_count ? first + LOG_QUEUE_CAPACITY : message_count;
+        clock_start(&timer);
+        for (UInt32 i = first; i < end; ++i) {
+            if (formatted) {
+                log_output(LOG_LEVEL_TRACE, "Entity %u moved to (%.2f, %.2f, %.2f).", i, i * 0.5f, i * 0.25f, i * 0.125f);
+            } else {
+                KTRACE("Entity %u moved to (%.2f, %.2f, %.2f).", i, i * 0.5f, i * 0.25f, i * 0.125f);
+            }
+        }
+        clock_update(&timer);
+        logging_seconds += timer.elapsed;
+
+        log_flush();
+        clock_update(&timer);
+        *out_total_seconds += timer.elapsed;
+    }
+    return logging_seconds;
+}
+
+UInt8 logger_benchmark_hot_path() {
+    test_system logging;
+    expect_to_be_true(test_system_start(&logging, initialize_logging));
+    log_set_console_enabled(FALSE);
+
+    const UInt32 message_count = 100000;
+    Double total_seconds;
+    Double hot_path_seconds = log_in_batches(message_count, FALSE, &total_seconds);
+
+    log_stats stats;
+    log_get_stats(&stats);
+    expect_should_be(0, stats.dropped_count);
+    expect_should_be(message_count, stats.queued_count);
+    expect_should_be(stats.queued_count, stats.written_count);
+
+    test_system_stop(&logging, shutdown_logging);
+
+    KINFO("Logger: hot path %.2f M messages/sec, %.2f M messages/sec written to console.log.",
+          message_count / hot_path_seconds / 1000000.0,
+          message_count / total_seconds / 1000000.0);
+
+    return TRUE;
+}
+
+UInt8 logger_binary_log_round_trip() {
+    test_system logging;
+    expect_to_be_true(test_system_start(&logging, initialize_logging));
+    log_set_console_enabled(FALSE);
+    expect_to_be_true(log_set_binary_output("logger_test.klog"));
+
+    for (UInt32 i = 0; i < 3; ++i) {
+        KTRACE("Entity %u: health %d, speed %.2f, name '%s', big %llu.", i, -5 * (Int32)i, i * 1.5, "orc", 1ull << 40);
+    }
+    KERROR("Preformatted %s.", "error");
+    KDEBUG("Pointer %p and %% sign.", (void*)&logging);
+    KINFO("No arguments.");
+
+    log_flush();
+    log_set_binary_output(0);
+    test_system_stop(&logging, shutdown_logging);
+
+    expect_to_be_true(log_decode_binary_file("logger_test.klog", "logger_test.txt"));
+
+    // %p is printed differently by each C runtime, so the expected text is formatted the same way.
+    char expected[1024];
+    string_format(expected,
+                  "[TRACE]: Entity 0: health 0, speed 0.00, name 'orc', big 1099511627776.\n"
+                  "[TRACE]: Entity 1: health -5, speed 1.50, name 'orc', big 1099511627776.\n"
+                  "[TRACE]: Entity 2: health -10, speed 3.00, name 'orc', big 1099511627776.\n"
+                  "[ERROR]: Preformatted error.\n"
+                  "[DEBUG]: Pointer %p and %% sign.\n"
+                  "[INFO]: No arguments.\n",
+                  (void*)&logging);
+
+    file_handle text_file;
+    expect_to_be_true(filesystem_open("logger_test.txt", FILE_MODE_READ, TRUE, &text_file));
+    UInt8* text = 0;
+    UInt64 text_length = 0;
+    expect_to_be_true(filesystem_read_all_bytes(&text_file, &text, &text_length));
+    filesystem_close(&text_file);
+
+    char decoded[1024] = {0};
+    expect_to_be_true((text_length < sizeof(decoded)));
+    kcopy_memory(decoded, text, text_length);
+    expect_to_be_true(strings_equal(expected, decoded));
+    kfree(text, text_length, MEMORY_TAG_STRING);
+    return TRUE;
+}
+
+UInt8 logger_benchmark_deferred_formatting() {
+    test_system logging;
+    expect_to_be_true(test_system_start(&logging, initialize_logging));
+    log_set_console_enabled(FALSE);
+
+    const UInt32 message_count = 100000;
+    Double total_seconds;
+    Double formatted_seconds = log_in_batches(message_count, TRUE, &total_seconds);
+
+    expect_to_be_true(log_set_binary_output("logger_benchmark.klog"));
+    Double deferred_seconds = log_in_batches(message_count, FALSE, &total_seconds);
+    log_set_binary_output(0);
+
+    log_stats stats;
+    log_get_stats(&stats);
+    expect_should_be(0, stats.dropped_count);
+    expect_should_be(stats.queued_count, stats.written_count);
+
+    test_system_stop(&logging, shutdown_logging);
+
+    KINFO("Logger: hot path %.2f M messages/sec formatted, %.2f M messages/sec deferred to a binary log.",
+          message_count / formatted_seconds / 1000000.0,
+          message_count / deferred_seconds / 1000000.0);
+
+    return TRUE;
+}
+
+static UInt32 evaluated_count;
+
+static UInt32 count_evaluation() {
+    return ++evaluated_count;
+}
+
+UInt8 logger_category_levels_skip_arguments() {
+    test_system logging;
+    expect_to_be_true(test_system_start(&logging, initialize_logging));
+    log_set_console_enabled(FALSE);
+
+    log_set_level(LOG_CATEGORY_VULKAN, LOG_LEVEL_WARN);
+    expect_should_be(LOG_LEVEL_WARN, log_get_level(LOG_CATEGORY_VULKAN));
+    expect_should_be(LOG_LEVEL_TRACE, log_get_level(LOG_CATEGORY_RENDERER));
+
+    evaluated_count = 0;
+    KTRACE_C(LOG_CATEGORY_VULKAN, "Skipped %u.", count_evaluation());
+    KINFO_C(LOG_CATEGORY_VULKAN, "Skipped %u.", count_evaluation());
+    expect_should_be(0, evaluated_count);
+    KWARN_C(LOG_CATEGORY_VULKAN, "Written %u.", count_evaluation());
+    KTRACE_C(LOG_CATEGORY_RENDERER, "Written %u.", count_evaluation());
+    expect_should_be(2, evaluated_count);
+
+    // Errors can't be turned off.
+    log_set_level(LOG_CATEGORY_GAME, LOG_LEVEL_FATAL);
+    expect_should_be(LOG_LEVEL_ERROR, log_get_level(LOG_CATEGORY_GAME));
+
+    expect_to_be_true(log_set_levels("all=info,vulkan=trace"));
+    expect_should_be(LOG_LEVEL_INFO, log_get_level(LOG_CATEGORY_GAME));
+    expect_should_be(LOG_LEVEL_TRACE, log_get_level(LOG_CATEGORY_VULKAN));
+    expect_to_be_false(log_set_levels("renderer=debug,nonsense=trace,input=loud,memory"));
+    expect_should_be(LOG_LEVEL_DEBUG, log_get_level(LOG_CATEGORY_RENDERER));
+    expect_should_be(LOG_LEVEL_INFO, log_get_level(LOG_CATEGORY_INPUT));
+
+    // Disabled calls should cost no more than a load and a compare.
+    log_set_level(LOG_CATEGORY_RENDERER, LOG_LEVEL_INFO);
+    const UInt32 call_count = 10000000;
+    clock timer;
+    clock_start(&timer);
+    for (UInt32 i = 0; i < call_count; ++i) {
+        KTRACE_C(LOG_CATEGORY_RENDERER, "Draw call %u with %f.", i, i * 0.5);
+    }
+    clock_update(&timer);
+    Double disabled_seconds = timer.elapsed;
+
+    log_flush();
+    log_stats stats;
+    log_get_stats(&stats);
+    expect_should_be(2, (stats.queued_count + stats.dropped_count));
+
+    expect_to_be_true(log_set_levels("all=trace"));
+    test_system_stop(&logging, shutdown_logging);
+
+    KINFO("Logger: disabled call costs %.2f ns.", disabled_seconds / call_count * 1000000000.0);
+    return TRUE;
+}
+
+void logger_register_tests() {
+    test_manager_register_test(logger_writes_everything_it_queues, "Logger writes every message it queues");
+    test_manager_register_test(logger_never_drops_errors, "Logger never drops errors when the queue is full");
+    test_manager_register_test(logger_benchmark_hot_path, "Logger hot path throughput");
+    test_manager_register_test(logger_binary_log_round_trip, "Logger binary log decodes to the same text");
+    test_manager_register_test(logger_benchmark_deferred_formatting, "Logger deferred formatting throughput");
+    test_manager_register_test(logger_category_levels_skip_arguments, "Logger category levels skip disabled calls");
+}
\ No newline at end of file
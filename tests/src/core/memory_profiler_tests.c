@@ -0,0 +1,99 @@
+#include "memory_profiler_tests.h"
+#include "../test_manager.h"
+#include "../expect.h"
+#include "../test_systems.h"
+
+#include <defines.h>
+
+#include <core/kmemory.h>
+#include <core/memory_profiler.h>
+
+#include <string.h>
+
+static void* allocate_in_a_loop(UInt32 size) {
+    return kallocate(size, MEMORY_TAG_ARRAY);
+}
+
+static void* allocate_once(UInt32 size) {
+    return kallocate(size, MEMORY_TAG_STRING);
+}
+
+UInt8 memory_profiler_ranks_callsites_per_frame() {
+    test_system memory;
+    test_system_start(&memory, memory_system_initialize, MEBIBYTES(4));
+    expect_to_be_true(memory_profiler_enable(TRUE));
+
+    void* blocks[10];
+    for (UInt32 i = 0; i < 10; ++i) {
+        blocks[i] = allocate_in_a_loop(100);
+    }
+    void* once = allocate_once(500);
+    memory_profiler_frame_end();
+
+    memory_callsite_stats top[4];
+    expect_should_be(2, memory_profiler_get_top_callsites(TRUE, top, 4));
+    expect_to_be_true((strcmp(top[0].file, __FILE__) == 0));
+    expect_should_be(MEMORY_TAG_ARRAY, top[0].tag);
+    expect_should_be(10, top[0].frame_allocations);
+    expect_should_be(1000, top[0].frame_bytes);
+    expect_should_be(MEMORY_TAG_STRING, top[1].tag);
+    expect_should_be(500, top[1].frame_bytes);
+    expect_to_be_true((top[0].line != top[1].line));
+
+    // A frame without allocations reports none.
+    for (UInt32 i = 0; i < 10; ++i) {
+        kfree(blocks[i], 100, MEMORY_TAG_ARRAY);
+    }
+    memory_profiler_frame_end();
+    expect_should_be(0, memory_profiler_get_top_callsites(TRUE, top, 4));
+
+    char report[1024];
+    memory_profiler_frame_report(report, sizeof(report), 4);
+    expect_to_be_true((strstr(report, "Allocations in the last frame: 0 (0 bytes).") != 0));
+
+    // Only the block that was never freed is left for the leak report.
+    expect_should_be(1, memory_profiler_get_top_callsites(FALSE, top, 4));
+    expect_should_be(1, top[0].live_allocations);
+    expect_should_be(500, top[0].live_bytes);
+    expect_should_be(1, top[0].total_allocations);
+    memory_profiler_leak_report(report, sizeof(report), 4);
+    expect_to_be_true((strstr(report, "Blocks still allocated: 1 (500 bytes), 0 not tracked.") != 0));
+    expect_to_be_true((strstr(report, __FILE__) != 0));
+
+    kfree(once, 500, MEMORY_TAG_STRING);
+    expect_should_be(0, memory_profiler_get_top_callsites(FALSE, top, 4));
+
+    test_system_stop(&memory, memory_system_shutdown);
+    expect_to_be_false(memory_profiler_is_enabled());
+    return TRUE;
+}
+
+UInt8 memory_profiler_tracks_many_live_blocks() {
+    test_system memory;
+    test_system_start(&memory, memory_system_initialize, MEBIBYTES(4));
+    expect_to_be_true(memory_profiler_enable(TRUE));
+
+    // Enough blocks that lookups run through long probe chains, freed in a different order.
+    const UInt32 count = 20000;
+    void** blocks = kallocate(sizeof(void*) * count, MEMORY_TAG_ARRAY);
+    for (UInt32 i = 0; i < count; ++i) {
+        blocks[i] = kallocate(16, MEMORY_TAG_ENTITY);
+    }
+    for (UInt32 i = 0; i < count; ++i) {
+        UInt32 index = (i * 7919) % count;
+        kfree(blocks[index], 16, MEMORY_TAG_ENTITY);
+    }
+
+    memory_callsite_stats top[2];
+    expect_should_be(1, memory_profiler_get_top_callsites(FALSE, top, 2));
+    expect_should_be(MEMORY_TAG_ARRAY, top[0].tag);
+    kfree(blocks, sizeof(void*) * count, MEMORY_TAG_ARRAY);
+
+    test_system_stop(&memory, memory_system_shutdown);
+    return TRUE;
+}
+
+void memory_profiler_register_tests() {
+    test_manager_register_test(memory_profiler_ranks_callsites_per_frame, "Memory profiler ranks callsites per frame and reports leaks");
+    test_manager_register_test(memory_profiler_tracks_many_live_blocks, "Memory profiler tracks many live blocks");
+}
\ No newline at end of file
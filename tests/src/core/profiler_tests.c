@@ -0,0 +1,196 @@
+#include "profiler_tests.h"
+#include "../test_manager.h"
+#include "../expect.h"
+#include "../test_systems.h"
+
+#include <defines.h>
+
+#include <core/clock.h>
+#include <core/kmemory.h>
+#include <core/kstring.h>
+#include <core/logger.h>
+#include <core/profiler.h>
+#include <platform/platform.h>
+#include <platform/filesystem.h>
+
+static const profiler_zone* find_zone(const profiler_zone* zones, UInt32 count, const char* name) {
+    for (UInt32 i = 0; i < count; ++i) {
+        if (strings_equal(zones[i].name, name)) {
+            return &zones[i];
+        }
+    }
+    return 0;
+}
+
+static UInt32 count_occurrences(const char* text, const char* pattern) {
+    UInt32 count = 0;
+    UInt64 pattern_length = string_length(pattern);
+    for (const char* c = text; *c; ++c) {
+        UInt64 i = 0;
+        while (i < pattern_length && c[i] == pattern[i]) {
+            i++;
+        }
+        count += i == pattern_length;
+    }
+    return count;
+}
+
+static UInt32 profiled_thread_run(void* params) {
+    profiler_set_thread_name("Profiled thread");
+    KPROFILE_SCOPE("thread work");
+    platform_sleep(1);
+    return 0;
+}
+
+static UInt32 short_lived_thread_run(void* params) {
+    KPROFILE_BEGIN("short lived");
+    KPROFILE_END();
+    profiler_thread_release();
+    return 0;
+}
+
+UInt8 profiler_recycles_thread_slots() {
+    test_system profiler;
+    expect_to_be_true(test_system_start(&profiler, profiler_system_initialize));
+
+    // More threads than there are slots, one after another, are all profiled.
+    const UInt32 thread_count = PROFILER_MAX_THREADS * 2;
+    for (UInt32 i = 0; i < thread_count; ++i) {
+        kthread thread;
+        expect_to_be_true(platform_thread_create(short_lived_thread_run, 0, &thread));
+        platform_thread_destroy(&thread);
+    }
+
+    profiler_frame_end();
+    UInt32 count = 0;
+    profiler_get_frame_zones(&count);
+    expect_should_be(thread_count, count);
+
+    test_system_stop(&profiler, profiler_system_shutdown);
+    return TRUE;
+}
+
+UInt8 profiler_builds_zone_tree() {
+    test_system profiler;
+    expect_to_be_true(test_system_start(&profiler, profiler_system_initialize));
+
+    {
+        KPROFILE_SCOPE("outer");
+        {
+            KPROFILE_SCOPE("first child");
+            KPROFILE_SCOPE("grandchild");
+            platform_sleep(1);
+        }
+        KPROFILE_BEGIN("second child");
+        KPROFILE_END();
+    }
+
+    kthread thread;
+    expect_to_be_true(platform_thread_create(profiled_thread_run, 0, &thread));
+    platform_thread_destroy(&thread);
+
+    profiler_frame_end();
+    UInt32 count = 0;
+    const profiler_zone* zones = profiler_get_frame_zones(&count);
+    expect_should_be(5, count);
+
+    const profiler_zone* outer = find_zone(zones, count, "outer");
+    const profiler_zone* first = find_zone(zones, count, "first child");
+    const profiler_zone* grandchild = find_zone(zones, count, "grandchild");
+    const profiler_zone* second = find_zone(zones, count, "second child");
+    const profiler_zone* other = find_zone(zones, count, "thread work");
+    expect_should_not_be(0, outer);
+    expect_should_not_be(0, first);
+    expect_should_not_be(0, grandchild);
+    expect_should_not_be(0, second);
+    expect_should_not_be(0, other);
+
+    expect_should_be(-1, outer->parent);
+    expect_should_be(outer, &zones[first->parent]);
+    expect_should_be(first, &zones[grandchild->parent]);
+    expect_should_be(outer, &zones[second->parent]);
+    expect_should_be(2, grandchild->depth);
+    expect_to_be_true((first->start < second->start));
+    expect_to_be_true((outer->duration >= first->duration && first->duration >= grandchild->duration));
+    expect_to_be_true((grandchild->duration > 0.0005 && grandchild->duration < 1.0));
+
+    expect_should_not_be(outer->thread_index, other->thread_index);
+    expect_should_be(-1, other->parent);
+
+    // Nothing was recorded since, so the next frame is empty.
+    profiler_frame_end();
+    profiler_get_frame_zones(&count);
+    expect_should_be(0, count);
+
+    test_system_stop(&profiler, profiler_system_shutdown);
+    return TRUE;
+}
+
+UInt8 profiler_writes_chrome_trace() {
+    test_system profiler;
+    expect_to_be_true(test_system_start(&profiler, profiler_system_initialize));
+
+    profiler_set_thread_name("Main \"thread\" \\ 1");
+    expect_to_be_true(profiler_begin_capture("profiler_test.json"));
+    for (UInt32 frame = 0; frame < 3; ++frame) {
+        KPROFILE_BEGIN("frame");
+        KPROFILE_BEGIN("quoted \"zone\"");
+        KPROFILE_END();
+        KPROFILE_END();
+        profiler_frame_end();
+    }
+    profiler_end_capture();
+
+    file_handle file;
+    expect_to_be_true(filesystem_open("profiler_test.json", FILE_MODE_READ, FALSE, &file));
+    UInt8* text = 0;
+    UInt64 length = 0;
+    expect_to_be_true(filesystem_read_all_bytes(&file, &text, &length));
+    filesystem_close(&file);
+
+    char trace[4096] = {0};
+    expect_to_be_true((length < sizeof(trace)));
+    kcopy_memory(trace, text, length);
+    kfree(text, length, MEMORY_TAG_STRING);
+
+    expect_should_be('{', trace[0]);
+    expect_should_be(3, count_occurrences(trace, "{\"name\":\"frame\",\"ph\":\"X\""));
+    expect_should_be(3, count_occurrences(trace, "{\"name\":\"quoted \\\"zone\\\"\",\"ph\":\"X\""));
+    expect_should_be(1, count_occurrences(trace, "\"args\":{\"name\":\"Main \\\"thread\\\" \\\\ 1\"}"));
+    expect_to_be_true((length >= 4 && trace[length - 3] == ']' && trace[length - 2] == '}'));
+
+    test_system_stop(&profiler, profiler_system_shutdown);
+    return TRUE;
+}
+
+UInt8 profiler_benchmark_zone_cost() {
+    test_system profiler;
+    expect_to_be_true(test_system_start(&profiler, profiler_system_initialize));
+
+    const UInt32 batch_size = 1000;
+    const UInt32 batch_count = 1000;
+    Double recording_seconds = 0;
+    clock timer;
+    for (UInt32 batch = 0; batch < batch_count; ++batch) {
+        clock_start(&timer);
+        for (UInt32 i = 0; i < batch_size; ++i) {
+            KPROFILE_SCOPE("benchmark zone");
+        }
+        clock_update(&timer);
+        recording_seconds += timer.elapsed;
+        profiler_frame_end();
+    }
+    expect_should_be(0, profiler_get_dropped_count());
+
+    test_system_stop(&profiler, profiler_system_shutdown);
+
+    KINFO("Profiler: %.1f ns per zone.", recording_seconds / (batch_size * batch_count) * 1000000000.0);
+    return TRUE;
+}
+
+void profiler_register_tests() {
+    test_manager_register_test(profiler_builds_zone_tree, "Profiler builds a per-frame zone tree");
+    test_manager_register_test(profiler_recycles_thread_slots, "Profiler recycles the slots of finished threads");
+    test_manager_register_test(profiler_writes_chrome_trace, "Profiler writes a Chrome trace");
+    test_manager_register_test(profiler_benchmark_zone_cost, "Profiler cost per zone");
+}
\ No newline at end of file
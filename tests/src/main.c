@@ -1,6 +1,23 @@
 #include "test_manager.h"
 
 #include "memory/linear_allocator_tests.h"
+#include "memory/freelist_tests.h"
+#include "memory/dynamic_linear_allocator_tests.h"
+#include "memory/pool_allocator_tests.h"
+#include "memory/stack_allocator_tests.h"
+#include "memory/kmemory_tests.h"
+#include "core/memory_profiler_tests.h"
+#include "containers/darray_tests.h"
+#include "containers/hashtable_tests.h"
+#include "containers/ring_queue_tests.h"
+#include "core/job_system_tests.h"
+#include "core/event_tests.h"
+#include "core/logger_tests.h"
+#include "core/profiler_tests.h"
+#include "core/frame_stats_tests.h"
+#include "core/frame_pacer_tests.h"
+#include "core/fixed_timestep_tests.h"
+#include "core/benchmark_tests.h"
 
 #include <core/logger.h>
 
@@ -8,6 +25,23 @@ int main() {
     test_manager_init();
 
     linear_allocator_register_tests();
+    freelist_register_tests();
+    dynamic_linear_allocator_register_tests();
+    pool_allocator_register_tests();
+    stack_allocator_register_tests();
+    kmemory_register_tests();
+    memory_profiler_register_tests();
+    darray_register_tests();
+    hashtable_register_tests();
+    ring_queue_register_tests();
+    job_system_register_tests();
+    event_register_tests();
+    logger_register_tests();
+    profiler_register_tests();
+    frame_stats_register_tests();
+    frame_pacer_register_tests();
+    fixed_timestep_register_tests();
+    benchmark_register_tests();
 
     KDEBUG("Starting tests...");
 
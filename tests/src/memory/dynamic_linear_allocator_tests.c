@@ -0,0 +1,84 @@
+#include "dynamic_linear_allocator_tests.h"
+#include "../test_manager.h"
+#include "../expect.h"
+
+#include <defines.h>
+
+#include <memory/dynamic_linear_allocator.h>
+
+UInt8 dynamic_linear_allocator_should_create_and_destroy() {
+    dynamic_linear_allocator alloc;
+    expect_to_be_true(dynamic_linear_allocator_create(sizeof(UInt64), &alloc));
+
+    expect_should_not_be(0, alloc.first_page);
+    expect_should_be(1, alloc.page_count);
+    expect_should_be(sizeof(UInt64), alloc.total_size);
+    expect_should_be(0, alloc.allocated);
+
+    dynamic_linear_allocator_destroy(&alloc);
+
+    expect_should_be(0, alloc.first_page);
+    expect_should_be(0, alloc.page_count);
+    expect_should_be(0, alloc.total_size);
+
+    return TRUE;
+}
+
+UInt8 dynamic_linear_allocator_over_allocate_adds_pages() {
+    UInt64 max_allocs = 4;
+    dynamic_linear_allocator alloc;
+    expect_to_be_true(dynamic_linear_allocator_create(sizeof(UInt64) * max_allocs, &alloc));
+
+    for (UInt64 i = 0; i < max_allocs * 3; ++i) {
+        UInt64* block = dynamic_linear_allocator_allocate(&alloc, sizeof(UInt64));
+        expect_should_not_be(0, block);
+        *block = i;
+    }
+
+    expect_should_be(3, alloc.page_count);
+    expect_should_be(sizeof(UInt64) * max_allocs * 3, alloc.allocated);
+
+    // Larger than a page: gets a page of its own.
+    void* big = dynamic_linear_allocator_allocate(&alloc, sizeof(UInt64) * max_allocs * 2);
+    expect_should_not_be(0, big);
+    expect_should_be(4, alloc.page_count);
+
+    dynamic_linear_allocator_destroy(&alloc);
+
+    return TRUE;
+}
+
+UInt8 dynamic_linear_allocator_reset_reuses_pages() {
+    dynamic_linear_allocator alloc;
+    expect_to_be_true(dynamic_linear_allocator_create(64, &alloc));
+
+    void* first = dynamic_linear_allocator_allocate(&alloc, 48);
+    dynamic_linear_allocator_allocate(&alloc, 48);
+    dynamic_linear_allocator_allocate(&alloc, 48);
+    expect_should_be(3, alloc.page_count);
+    expect_should_be(144, alloc.high_water_mark);
+
+    dynamic_linear_allocator_reset(&alloc);
+    expect_should_be(0, alloc.allocated);
+    expect_should_be(144, alloc.high_water_mark);
+
+    void* again = dynamic_linear_allocator_allocate(&alloc, 48);
+    expect_should_be(first, again);
+    dynamic_linear_allocator_allocate(&alloc, 48);
+    dynamic_linear_allocator_allocate(&alloc, 48);
+    expect_should_be(3, alloc.page_count);
+
+    dynamic_linear_allocator_reset(&alloc);
+    dynamic_linear_allocator_allocate(&alloc, 16);
+    expect_should_be(144, alloc.high_water_mark);
+
+    dynamic_linear_allocator_destroy(&alloc);
+
+    return TRUE;
+}
+
+void dynamic_linear_allocator_register_tests() {
+    test_manager_register_test(dynamic_linear_allocator_should_create_and_destroy, "Dynamic linear allocator should create and destroy");
+    test_manager_register_test(dynamic_linear_allocator_over_allocate_adds_pages, "Dynamic linear allocator adds pages when full");
+    test_manager_register_test(dynamic_linear_allocator_reset_reuses_pages, "Dynamic linear allocator reuses pages after reset");
+}
\ No newline at end of file
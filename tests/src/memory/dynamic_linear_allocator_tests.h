@@ -0,0 +1,3 @@
+#pragma once
+
+void dynamic_linear_allocator_register_tests();
\ No newline at end of file
@@ -0,0 +1,144 @@
+#include "freelist_tests.h"
+#include "../test_manager.h"
+#include "../expect.h"
+
+#include <defines.h>
+
+#include <memory/freelist.h>
+
+UInt8 freelist_should_create_and_destroy() {
+    freelist alloc;
+    freelist_create(512, 0, &alloc);
+
+    expect_should_not_be(0, alloc.memory);
+    expect_should_be(512, alloc.total_size);
+    expect_should_be(0, alloc.allocated);
+    expect_should_be(512, freelist_free_space(&alloc));
+
+    freelist_destroy(&alloc);
+
+    expect_should_be(0, alloc.memory);
+    expect_should_be(0, alloc.total_size);
+    expect_should_be(0, alloc.allocated);
+
+    return TRUE;
+}
+
+UInt8 freelist_single_allocation_all_space() {
+    freelist alloc;
+    freelist_create(512, 0, &alloc);
+
+    void* block = freelist_allocate(&alloc, 512);
+    expect_should_not_be(0, block);
+    expect_should_be(0, freelist_free_space(&alloc));
+
+    void* extra = freelist_allocate(&alloc, 16);
+    expect_should_be(0, extra);
+
+    expect_to_be_true(freelist_free(&alloc, block, 512));
+    expect_should_be(512, freelist_free_space(&alloc));
+
+    freelist_destroy(&alloc);
+
+    return TRUE;
+}
+
+UInt8 freelist_allocations_are_aligned() {
+    freelist alloc;
+    freelist_create(1024, 0, &alloc);
+
+    void* a = freelist_allocate(&alloc, 3);
+    void* b = freelist_allocate(&alloc, 17);
+    void* c = freelist_allocate(&alloc, 1);
+
+    expect_should_be(0, ((UInt64)a % FREELIST_ALIGNMENT));
+    expect_should_be(0, ((UInt64)b % FREELIST_ALIGNMENT));
+    expect_should_be(0, ((UInt64)c % FREELIST_ALIGNMENT));
+    expect_should_be(16 + 32 + 16, alloc.allocated);
+
+    freelist_destroy(&alloc);
+
+    return TRUE;
+}
+
+UInt8 freelist_coalesces_freed_neighbours() {
+    freelist alloc;
+    freelist_create(64, 0, &alloc);
+
+    void* a = freelist_allocate(&alloc, 16);
+    void* b = freelist_allocate(&alloc, 16);
+    void* c = freelist_allocate(&alloc, 16);
+    void* d = freelist_allocate(&alloc, 16);
+    expect_should_be(0, freelist_free_space(&alloc));
+
+    // Free out of order; the middle free has to merge with both sides.
+    expect_to_be_true(freelist_free(&alloc, a, 16));
+    expect_to_be_true(freelist_free(&alloc, c, 16));
+    expect_to_be_true(freelist_free(&alloc, b, 16));
+
+    // a, b and c are now one range, so a 48-byte request must fit at a.
+    void* big = freelist_allocate(&alloc, 48);
+    expect_should_be(a, big);
+
+    expect_to_be_true(freelist_free(&alloc, d, 16));
+    expect_to_be_true(freelist_free(&alloc, big, 48));
+    expect_should_be(64, freelist_free_space(&alloc));
+
+    big = freelist_allocate(&alloc, 64);
+    expect_should_be(a, big);
+
+    freelist_destroy(&alloc);
+
+    return TRUE;
+}
+
+UInt8 freelist_picks_best_fit() {
+    freelist alloc;
+    freelist_create(256, 0, &alloc);
+
+    void* a = freelist_allocate(&alloc, 64);
+    void* gap0 = freelist_allocate(&alloc, 16);
+    void* b = freelist_allocate(&alloc, 32);
+    void* gap1 = freelist_allocate(&alloc, 16);
+
+    // Leaves free ranges of 64, 32 and the 128-byte tail.
+    freelist_free(&alloc, a, 64);
+    freelist_free(&alloc, b, 32);
+
+    void* fit = freelist_allocate(&alloc, 32);
+    expect_should_be(b, fit);
+
+    freelist_free(&alloc, fit, 32);
+    freelist_free(&alloc, gap0, 16);
+    freelist_free(&alloc, gap1, 16);
+    expect_should_be(256, freelist_free_space(&alloc));
+
+    freelist_destroy(&alloc);
+
+    return TRUE;
+}
+
+UInt8 freelist_rejects_double_free() {
+    freelist alloc;
+    freelist_create(128, 0, &alloc);
+
+    void* a = freelist_allocate(&alloc, 32);
+    expect_to_be_true(freelist_free(&alloc, a, 32));
+
+    KDEBUG("Note: The following error is intentionally caused by this test.");
+    expect_to_be_false(freelist_free(&alloc, a, 32));
+    expect_should_be(128, freelist_free_space(&alloc));
+
+    freelist_destroy(&alloc);
+
+    return TRUE;
+}
+
+void freelist_register_tests() {
+    test_manager_register_test(freelist_should_create_and_destroy, "Freelist should create and destroy");
+    test_manager_register_test(freelist_single_allocation_all_space, "Freelist single alloc for all space");
+    test_manager_register_test(freelist_allocations_are_aligned, "Freelist allocations are aligned");
+    test_manager_register_test(freelist_coalesces_freed_neighbours, "Freelist coalesces freed neighbours");
+    test_manager_register_test(freelist_picks_best_fit, "Freelist picks the best fitting range");
+    test_manager_register_test(freelist_rejects_double_free, "Freelist rejects a double free");
+}
\ No newline at end of file
@@ -0,0 +1,461 @@
+#include "kmemory_tests.h"
+#include "../test_manager.h"
+#include "../expect.h"
+#include "../test_systems.h"
+
+#include <defines.h>
+
+#include <core/clock.h>
+#include <core/event.h>
+#include <core/kmemory.h>
+#include <platform/platform.h>
+
+#include <stdatomic.h>
+
+static test_system memory_system;
+
+static void start_memory_system(UInt64 heap_size) {
+    test_system_start(&memory_system, memory_system_initialize, heap_size);
+}
+
+static void stop_memory_system() {
+    test_system_stop(&memory_system, memory_system_shutdown);
+}
+
+UInt8 kallocate_aligned_without_memory_system() {
+    UInt16 alignments[] = { 1, 16, 64, 256 };
+    for (UInt32 i = 0; i < 4; ++i) {
+        UInt8* block = kallocate_aligned(100, alignments[i], MEMORY_TAG_ARRAY);
+        expect_should_not_be(0, block);
+        expect_should_be(0, ((UInt64)block % alignments[i]));
+        expect_should_be(0, block[99]);
+        kfree_aligned(block, 100, alignments[i], MEMORY_TAG_ARRAY);
+    }
+
+    return TRUE;
+}
+
+UInt8 kallocate_aligned_from_memory_system() {
+    start_memory_system(KIBIBYTES(64));
+
+    UInt64 start_count = get_memory_alloc_count();
+    UInt16 alignments[] = { 1, 16, 64, 256 };
+    void* blocks[4];
+    for (UInt32 i = 0; i < 4; ++i) {
+        blocks[i] = kallocate_aligned(100, alignments[i], MEMORY_TAG_ARRAY);
+        expect_should_not_be(0, blocks[i]);
+        expect_should_be(0, ((UInt64)blocks[i] % alignments[i]));
+    }
+    expect_should_be(start_count + 4, get_memory_alloc_count());
+
+    for (UInt32 i = 0; i < 4; ++i) {
+        kfree_aligned(blocks[i], 100, alignments[i], MEMORY_TAG_ARRAY);
+    }
+
+    // Everything went back to the heap, so one block the size of the whole heap must fit.
+    void* everything = kallocate(KIBIBYTES(64), MEMORY_TAG_ARRAY);
+    kfree(everything, KIBIBYTES(64), MEMORY_TAG_ARRAY);
+    expect_should_be(start_count + 5, get_memory_alloc_count());
+
+    stop_memory_system();
+
+    return TRUE;
+}
+
+UInt8 memory_stats_track_current_peak_and_counts() {
+    start_memory_system(KIBIBYTES(64));
+
+    memory_stats_snapshot before;
+    expect_to_be_true(memory_get_tag_stats(MEMORY_TAG_TRANSFORM, &before));
+
+    void* a = kallocate(1000, MEMORY_TAG_TRANSFORM);
+    void* b = kallocate(3000, MEMORY_TAG_TRANSFORM);
+    kfree(a, 1000, MEMORY_TAG_TRANSFORM);
+
+    memory_stats_snapshot after;
+    expect_to_be_true(memory_get_tag_stats(MEMORY_TAG_TRANSFORM, &after));
+    expect_should_be(before.current + 3000, after.current);
+    expect_should_be(before.current + 4000, after.peak);
+    expect_should_be(before.allocation_count + 2, after.allocation_count);
+    expect_should_be(before.free_count + 1, after.free_count);
+
+    kfree(b, 3000, MEMORY_TAG_TRANSFORM);
+
+    memory_stats_snapshot total;
+    expect_to_be_true(memory_get_total_stats(&total));
+    expect_should_be(0, total.current);
+
+    stop_memory_system();
+
+    return TRUE;
+}
+
+UInt8 memory_usage_report_does_not_allocate() {
+    start_memory_system(KIBIBYTES(64));
+
+    UInt64 count = get_memory_alloc_count();
+    char report[8000];
+    UInt64 written = memory_usage_report(report, sizeof(report));
+    expect_should_not_be(0, written);
+    expect_should_be(count, get_memory_alloc_count());
+
+    // A small buffer is truncated but always terminated.
+    char small[16];
+    written = memory_usage_report(small, sizeof(small));
+    expect_should_be(15, written);
+    expect_should_be(0, small[15]);
+
+    stop_memory_system();
+
+    return TRUE;
+}
+
+UInt8 memory_thread_cache_reuses_and_flushes() {
+    start_memory_system(KIBIBYTES(64));
+
+    // The first small block starts the heap, since its class took the first run.
+    UInt8* first = kallocate(200, MEMORY_TAG_ARRAY);
+    kfree(first, 200, MEMORY_TAG_ARRAY);
+    expect_should_be(first, kallocate(200, MEMORY_TAG_ARRAY));
+    kfree(first, 200, MEMORY_TAG_ARRAY);
+
+    // More frees than a cache keeps send the surplus back to the heap.
+    void* blocks[100];
+    for (UInt32 i = 0; i < 100; ++i) {
+        blocks[i] = kallocate(200, MEMORY_TAG_ARRAY);
+        expect_should_not_be(0, blocks[i]);
+    }
+    for (UInt32 i = 0; i < 100; ++i) {
+        kfree(blocks[i], 200, MEMORY_TAG_ARRAY);
+    }
+
+    // Once flushed, the heap has everything back in one piece.
+    memory_thread_cache_flush();
+    void* everything = kallocate(KIBIBYTES(64), MEMORY_TAG_ARRAY);
+    expect_should_be(first, everything);
+    kfree(everything, KIBIBYTES(64), MEMORY_TAG_ARRAY);
+
+    stop_memory_system();
+    return TRUE;
+}
+
+typedef struct memory_pressure_listener {
+    UInt32 calls;
+    UInt32 tag;
+    UInt64 bytes;
+} memory_pressure_listener;
+
+static Boolean on_memory_pressure(UInt16 code, void* sender, void* listener_inst, event_context context) {
+    memory_pressure_listener* listener = listener_inst;
+    listener->calls++;
+    listener->tag = context.data.u32[0];
+    listener->bytes = context.data.u64[1];
+    return FALSE;
+}
+
+UInt8 memory_soft_budget_posts_pressure_once_per_crossing() {
+    // Started second so its state and listeners come from the heap.
+    start_memory_system(MEBIBYTES(4));
+    test_system events;
+    test_system_start(&events, event_system_initialize);
+
+    memory_pressure_listener listener = {0};
+    event_register(EVENT_CODE_MEMORY_PRESSURE, &listener, on_memory_pressure);
+    expect_to_be_true(memory_set_tag_budget(MEMORY_TAG_TEXTURE, 4000, 0));
+
+    void* a = kallocate(3000, MEMORY_TAG_TEXTURE);
+    void* b = kallocate(2000, MEMORY_TAG_TEXTURE);
+    void* c = kallocate(2000, MEMORY_TAG_TEXTURE);
+    expect_should_not_be(0, c);
+
+    // Posted, not fired, so nothing is heard until the queue is dispatched.
+    expect_should_be(0, listener.calls);
+    event_dispatch_posted();
+    expect_should_be(1, listener.calls);
+    expect_should_be(MEMORY_TAG_TEXTURE, listener.tag);
+    expect_should_be(5000, listener.bytes);
+
+    // Dropping back under the soft limit rearms the event.
+    kfree(c, 2000, MEMORY_TAG_TEXTURE);
+    kfree(b, 2000, MEMORY_TAG_TEXTURE);
+    b = kallocate(2000, MEMORY_TAG_TEXTURE);
+    event_dispatch_posted();
+    expect_should_be(2, listener.calls);
+
+    // Other tags are not budgeted.
+    void* other = kallocate(8000, MEMORY_TAG_SCENE);
+    event_dispatch_posted();
+    expect_should_be(2, listener.calls);
+
+    kfree(other, 8000, MEMORY_TAG_SCENE);
+    kfree(b, 2000, MEMORY_TAG_TEXTURE);
+    kfree(a, 3000, MEMORY_TAG_TEXTURE);
+    event_unregister(EVENT_CODE_MEMORY_PRESSURE, &listener, on_memory_pressure);
+    test_system_stop(&events, event_system_shutdown);
+    stop_memory_system();
+    return TRUE;
+}
+
+static UInt32 budget_exceeded_calls = 0;
+static UInt64 budget_exceeded_current = 0;
+
+static void on_budget_exceeded(memory_tag tag, UInt64 size, UInt64 current, UInt64 hard_limit) {
+    budget_exceeded_calls++;
+    budget_exceeded_current = current;
+}
+
+UInt8 memory_hard_budget_refuses_allocations() {
+    start_memory_system(KIBIBYTES(64));
+    budget_exceeded_calls = 0;
+
+    KDEBUG("Note: The following error is intentionally caused by this test.");
+    expect_to_be_false(memory_set_tag_budget(MEMORY_TAG_SCENE, 8000, 4000));
+
+    memory_set_budget_exceeded_handler(on_budget_exceeded);
+    expect_to_be_true(memory_set_tag_budget(MEMORY_TAG_SCENE, 0, 4000));
+
+    void* a = kallocate(3000, MEMORY_TAG_SCENE);
+    expect_should_not_be(0, a);
+    expect_should_be(0, kallocate(2000, MEMORY_TAG_SCENE));
+    expect_should_be(1, budget_exceeded_calls);
+    expect_should_be(3000, budget_exceeded_current);
+
+    // The refused allocation was never counted, so the rest of the budget is still there.
+    memory_stats_snapshot stats;
+    memory_get_tag_stats(MEMORY_TAG_SCENE, &stats);
+    expect_should_be(3000, stats.current);
+    void* b = kallocate(1000, MEMORY_TAG_SCENE);
+    expect_should_not_be(0, b);
+    expect_should_be(1, budget_exceeded_calls);
+
+    kfree(b, 1000, MEMORY_TAG_SCENE);
+    kfree(a, 3000, MEMORY_TAG_SCENE);
+    stop_memory_system();
+    return TRUE;
+}
+
+typedef struct allocation_worker {
+    UInt32 rounds;
+    kthread thread;
+} allocation_worker;
+
+// Allocates and frees a spread of small sizes, the way containers and strings do.
+static UInt32 allocation_worker_run(void* params) {
+    allocation_worker* worker = params;
+    void* blocks[16];
+    for (UInt32 round = 0; round < worker->rounds; ++round) {
+        for (UInt32 i = 0; i < 16; ++i) {
+            blocks[i] = kallocate(16 + ((round + i * 61) % 1000), MEMORY_TAG_ARRAY);
+        }
+        for (UInt32 i = 0; i < 16; ++i) {
+            kfree(blocks[i], 16 + ((round + i * 61) % 1000), MEMORY_TAG_ARRAY);
+        }
+    }
+    memory_thread_cache_flush();
+    return 0;
+}
+
+UInt8 memory_stats_add_up_across_threads() {
+    start_memory_system(MEBIBYTES(4));
+
+    memory_stats_snapshot before;
+    expect_to_be_true(memory_get_tag_stats(MEMORY_TAG_ARRAY, &before));
+
+    allocation_worker worker = {.rounds = 100};
+    expect_to_be_true(platform_thread_create(allocation_worker_run, &worker, &worker.thread));
+    platform_thread_destroy(&worker.thread);
+
+    // The worker's counts live in its own cache and are only added up now.
+    memory_stats_snapshot after;
+    expect_to_be_true(memory_get_tag_stats(MEMORY_TAG_ARRAY, &after));
+    expect_should_be(before.current, after.current);
+    expect_should_be(before.allocation_count + 1600, after.allocation_count);
+    expect_should_be(before.free_count + 1600, after.free_count);
+    expect_to_be_true((after.peak >= before.current + 16));
+
+    stop_memory_system();
+    return TRUE;
+}
+
+UInt8 memory_heap_retry_keeps_thread_cache() {
+    start_memory_system(KIBIBYTES(64));
+
+    // The cached run of small blocks leaves no room for the whole heap until it is drained.
+    void* small = kallocate(200, MEMORY_TAG_ARRAY);
+    kfree(small, 200, MEMORY_TAG_ARRAY);
+    expect_should_be(1, memory_thread_cache_count());
+
+    void* everything = kallocate(KIBIBYTES(64), MEMORY_TAG_ARRAY);
+    expect_should_be(small, everything);
+    expect_should_be(1, memory_thread_cache_count());
+    kfree(everything, KIBIBYTES(64), MEMORY_TAG_ARRAY);
+
+    memory_stats_snapshot stats;
+    expect_to_be_true(memory_get_tag_stats(MEMORY_TAG_ARRAY, &stats));
+    expect_should_be(0, stats.current);
+
+    stop_memory_system();
+    return TRUE;
+}
+
+static UInt32 cache_holder_run(void* params) {
+    void* block = kallocate(200, MEMORY_TAG_ARRAY);
+    *(UInt32*)params = memory_thread_cache_count();
+    kfree(block, 200, MEMORY_TAG_ARRAY);
+    memory_thread_cache_flush();
+    return 0;
+}
+
+UInt8 memory_thread_caches_are_recycled() {
+    start_memory_system(MEBIBYTES(4));
+    void* own = kallocate(200, MEMORY_TAG_ARRAY);
+    expect_should_be(1, memory_thread_cache_count());
+
+    // More threads than there are caches, one after another, each still gets one.
+    for (UInt32 i = 0; i < 40; ++i) {
+        UInt32 held = 0;
+        kthread thread;
+        expect_to_be_true(platform_thread_create(cache_holder_run, &held, &thread));
+        platform_thread_destroy(&thread);
+        expect_should_be(2, held);
+        expect_should_be(1, memory_thread_cache_count());
+    }
+
+    kfree(own, 200, MEMORY_TAG_ARRAY);
+    memory_thread_cache_flush();
+    expect_should_be(0, memory_thread_cache_count());
+
+    stop_memory_system();
+    return TRUE;
+}
+
+#define HANDOFF_ROUNDS 20000
+
+// Blocks go from one thread to the other, so every allocation is counted in one thread's
+// cache and its free in another's.
+typedef struct handoff_pair {
+    _Atomic(void*) slot;
+    _Atomic Boolean done;
+    kthread producer;
+    kthread consumer;
+} handoff_pair;
+
+// Spins briefly before yielding, so the handoff stays quick on a single core too.
+static void handoff_wait(UInt32* spins) {
+    if (++*spins % 256 == 0) {
+        platform_sleep(0);
+    }
+}
+
+static UInt32 handoff_producer_run(void* params) {
+    handoff_pair* pair = params;
+    for (UInt32 i = 0; i < HANDOFF_ROUNDS; ++i) {
+        void* block = kallocate(64, MEMORY_TAG_DICT);
+        UInt32 spins = 0;
+        while (atomic_load(&pair->slot)) {
+            handoff_wait(&spins);
+        }
+        atomic_store(&pair->slot, block);
+    }
+    memory_thread_cache_flush();
+    atomic_store(&pair->done, TRUE);
+    return 0;
+}
+
+static UInt32 handoff_consumer_run(void* params) {
+    handoff_pair* pair = params;
+    for (UInt32 i = 0; i < HANDOFF_ROUNDS; ++i) {
+        void* block;
+        UInt32 spins = 0;
+        while (!(block = atomic_exchange(&pair->slot, 0))) {
+            handoff_wait(&spins);
+        }
+        kfree(block, 64, MEMORY_TAG_DICT);
+    }
+    memory_thread_cache_flush();
+    return 0;
+}
+
+UInt8 memory_peak_survives_frees_seen_before_allocations() {
+    start_memory_system(MEBIBYTES(4));
+
+    handoff_pair pair = {0};
+    expect_to_be_true(platform_thread_create(handoff_producer_run, &pair, &pair.producer));
+    expect_to_be_true(platform_thread_create(handoff_consumer_run, &pair, &pair.consumer));
+
+    // Sampling while the blocks change hands is what can catch a free before its allocation.
+    // A sample can be torn either way, but never by more than was ever allocated.
+    UInt64 bound = (UInt64)HANDOFF_ROUNDS * 64;
+    Boolean bounded = TRUE;
+    memory_stats_snapshot stats;
+    while (!atomic_load(&pair.done)) {
+        memory_get_tag_stats(MEMORY_TAG_DICT, &stats);
+        bounded = bounded && stats.current <= bound;
+    }
+    platform_thread_destroy(&pair.producer);
+    platform_thread_destroy(&pair.consumer);
+    expect_to_be_true(bounded);
+
+    expect_to_be_true(memory_get_tag_stats(MEMORY_TAG_DICT, &stats));
+    expect_should_be(0, stats.current);
+    expect_to_be_true((stats.peak >= 64 && stats.peak <= bound));
+
+    stop_memory_system();
+    return TRUE;
+}
+
+static Double run_allocation_workers(UInt32 thread_count, UInt32 rounds) {
+    allocation_worker workers[8];
+    clock timer;
+    clock_start(&timer);
+    for (UInt32 i = 0; i < thread_count; ++i) {
+        workers[i].rounds = rounds;
+        platform_thread_create(allocation_worker_run, &workers[i], &workers[i].thread);
+    }
+    for (UInt32 i = 0; i < thread_count; ++i) {
+        platform_thread_destroy(&workers[i].thread);
+    }
+    clock_update(&timer);
+    return timer.elapsed;
+}
+
+UInt8 memory_benchmark_thread_scaling() {
+    const UInt32 rounds = 20000;
+    UInt32 thread_counts[] = {1, 2, 4, 8};
+    for (UInt32 mode = 0; mode < 2; ++mode) {
+        Boolean cached = mode == 0;
+        for (UInt32 t = 0; t < 4; ++t) {
+            start_memory_system(MEBIBYTES(16));
+            memory_set_thread_caches_enabled(cached);
+
+            UInt32 threads = thread_counts[t];
+            Double seconds = run_allocation_workers(threads, rounds);
+
+            memory_stats_snapshot total;
+            expect_to_be_true(memory_get_total_stats(&total));
+            expect_should_be(0, total.current);
+            expect_should_be((UInt64)threads * rounds * 16, total.allocation_count);
+            stop_memory_system();
+
+            KINFO("kallocate/kfree with %s, %u thread(s): %.2f M pairs/sec.", cached ? "thread caches" : "the shared heap only",
+                  threads, threads * rounds * 16 / seconds / 1000000.0);
+        }
+    }
+    KINFO("(%i processor(s) available.)", platform_get_processor_count());
+    return TRUE;
+}
+
+void kmemory_register_tests() {
+    test_manager_register_test(kallocate_aligned_without_memory_system, "kallocate_aligned works before the memory system starts");
+    test_manager_register_test(kallocate_aligned_from_memory_system, "kallocate_aligned returns aligned heap blocks");
+    test_manager_register_test(memory_stats_track_current_peak_and_counts, "Memory stats track current, peak and counts per tag");
+    test_manager_register_test(memory_usage_report_does_not_allocate, "Memory usage report fits the caller's buffer without allocating");
+    test_manager_register_test(memory_thread_cache_reuses_and_flushes, "Thread caches reuse blocks and flush back to the heap");
+    test_manager_register_test(memory_stats_add_up_across_threads, "Memory stats add up every thread's counts");
+    test_manager_register_test(memory_heap_retry_keeps_thread_cache, "Retrying the heap after draining the cache keeps the thread's cache");
+    test_manager_register_test(memory_thread_caches_are_recycled, "Thread caches are recycled once their threads flush");
+    test_manager_register_test(memory_peak_survives_frees_seen_before_allocations, "Memory peak stays bounded when a free is counted before its allocation");
+    test_manager_register_test(memory_soft_budget_posts_pressure_once_per_crossing, "A soft memory budget posts pressure once per crossing");
+    test_manager_register_test(memory_hard_budget_refuses_allocations, "A hard memory budget refuses allocations past it");
+    test_manager_register_test(memory_benchmark_thread_scaling, "kallocate throughput by thread count, with and without thread caches");
+}
\ No newline at end of file
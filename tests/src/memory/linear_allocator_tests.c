@@ -5,6 +5,7 @@
 #include <defines.h>
 
 #include <memory/linear_allocator.h>
+#include <core/kmemory.h>
 
 UInt8 linear_allocator_should_create_and_destroy() {
     linear_allocator alloc;
@@ -97,10 +98,59 @@ UInt8 linear_allocator_multi_allocation_all_space_then_free() {
     return TRUE;
 }
 
+UInt8 linear_allocator_aligned_allocation() {
+    linear_allocator alloc;
+    linear_allocator_create(256, 0, &alloc);
+
+    void* unaligned = linear_allocator_allocate(&alloc, 3);
+    expect_should_not_be(0, unaligned);
+
+    void* block = linear_allocator_allocate_aligned(&alloc, sizeof(UInt64), 64);
+    expect_should_not_be(0, block);
+    expect_should_be(0, ((UInt64)block % 64));
+    expect_should_be((UInt64)block - (UInt64)alloc.memory + sizeof(UInt64), alloc.allocated);
+
+    linear_allocator_destroy(&alloc);
+
+    return TRUE;
+}
+
+UInt8 linear_allocator_reserved_commits_on_demand() {
+    linear_allocator alloc;
+    expect_to_be_true(linear_allocator_create_reserved(GIBIBYTES(4), &alloc));
+    expect_to_be_true(alloc.is_reserved);
+    expect_should_be(0, alloc.committed);
+
+    UInt8* small = linear_allocator_allocate(&alloc, 100);
+    expect_should_not_be(0, small);
+    expect_to_be_true((alloc.committed >= LINEAR_ALLOCATOR_COMMIT_SIZE && alloc.committed < MEBIBYTES(1)));
+    expect_should_be(0, small[99]);
+
+    // Growing never moves what was already handed out.
+    UInt8* large = linear_allocator_allocate(&alloc, MEBIBYTES(8));
+    expect_should_be(small + 100, large);
+    expect_to_be_true((alloc.committed >= MEBIBYTES(8) + 100));
+    kset_memory(large, 0xAB, MEBIBYTES(8));
+
+    // Free all hands back everything past the first piece, which reads as zero again after.
+    linear_allocator_free_all(&alloc);
+    expect_should_be(0, alloc.allocated);
+    expect_to_be_true((alloc.committed < MEBIBYTES(1)));
+    large = linear_allocator_allocate(&alloc, MEBIBYTES(8));
+    expect_should_be(0, large[MEBIBYTES(8) - 1]);
+    expect_should_be(0, large[0]);
+
+    linear_allocator_destroy(&alloc);
+    expect_should_be(0, alloc.memory);
+    return TRUE;
+}
+
 void linear_allocator_register_tests() {
     test_manager_register_test(linear_allocator_should_create_and_destroy, "Linear allocator should create and destroy");
     test_manager_register_test(linear_allocator_single_allocation_all_space, "Linear allocator single alloc for all space");
     test_manager_register_test(linear_allocator_multi_allocation_all_space, "Linear allocator multi alloc for all space");
     test_manager_register_test(linear_allocator_multi_allocation_over_allocate, "Linear allocator try over allocate");
     test_manager_register_test(linear_allocator_multi_allocation_all_space_then_free, "Linear allocator allocated should be 0 after free_all");
+    test_manager_register_test(linear_allocator_aligned_allocation, "Linear allocator aligned allocation");
+    test_manager_register_test(linear_allocator_reserved_commits_on_demand, "Linear allocator over reserved memory commits on demand");
 }
\ No newline at end of file
@@ -0,0 +1,193 @@
+#include "pool_allocator_tests.h"
+#include "../test_manager.h"
+#include "../expect.h"
+#include "../test_systems.h"
+
+#include <defines.h>
+
+#include <core/clock.h>
+#include <core/kmemory.h>
+#include <memory/pool_allocator.h>
+
+typedef struct pool_test_object {
+    Single position[3];
+    Single rotation[4];
+    UInt32 id;
+} pool_test_object;
+
+UInt8 pool_allocator_should_create_and_destroy() {
+    pool_allocator alloc;
+    expect_to_be_true(pool_allocator_create(sizeof(pool_test_object), 16, 8, FALSE, MEMORY_TAG_ENTITY, 0, &alloc));
+
+    expect_should_not_be(0, alloc.memory);
+    expect_should_be(8, alloc.block_count);
+    expect_should_be(0, alloc.allocated_count);
+    expect_should_be(32, alloc.stride);
+
+    pool_allocator_destroy(&alloc);
+
+    expect_should_be(0, alloc.memory);
+    expect_should_be(0, alloc.block_count);
+
+    return TRUE;
+}
+
+UInt8 pool_allocator_rejects_bad_alignment() {
+    pool_allocator alloc;
+    KDEBUG("Note: The following error is intentionally caused by this test.");
+    expect_to_be_false(pool_allocator_create(16, 24, 8, FALSE, MEMORY_TAG_ENTITY, 0, &alloc));
+
+    return TRUE;
+}
+
+UInt8 pool_allocator_allocations_are_aligned_and_distinct() {
+    UInt64 count = 16;
+    pool_allocator alloc;
+    pool_allocator_create(sizeof(pool_test_object), 64, count, FALSE, MEMORY_TAG_ENTITY, 0, &alloc);
+
+    pool_test_object* objects[16];
+    for (UInt64 i = 0; i < count; ++i) {
+        objects[i] = pool_allocator_allocate(&alloc);
+        expect_should_not_be(0, objects[i]);
+        expect_should_be(0, ((UInt64)objects[i] % 64));
+        objects[i]->id = i;
+    }
+
+    for (UInt64 i = 0; i < count; ++i) {
+        expect_should_be(i, objects[i]->id);
+    }
+
+    KDEBUG("Note: The following error is intentionally caused by this test.");
+    expect_should_be(0, pool_allocator_allocate(&alloc));
+
+    pool_allocator_destroy(&alloc);
+
+    return TRUE;
+}
+
+UInt8 pool_allocator_free_then_reuse() {
+    pool_allocator alloc;
+    pool_allocator_create(sizeof(pool_test_object), 16, 4, FALSE, MEMORY_TAG_ENTITY, 0, &alloc);
+
+    void* a = pool_allocator_allocate(&alloc);
+    void* b = pool_allocator_allocate(&alloc);
+    expect_should_be(2, alloc.allocated_count);
+
+    expect_to_be_true(pool_allocator_free(&alloc, a));
+    expect_should_be(1, alloc.allocated_count);
+
+    // Most recently freed block comes back first.
+    expect_should_be(a, pool_allocator_allocate(&alloc));
+
+    KDEBUG("Note: The following error is intentionally caused by this test.");
+    expect_to_be_false(pool_allocator_free(&alloc, (UInt8*)b + 1));
+
+    pool_allocator_free_all(&alloc);
+    expect_should_be(0, alloc.allocated_count);
+    for (UInt32 i = 0; i < 4; ++i) {
+        expect_should_not_be(0, pool_allocator_allocate(&alloc));
+    }
+
+    pool_allocator_destroy(&alloc);
+
+    return TRUE;
+}
+
+UInt8 pool_allocator_grows_by_chunks() {
+    pool_allocator alloc;
+    pool_allocator_create(sizeof(pool_test_object), 16, 4, TRUE, MEMORY_TAG_ENTITY, 0, &alloc);
+
+    void* blocks[10];
+    for (UInt32 i = 0; i < 10; ++i) {
+        blocks[i] = pool_allocator_allocate(&alloc);
+        expect_should_not_be(0, blocks[i]);
+    }
+    expect_should_be(12, alloc.block_count);
+    expect_should_be(10, alloc.allocated_count);
+
+    for (UInt32 i = 0; i < 10; ++i) {
+        expect_to_be_true(pool_allocator_free(&alloc, blocks[i]));
+    }
+    expect_should_be(0, alloc.allocated_count);
+
+    pool_allocator_destroy(&alloc);
+
+    return TRUE;
+}
+
+UInt8 pool_allocator_uses_provided_memory() {
+    UInt64 requirement = pool_allocator_memory_requirement(sizeof(pool_test_object), 16, 4);
+    UInt8 memory[256];
+    expect_to_be_true((requirement <= sizeof(memory)));
+
+    pool_allocator alloc;
+    pool_allocator_create(sizeof(pool_test_object), 16, 4, FALSE, MEMORY_TAG_ENTITY, memory, &alloc);
+
+    UInt8* block = pool_allocator_allocate(&alloc);
+    expect_to_be_true((block >= memory && block < memory + sizeof(memory)));
+    expect_to_be_false(alloc.owns_memory);
+
+    pool_allocator_destroy(&alloc);
+
+    return TRUE;
+}
+
+UInt8 pool_allocator_benchmark_against_kallocate() {
+    const UInt32 object_count = 4096;
+    const UInt32 rounds = 64;
+    void* objects[4096];
+
+    pool_allocator alloc;
+    pool_allocator_create(sizeof(pool_test_object), 16, object_count, FALSE, MEMORY_TAG_ENTITY, 0, &alloc);
+
+    clock timer;
+    clock_start(&timer);
+    for (UInt32 r = 0; r < rounds; ++r) {
+        for (UInt32 i = 0; i < object_count; ++i) {
+            objects[i] = pool_allocator_allocate(&alloc);
+        }
+        for (UInt32 i = 0; i < object_count; ++i) {
+            pool_allocator_free(&alloc, objects[i]);
+        }
+    }
+    clock_update(&timer);
+    Double pool_seconds = timer.elapsed;
+    expect_should_be(0, alloc.allocated_count);
+    pool_allocator_destroy(&alloc);
+
+    // Measure kallocate as the engine uses it, served from the memory system's heap.
+    test_system memory;
+    test_system_start(&memory, memory_system_initialize, MEBIBYTES(4));
+
+    clock_start(&timer);
+    for (UInt32 r = 0; r < rounds; ++r) {
+        for (UInt32 i = 0; i < object_count; ++i) {
+            objects[i] = kallocate(sizeof(pool_test_object), MEMORY_TAG_ENTITY);
+        }
+        for (UInt32 i = 0; i < object_count; ++i) {
+            kfree(objects[i], sizeof(pool_test_object), MEMORY_TAG_ENTITY);
+        }
+    }
+    clock_update(&timer);
+    Double kallocate_seconds = timer.elapsed;
+
+    test_system_stop(&memory, memory_system_shutdown);
+
+    Double operations = (Double)object_count * rounds;
+    KINFO("Pool allocator: %.2f M alloc+free/sec, kallocate: %.2f M alloc+free/sec (%.1fx).",
+          operations / pool_seconds / 1000000.0,
+          operations / kallocate_seconds / 1000000.0,
+          kallocate_seconds / pool_seconds);
+
+    return TRUE;
+}
+
+void pool_allocator_register_tests() {
+    test_manager_register_test(pool_allocator_should_create_and_destroy, "Pool allocator should create and destroy");
+    test_manager_register_test(pool_allocator_rejects_bad_alignment, "Pool allocator rejects non power of two alignment");
+    test_manager_register_test(pool_allocator_allocations_are_aligned_and_distinct, "Pool allocator blocks are aligned and distinct");
+    test_manager_register_test(pool_allocator_free_then_reuse, "Pool allocator reuses freed blocks");
+    test_manager_register_test(pool_allocator_grows_by_chunks, "Pool allocator grows by chunks");
+    test_manager_register_test(pool_allocator_uses_provided_memory, "Pool allocator uses provided memory");
+    test_manager_register_test(pool_allocator_benchmark_against_kallocate, "Pool allocator throughput against kallocate");
+}
\ No newline at end of file
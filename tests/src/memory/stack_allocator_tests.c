@@ -0,0 +1,92 @@
+#include "stack_allocator_tests.h"
+#include "../test_manager.h"
+#include "../expect.h"
+
+#include <defines.h>
+
+#include <memory/stack_allocator.h>
+
+UInt8 stack_allocator_nested_markers() {
+    stack_allocator alloc;
+    expect_to_be_true(stack_allocator_create(1024, 0, &alloc));
+
+    // A file buffer, then a parse tree, then a scratch string, released innermost first.
+    stack_allocator_marker file_marker = stack_allocator_get_marker(&alloc);
+    void* file = stack_allocator_allocate(&alloc, 100);
+    stack_allocator_marker tree_marker = stack_allocator_get_marker(&alloc);
+    void* tree = stack_allocator_allocate(&alloc, 200);
+    stack_allocator_marker string_marker = stack_allocator_get_marker(&alloc);
+    void* string = stack_allocator_allocate(&alloc, 300);
+    expect_should_not_be(0, file);
+    expect_should_not_be(0, tree);
+    expect_should_not_be(0, string);
+    expect_should_be(600, alloc.allocated);
+
+    expect_to_be_true(stack_allocator_free_to_marker(&alloc, string_marker));
+    expect_should_be(300, alloc.allocated);
+
+    // Memory freed back to a marker is handed out again.
+    void* reused = stack_allocator_allocate(&alloc, 50);
+    expect_should_be(string, reused);
+
+    expect_to_be_true(stack_allocator_free_to_marker(&alloc, tree_marker));
+    expect_to_be_true(stack_allocator_free_to_marker(&alloc, file_marker));
+    expect_should_be(0, alloc.allocated);
+    expect_should_be(600, alloc.peak_allocated);
+
+    stack_allocator_destroy(&alloc);
+    expect_should_be(0, alloc.memory);
+    return TRUE;
+}
+
+UInt8 stack_allocator_aligned_and_over_allocate() {
+    stack_allocator alloc;
+    expect_to_be_true(stack_allocator_create(256, 0, &alloc));
+
+    stack_allocator_allocate(&alloc, 3);
+    void* block = stack_allocator_allocate_aligned(&alloc, sizeof(UInt64), 64);
+    expect_should_not_be(0, block);
+    expect_should_be(0, ((UInt64)block % 64));
+    expect_should_be((UInt64)block - (UInt64)alloc.memory + sizeof(UInt64), alloc.allocated);
+
+    UInt64 allocated = alloc.allocated;
+    KDEBUG("Note: The following errors are intentionally caused by this test.");
+    expect_should_be(0, stack_allocator_allocate_aligned(&alloc, 8, 3));
+    expect_should_be(0, stack_allocator_allocate(&alloc, 256));
+    expect_should_be(allocated, alloc.allocated);
+
+    stack_allocator_destroy(&alloc);
+    return TRUE;
+}
+
+UInt8 stack_allocator_rejects_out_of_order_frees() {
+    stack_allocator alloc;
+    expect_to_be_true(stack_allocator_create(256, 0, &alloc));
+
+    stack_allocator_marker outer = stack_allocator_get_marker(&alloc);
+    stack_allocator_allocate(&alloc, 16);
+    stack_allocator_marker inner = stack_allocator_get_marker(&alloc);
+    stack_allocator_allocate(&alloc, 16);
+
+    KDEBUG("Note: The following errors are intentionally caused by this test.");
+#if defined(_DEBUG)
+    // The inner temporaries are still open, so the outer free is refused and nothing moves.
+    expect_to_be_false(stack_allocator_free_to_marker(&alloc, outer));
+    expect_should_be(32, alloc.allocated);
+#endif
+
+    expect_to_be_true(stack_allocator_free_to_marker(&alloc, inner));
+    expect_to_be_true(stack_allocator_free_to_marker(&alloc, outer));
+
+    // A marker above the top was already released by an earlier free.
+    expect_to_be_false(stack_allocator_free_to_marker(&alloc, inner));
+
+    stack_allocator_destroy(&alloc);
+    return TRUE;
+}
+
+void stack_allocator_register_tests() {
+    test_manager_register_test(stack_allocator_nested_markers, "Stack allocator frees nested temporaries back to their markers");
+    test_manager_register_test(stack_allocator_aligned_and_over_allocate, "Stack allocator aligned allocation and over allocate");
+    test_manager_register_test(stack_allocator_rejects_out_of_order_frees, "Stack allocator rejects out-of-order frees");
+}
\ No newline at end of file
@@ -0,0 +1,3 @@
+#pragma once
+
+void stack_allocator_register_tests();
\ No newline at end of file
@@ -0,0 +1,7 @@
+#include "test_systems.h"
+
+void test_system_stop(test_system* system, void (*shutdown)(void* state)) {
+    shutdown(system->state);
+    kfree(system->state, system->requirement, MEMORY_TAG_APPLICATION);
+    system->state = 0;
+}
\ No newline at end of file
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <defines.h>
+#include <core/kmemory.h>
+
+// The state block of one engine system, held for the length of a test.
+typedef struct test_system {
+    UInt64 requirement;
+    void* state;
+} test_system;
+
+// Runs the two-pass initialize every engine system uses: once for the size of its state,
+// then again with a block of that size. Arguments after the state are passed through, and
+// the whole expression has the value of the second call.
+#define test_system_start(system, initialize, ...)                                \
+    (initialize(&(system)->requirement, 0, ##__VA_ARGS__),                        \
+     (system)->state = kallocate((system)->requirement, MEMORY_TAG_APPLICATION),  \
+     initialize(&(system)->requirement, (system)->state, ##__VA_ARGS__))
+
+// Shuts the system down and frees its state.
+void test_system_stop(test_system* system, void (*shutdown)(void* state));
\ No newline at end of file